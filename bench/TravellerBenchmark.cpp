@@ -0,0 +1,137 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <array>
+#include <random>
+#include <functional>
+
+#include "ByteSource.hpp"
+#include "TextDocumentTraveller.hpp"
+
+//INTERNAL AUX FUNCTIONS
+namespace
+{
+
+//Build with CMAKE_BUILD_TYPE=Release, unoptimized builds measure the
+//overhead of the debug build rather than that of each interface
+static constexpr int Repetitions = 5;
+static constexpr size_t TokenBatchSize = 256;
+
+static std::string makeSyntheticDocument(size_t size)
+{
+    static const std::array<const char *, 12> pieces = {
+        "The", "quick", "brown", "fox", "jumps,", "over", "the", "lazy", "dog.", "i.e.", "(really)", "Yes!\n"
+    };
+
+    std::mt19937 generator(42);
+    std::string document;
+
+    while( document.size() < size ){
+        document += pieces[generator() % pieces.size()];
+        document += ' ';
+    }
+
+    return document;
+}
+
+static std::string readDocument(const std::string &filepath)
+{
+    std::ifstream in(filepath, std::ios::binary);
+    std::stringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+//The checksum keeps the compiler from dropping the traversal
+static size_t travelWithPull(const std::string &document)
+{
+    TextDocumentTraveller traveller(ByteSource::makeFromView(document));
+    size_t checksum = 0;
+
+    while( traveller.hasNext() ){
+        checksum += traveller.getNextToken().text().size();
+    }
+
+    return checksum;
+}
+
+static size_t travelWithBatches(const std::string &document)
+{
+    TextDocumentTraveller traveller(ByteSource::makeFromView(document));
+    std::array<Token, TokenBatchSize> tokens;
+    size_t checksum = 0;
+
+    while( size_t count = traveller.next(tokens) ){
+        for( size_t i = 0; i < count; i++ ){
+            checksum += tokens[i].text().size();
+        }
+    }
+
+    return checksum;
+}
+
+static size_t travelWithGenerator(const std::string &document)
+{
+    TextDocumentTraveller traveller(ByteSource::makeFromView(document));
+    size_t checksum = 0;
+
+    for( const Token &token : traveller.elements() ){
+        checksum += token.text().size();
+    }
+
+    return checksum;
+}
+
+static size_t countTokens(const std::string &document)
+{
+    TextDocumentTraveller traveller(ByteSource::makeFromView(document));
+    size_t count = 0;
+
+    for( const Token &token : traveller.elements() ){
+        (void)token;
+        ++count;
+    }
+
+    return count;
+}
+
+static void measure(const std::string &name, const std::function<size_t(const std::string &)> &travel,
+                    const std::string &document, size_t token_count)
+{
+    double best_seconds = 0;
+    size_t checksum = 0;
+
+    for( int repetition = 0; repetition < Repetitions; repetition++ ){
+        auto start = std::chrono::steady_clock::now();
+        checksum = travel(document);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        if( repetition == 0 || elapsed.count() < best_seconds ){
+            best_seconds = elapsed.count();
+        }
+    }
+
+    std::cout << name << ": " << best_seconds * 1e9 / token_count << " ns/token, "
+              << document.size() / best_seconds / (1 << 20) << " MiB/s"
+              << " (checksum " << checksum << ")" << std::endl;
+}
+
+}//ANONYMOUS NAMESPACE
+//END OF INTERNAL AUX FUNCTIONS
+
+
+//Usage: TravellerBenchmark [document], a synthetic 64MiB document is used
+//when none is given
+int main(int argc, char *argv[])
+{
+    std::string document = argc > 1 ? readDocument(argv[1]) : makeSyntheticDocument(64 << 20);
+    size_t token_count = countTokens(document);
+
+    std::cout << document.size() << " bytes, " << token_count << " tokens, best of " << Repetitions << std::endl;
+
+    measure("hasNext/getNextToken", travelWithPull, document, token_count);
+    measure("next(span)          ", travelWithBatches, document, token_count);
+    measure("elements()          ", travelWithGenerator, document, token_count);
+    return 0;
+}
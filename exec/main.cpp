@@ -1,9 +1,18 @@
 #include <iostream>
 #include <span>
 #include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <csignal>
+#include <optional>
 
+#include "ByteSource.hpp"
 #include "Concordance.hpp"
+#include "ConcordanceServer.hpp"
+#include "DocumentPaths.hpp"
 #include "OutputFormattings.hpp"
+#include "WordSanitizer.hpp"
 
 //INTERNAL CLASS DECLARATIONS
 namespace
@@ -68,6 +77,19 @@ public:
     int execute() override;
 };
 
+//==========================================================================|
+//							      QueryClient								|
+//==========================================================================|
+// @brief: Concrete class that asks the queries given as arguments to a     |
+//         concordance served by another run of the application            |
+//==========================================================================|
+class QueryClient : public AppExecutor
+{
+public:
+    QueryClient(const std::vector<CommandLineArg> &execution_args);
+    int execute() override;
+};
+
 //==========================================================================|
 //					            ExecutionFactory			        		|
 //==========================================================================|
@@ -83,9 +105,11 @@ public:
 //END OF INTERNAL CLASS DECLARATIONS
 
 //INTERNAL AUX FUNCTIONS
+static constexpr const char *StandardInputPath = "-";
+
 static inline bool isKey(const std::string &input)
 {
-    return input.starts_with("-");
+    return input.starts_with("-") && input != StandardInputPath;
 }
 
 static inline bool hasFilledKey(const CommandLineArg &arg)
@@ -137,7 +161,28 @@ static void printApplicationHelp()
     std::cout << std::endl;
     std::cout << "Applicable Arguments:" << std::endl;
     std::cout << "-h, --help: Help of application" << std::endl;
-    std::cout << "-f, --file: Plain text document that will generate a concordance" << std::endl;
+    std::cout << "-f, --file: Plain text document that will generate a concordance ('-' reads standard input)" << std::endl;
+    std::cout << "            Several documents, directories and glob patterns ('docs/*.txt') may be given, numbering" << std::endl;
+    std::cout << "            sentences on from one document to the next" << std::endl;
+    std::cout << "--read-ahead: Number of blocks a background thread keeps loaded ahead of parsing (0 disables it)" << std::endl;
+    std::cout << "--block-size: Size in bytes of each read-ahead block" << std::endl;
+    std::cout << "-j, --threads: Number of threads parsing a file, or several files, in parallel (0, the default, uses every core)" << std::endl;
+    std::cout << "--encoding: 'ascii' (default) or 'utf8', which also indexes accented, Greek and Cyrillic words" << std::endl;
+    std::cout << "--engine: 'hash' (default), 'map' or 'trie', how words are stored while the concordance is built" << std::endl;
+    std::cout << "--max-memory: Bytes (or K, M, G) the words being parsed may take. Past it they are spilled as sorted runs" << std::endl;
+    std::cout << "              to --spill-dir (the temporary directory by default), which are merged back while printing" << std::endl;
+    std::cout << "--prefix: Only prints the words starting with the given prefixes" << std::endl;
+    std::cout << "--write-index: Saves the concordance as a binary index to the given file instead of printing it" << std::endl;
+    std::cout << "--read-index: Prints the concordance of a saved index, which is mapped instead of parsing documents" << std::endl;
+    std::cout << "--top: Prints only the given number of most frequent words, with their counts" << std::endl;
+    std::cout << "--approximate: With --top, estimates them while streaming the documents instead of building the concordance," << std::endl;
+    std::cout << "               keeping --counters words (65536 by default) whatever the vocabulary. Estimates may be too" << std::endl;
+    std::cout << "               high by the error printed next to them" << std::endl;
+    std::cout << "--serve: Keeps the concordance loaded and answers queries on the given Unix socket until interrupted," << std::endl;
+    std::cout << "         on -j threads (up to 4 by default). Prefix queries are fastest on an index or the map and trie engines" << std::endl;
+    std::cout << "--connect: Asks the concordance served on the given socket the queries of --lookup, --prefix and --exists" << std::endl;
+    std::cout << "--update-index: Brings the given index up to date with a single growing document, parsing only the" << std::endl;
+    std::cout << "                bytes appended since the index was written" << std::endl;
 
 }
 
@@ -168,13 +213,260 @@ static bool existHelpFlag(const std::vector<CommandLineArg> &all_args)
     return std::any_of(all_args.begin(), all_args.end(), is_help);
 }
 
-static void printConcordance(const Concordance &concordance)
+static std::optional<std::string> findTextValue(const std::vector<CommandLineArg> &all_args, const std::string &key)
+{
+    auto has_key = [&key](const CommandLineArg &arg){
+        return arg.key == key;
+    };
+
+    auto found = std::find_if(all_args.begin(), all_args.end(), has_key);
+    if( found == all_args.end() || found->values.empty() ){
+        return std::nullopt;
+    }
+
+    return found->values.front();
+}
+
+static std::optional<size_t> findSizeValue(const std::vector<CommandLineArg> &all_args, const std::string &key)
+{
+    std::optional<std::string> found = findTextValue(all_args, key);
+    if( !found ){
+        return std::nullopt;
+    }
+
+    const std::string &text = *found;
+    size_t value = 0;
+    auto [parsed_end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+    if( error != std::errc() || parsed_end != text.data() + text.size() ){
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+//A size in bytes, or in KiB, MiB or GiB with a K, M or G suffix
+static std::optional<size_t> findMemoryValue(const std::vector<CommandLineArg> &all_args, const std::string &key)
+{
+    std::optional<std::string> found = findTextValue(all_args, key);
+    if( !found ){
+        return std::nullopt;
+    }
+
+    std::string text = *found;
+    size_t shift = 0;
+
+    switch( text.empty() ? '\0' : std::toupper(static_cast<unsigned char>(text.back())) ){
+    case 'K':
+        shift = 10;
+        break;
+    case 'M':
+        shift = 20;
+        break;
+    case 'G':
+        shift = 30;
+        break;
+    }
+
+    if( shift ){
+        text.pop_back();
+    }
+
+    size_t value = 0;
+    auto [parsed_end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+    if( error != std::errc() || parsed_end != text.data() + text.size() || value > (SIZE_MAX >> shift) ){
+        return std::nullopt;
+    }
+
+    return value << shift;
+}
+
+static std::optional<ReadAheadOptions> findReadAheadOptions(const std::vector<CommandLineArg> &all_args)
+{
+    std::optional<size_t> queue_depth = findSizeValue(all_args, "--read-ahead");
+    if( !queue_depth || *queue_depth == 0 ){
+        return std::nullopt;
+    }
+
+    ReadAheadOptions options;
+    options.queue_depth = *queue_depth;
+    options.block_size = findSizeValue(all_args, "--block-size").value_or(options.block_size);
+    return options;
+}
+
+static bool requestsUtf8(const std::vector<CommandLineArg> &all_args)
+{
+    auto is_utf8 = [](const CommandLineArg &arg){
+        return arg.key == "--encoding" && arg.values.size() && (arg.values.front() == "utf8" || arg.values.front() == "utf-8");
+    };
+
+    return std::any_of(all_args.begin(), all_args.end(), is_utf8);
+}
+
+static ConcordanceEngine findEngine(const std::vector<CommandLineArg> &all_args)
+{
+    auto is_engine = [](const CommandLineArg &arg){
+        return arg.key == "--engine" && arg.values.size();
+    };
+
+    auto found = std::find_if(all_args.begin(), all_args.end(), is_engine);
+    if( found == all_args.end() ){
+        return ConcordanceEngine::Hash;
+    } else if( found->values.front() == "map" ){
+        return ConcordanceEngine::OrderedMap;
+    } else if( found->values.front() == "trie" ){
+        return ConcordanceEngine::RadixTrie;
+    }
+
+    return ConcordanceEngine::Hash;
+}
+
+static std::vector<std::string> findAllValues(const std::vector<CommandLineArg> &all_args, const std::string &key)
+{
+    std::vector<CommandLineArg> key_args;
+
+    std::copy_if(all_args.begin(), all_args.end(), std::back_inserter(key_args), [&key](const CommandLineArg &arg){
+        return arg.key == key;
+    });
+
+    return joinValues(key_args);
+}
+
+static std::vector<std::string> findPrefixes(const std::vector<CommandLineArg> &all_args)
+{
+    return findAllValues(all_args, "--prefix");
+}
+
+static std::vector<Query> findQueries(const std::vector<CommandLineArg> &all_args)
+{
+    std::vector<Query> queries;
+
+    for( auto [key, kind] : {std::pair("--lookup", QueryKind::Lookup), std::pair("--prefix", QueryKind::Prefix), std::pair("--exists", QueryKind::Exists)} ){
+        for( const std::string &word : findAllValues(all_args, key) ){
+            queries.push_back(Query{kind, word});
+        }
+    }
+
+    return queries;
+}
+
+static ParseOptions findParseOptions(const std::vector<CommandLineArg> &all_args)
+{
+    ParseOptions options;
+    std::optional<size_t> threads = findSizeValue(all_args, "-j");
+    options.shard_count = threads ? *threads : findSizeValue(all_args, "--threads").value_or(options.shard_count);
+    options.encoding = requestsUtf8(all_args) ? TextEncoding::Utf8 : TextEncoding::Ascii;
+    options.engine = findEngine(all_args);
+    options.max_memory = findMemoryValue(all_args, "--max-memory").value_or(options.max_memory);
+    options.spill_directory = findTextValue(all_args, "--spill-dir").value_or(options.spill_directory);
+    return options;
+}
+
+static std::unique_ptr<ByteSource> openDocument(const std::string &filepath)
+{
+    if( filepath == StandardInputPath ){
+        return ByteSource::makeFromStdin();
+    } else {
+        return ByteSource::makeFromFile(filepath);
+    }
+}
+
+static Concordance makeConcordance(const std::string &filepath, const std::optional<ReadAheadOptions> &read_ahead,
+                                   const ParseOptions &parse_options)
+{
+    std::unique_ptr<ByteSource> source = openDocument(filepath);
+
+    if( read_ahead ){
+        source = ByteSource::makeReadAhead(std::move(source), *read_ahead);
+    }
+
+    return Concordance::makeFromSource(std::move(source), parse_options);
+}
+
+//With prefixes only the words starting with one of them are printed, each
+//prefix indexing its words from the start. Prefixes are lowercased like
+//the words they are matched against
+static void printConcordance(const Concordance &concordance, const std::vector<std::string> &prefixes, TextEncoding encoding)
 {
     auto print_to_console = [](WordIndex index, const Word &word, const Occurrences &occurrences){
         std::cout <<  joinConcordanceLine(index, word, occurrences) << std::endl;
     };
 
-    concordance.forEachWord(print_to_console);
+    if( prefixes.empty() ){
+        concordance.forEachWord(print_to_console);
+    }
+
+    for( const std::string &prefix : prefixes ){
+        concordance.forEachWithPrefix(WordSanitizer::sanitize(prefix, encoding), print_to_console);
+    }
+}
+
+//Interrupting signals are blocked before the server threads start, so they
+//inherit the mask and the calling thread is the one waiting for them
+static int serveConcordance(const Concordance &concordance, const std::string &socket_path, const ParseOptions &parse_options)
+{
+    sigset_t stop_signals;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, nullptr);
+
+    ConcordanceServer server(concordance, parse_options.encoding, parse_options.shard_count);
+
+    if( !server.listen(socket_path) ){
+        std::cerr << "Could not listen on socket: " << socket_path << std::endl;
+        return -1;
+    }
+
+    std::cerr << "Serving " << concordance.size() << " words on " << socket_path << std::endl;
+
+    int signal = 0;
+    sigwait(&stop_signals, &signal);
+    server.stop();
+    return 0;
+}
+
+static void printTopWords(const std::vector<WordCount> &top_words)
+{
+    WordIndex index = 1;
+
+    for( const WordCount &word_count : top_words ){
+        std::cout << makePrintable(index++) << " " << makePrintable(word_count.word) << " " << word_count.count;
+
+        if( word_count.error ){
+            std::cout << " (at most " << word_count.error << " too high)";
+        }
+        std::cout << std::endl;
+    }
+}
+
+//Every document is summarized in turn, sentences play no part in counts
+static int printEstimatedTopWords(const std::vector<std::string> &filepaths, size_t k, const std::vector<CommandLineArg> &all_args,
+                                  const ParseOptions &parse_options)
+{
+    size_t capacity = std::max(findSizeValue(all_args, "--counters").value_or(HeavyHitters::DefaultCapacity), k);
+    HeavyHitters heavy_hitters(capacity);
+
+    for( const std::string &filepath : filepaths ){
+        heavy_hitters.merge(Concordance::countFrequentWords(openDocument(filepath), capacity, parse_options));
+    }
+
+    printTopWords(heavy_hitters.top(k));
+    return 0;
+}
+
+static void printQueryResult(const Query &query, const QueryResult &result)
+{
+    if( query.kind == QueryKind::Exists ){
+        std::cout << query.word << (result.empty() ? " not found" : " found") << std::endl;
+        return;
+    }
+
+    WordIndex index = 1;
+    for( const auto &[word, occurrences] : result ){
+        std::cout << joinConcordanceLine(index++, word, occurrences) << std::endl;
+    }
 }
 //END OF INTERNAL AUX FUNCTIONS
 
@@ -213,21 +505,124 @@ int ConcordanceGenerator::execute()
     auto removed = std::remove_if(args.begin(), args.end(), does_not_refer_to_file);
     args.erase(removed, args.end());
     
-    std::vector<std::string> filepaths = joinValues(args);
+    std::vector<std::string> filepaths = DocumentPaths::expand(joinValues(args));
+    ParseOptions parse_options = findParseOptions(getArgs());
+
+    std::optional<std::string> update_index = findTextValue(getArgs(), "--update-index");
+
+    if( update_index && filepaths.size() == 1 && filepaths.front() != StandardInputPath ){
+        if( !Concordance::updateIndex(filepaths.front(), *update_index, parse_options) ){
+            std::cerr << "Could not update the concordance index: " << *update_index << std::endl;
+            return -1;
+        }
 
-    if( filepaths.size() == 1 ){
-        Concordance concordance = Concordance::makeFromFile(filepaths.front());
-        printConcordance(concordance);
         return 0;
-    
+
+    } else if( update_index ){
+        HelpExecutor executor(args);
+        executor.execute();
+        return -1;
+    }
+
+    std::optional<size_t> top_count = findSizeValue(getArgs(), "--top");
+    bool approximates = std::any_of(getArgs().begin(), getArgs().end(), [](const CommandLineArg &arg){
+        return arg.key == "--approximate";
+    });
+
+    if( top_count && approximates && filepaths.size() ){
+        return printEstimatedTopWords(filepaths, *top_count, getArgs(), parse_options);
+    }
+
+    std::optional<std::string> read_index = findTextValue(getArgs(), "--read-index");
+    std::optional<Concordance> concordance;
+
+    if( read_index ){
+        concordance = Concordance::open(*read_index, parse_options.engine);
+
+        if( !concordance ){
+            std::cerr << "Not a valid concordance index: " << *read_index << std::endl;
+            return -1;
+        }
+
+    } else if( filepaths.size() == 1 ){
+        concordance = makeConcordance(filepaths.front(), findReadAheadOptions(getArgs()), parse_options);
+
+    } else if( filepaths.size() > 1 && std::find(filepaths.begin(), filepaths.end(), StandardInputPath) == filepaths.end() ){
+        auto is_read_ahead = [](const CommandLineArg &arg){
+            return arg.key == "--read-ahead" || arg.key == "--block-size";
+        };
+
+        //Several files are mapped and parsed in parallel, there is no stream to read ahead
+        if( std::any_of(getArgs().begin(), getArgs().end(), is_read_ahead) ){
+            std::cerr << "--read-ahead and --block-size only apply to a single stream input, ignoring them" << std::endl;
+        }
+
+        concordance = Concordance::makeFromFiles(filepaths, parse_options);
+
     } else {
         HelpExecutor executor(args);
         executor.execute();
         return -1;
     }
+
+    std::optional<std::string> serve_socket = findTextValue(getArgs(), "--serve");
+
+    if( serve_socket ){
+        return serveConcordance(*concordance, *serve_socket, parse_options);
+    }
+
+    std::optional<std::string> write_index = findTextValue(getArgs(), "--write-index");
+
+    if( write_index ){
+        if( !concordance->save(*write_index) ){
+            std::cerr << "Could not write the concordance index: " << *write_index << std::endl;
+            return -1;
+        }
+
+        return 0;
+    }
+
+    if( top_count ){
+        printTopWords(concordance->topWords(*top_count));
+        return 0;
+    }
+
+    printConcordance(*concordance, findPrefixes(getArgs()), parse_options.encoding);
+    return 0;
 }
 
 
+QueryClient::QueryClient(const std::vector<CommandLineArg> &execution_args) : AppExecutor(execution_args)
+{
+}
+
+int QueryClient::execute()
+{
+    std::string socket_path = findTextValue(getArgs(), "--connect").value_or("");
+    std::vector<Query> queries = findQueries(getArgs());
+    ConcordanceClient client = ConcordanceClient::makeConnected(socket_path);
+
+    if( !client.isConnected() ){
+        std::cerr << "Could not connect to socket: " << socket_path << std::endl;
+        return -1;
+    }
+
+    std::optional< std::vector<QueryResult> > results = client.ask(queries);
+
+    if( !results && client.isConnected() ){
+        std::cerr << "The results are too large to be sent, try a longer prefix" << std::endl;
+        return -1;
+    } else if( !results ){
+        std::cerr << "The server on " << socket_path << " did not answer" << std::endl;
+        return -1;
+    }
+
+    for( size_t query = 0; query < queries.size(); query++ ){
+        printQueryResult(queries[query], (*results)[query]);
+    }
+
+    return 0;
+}
 
 std::unique_ptr<AppExecutor> ExecutionFactory::createExecutor(const std::vector<CommandLineArg> &execution_args)
 {
@@ -235,6 +630,8 @@ std::unique_ptr<AppExecutor> ExecutionFactory::createExecutor(const std::vector<
         return std::make_unique<HelpExecutor>(execution_args);
     } else if( existHelpFlag(execution_args) ){
         return std::make_unique<HelpExecutor>(execution_args);
+    } else if( findTextValue(execution_args, "--connect") ){
+        return std::make_unique<QueryClient>(execution_args);
     } else {
         return std::make_unique<ConcordanceGenerator>(execution_args);
     }
@@ -0,0 +1,357 @@
+#include "ByteSource.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MemoryMappedFile.hpp"
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+//INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+namespace
+{
+
+//INTERNAL AUX CLASS DECLARATIONS
+//==========================================================================|
+//							  InMemorySource								|
+//==========================================================================|
+// @brief: Base of the sources whose bytes are already in memory. Reading	|
+//		   copies out of the view, while contiguousView() lets a reader		|
+//		   skip the copy completely											|
+//==========================================================================|
+class InMemorySource : public ByteSource
+{
+public:
+	size_t read(char *buffer, size_t capacity) override;
+	std::optional<std::string_view> contiguousView() const override;
+
+protected:
+	virtual std::string_view bytes() const = 0;
+
+private:
+	size_t m_position = 0;
+};
+
+class ViewSource : public InMemorySource
+{
+public:
+	ViewSource(std::string_view view) : m_view(view) {}
+
+protected:
+	std::string_view bytes() const override { return m_view; }
+
+private:
+	std::string_view m_view;
+};
+
+class MemorySource : public InMemorySource
+{
+public:
+	MemorySource(std::string text) : m_text(std::move(text)) {}
+
+protected:
+	std::string_view bytes() const override { return m_text; }
+
+private:
+	std::string m_text;
+};
+
+class MappedFileSource : public InMemorySource
+{
+public:
+	MappedFileSource(MemoryMappedFile &&mapped_file) : m_mapped_file(std::move(mapped_file)) {}
+
+	void release(std::string_view bytes) const override { m_mapped_file.release(bytes); }
+
+protected:
+	std::string_view bytes() const override { return m_mapped_file.view(); }
+
+private:
+	MemoryMappedFile m_mapped_file;
+};
+
+//==========================================================================|
+//							  StreamFileSource								|
+//==========================================================================|
+// @brief: Reads a file through std::ifstream in blocks. Used for non		|
+//		   regular files and whenever mapping is not requested				|
+//==========================================================================|
+class StreamFileSource : public ByteSource
+{
+public:
+	StreamFileSource(const std::string &filepath) : m_stream(filepath, std::ios::binary) {}
+	size_t read(char *buffer, size_t capacity) override;
+
+private:
+	std::ifstream m_stream;
+};
+
+//==========================================================================|
+//								CFileSource									|
+//==========================================================================|
+// @brief: Reads a C stream, like stdin or the output of a process started	|
+//		   with popen. The closer releases the stream once reading is over	|
+//==========================================================================|
+class CFileSource : public ByteSource
+{
+public:
+	using Closer = int (*)(FILE *);
+
+	CFileSource(FILE *file, Closer closer) : m_file(file, closer) {}
+	size_t read(char *buffer, size_t capacity) override;
+
+private:
+	std::unique_ptr<FILE, Closer> m_file;
+};
+
+//==========================================================================|
+//							  ReadAheadSource								|
+//==========================================================================|
+// @brief: Decorator which reads the wrapped source on a background thread.	|
+//		   Up to queue_depth blocks are loaded ahead, so reading from the	|
+//		   wrapped source overlaps with the consumer. Block buffers are		|
+//		   recycled once consumed, so no allocation happens after warm-up	|
+//==========================================================================|
+class ReadAheadSource : public ByteSource
+{
+public:
+	ReadAheadSource(std::unique_ptr<ByteSource> source, const ReadAheadOptions &options);
+	~ReadAheadSource();
+
+	size_t read(char *buffer, size_t capacity) override;
+
+private:
+	struct Block
+	{
+		std::vector<char> bytes;
+		size_t size = 0;
+	};
+
+	void produceBlocks();
+	bool takeNextBlock();
+
+private:
+	std::unique_ptr<ByteSource> m_source;
+	ReadAheadOptions m_options;
+
+	std::mutex m_mutex;
+	std::condition_variable m_block_loaded;
+	std::condition_variable m_block_consumed;
+	std::deque<Block> m_loaded_blocks;
+	std::vector<Block> m_free_blocks;
+	bool m_source_finished = false;
+	bool m_stopping = false;
+
+	Block m_current_block;
+	size_t m_current_position = 0;
+
+	std::thread m_producer;
+};
+//END OF INTERNAL AUX CLASS DECLARATIONS
+
+
+//INTERNAL AUX FUNCTIONS
+static int leaveOpen(FILE *)
+{
+	return 0;
+}
+//END OF INTERNAL AUX FUNCTIONS
+
+
+//INTERNAL AUX CLASS DEFINITIONS
+size_t InMemorySource::read(char *buffer, size_t capacity)
+{
+	std::string_view unread = bytes().substr(std::min(m_position, bytes().size()));
+	size_t count = std::min(capacity, unread.size());
+
+	std::memcpy(buffer, unread.data(), count);
+	m_position += count;
+	return count;
+}
+
+std::optional<std::string_view> InMemorySource::contiguousView() const
+{
+	return bytes();
+}
+
+size_t StreamFileSource::read(char *buffer, size_t capacity)
+{
+	if( !m_stream.is_open() ){
+		return 0;
+	}
+
+	m_stream.read(buffer, static_cast<std::streamsize>(capacity));
+	return static_cast<size_t>(m_stream.gcount());
+}
+
+size_t CFileSource::read(char *buffer, size_t capacity)
+{
+	if( !m_file ){
+		return 0;
+	}
+
+	return std::fread(buffer, 1, capacity, m_file.get());
+}
+
+ReadAheadSource::ReadAheadSource(std::unique_ptr<ByteSource> source, const ReadAheadOptions &options)
+	: m_source(std::move(source)), m_options(options)
+{
+	m_options.block_size = std::max<size_t>(m_options.block_size, 1);
+	m_options.queue_depth = std::max<size_t>(m_options.queue_depth, 1);
+	m_producer = std::thread(&ReadAheadSource::produceBlocks, this);
+}
+
+ReadAheadSource::~ReadAheadSource()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+
+	m_block_consumed.notify_all();
+	m_producer.join();
+}
+
+size_t ReadAheadSource::read(char *buffer, size_t capacity)
+{
+	if( m_current_position == m_current_block.size && !takeNextBlock() ){
+		return 0;
+	}
+
+	size_t count = std::min(capacity, m_current_block.size - m_current_position);
+	std::memcpy(buffer, m_current_block.bytes.data() + m_current_position, count);
+	m_current_position += count;
+	return count;
+}
+
+bool ReadAheadSource::takeNextBlock()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	if( m_current_block.bytes.size() ){
+		m_free_blocks.push_back(std::move(m_current_block));
+		m_block_consumed.notify_one();
+	}
+
+	m_block_loaded.wait(lock, [this]{ return m_loaded_blocks.size() || m_source_finished; });
+
+	if( m_loaded_blocks.empty() ){
+		m_current_block = Block();
+		m_current_position = 0;
+		return false;
+	}
+
+	m_current_block = std::move(m_loaded_blocks.front());
+	m_loaded_blocks.pop_front();
+	m_current_position = 0;
+	return true;
+}
+
+void ReadAheadSource::produceBlocks()
+{
+	while( true ){
+		Block block;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_block_consumed.wait(lock, [this]{ return m_loaded_blocks.size() < m_options.queue_depth || m_stopping; });
+
+			if( m_stopping ){
+				return;
+			}
+
+			if( m_free_blocks.size() ){
+				block = std::move(m_free_blocks.back());
+				m_free_blocks.pop_back();
+			}
+		}
+
+		//The wrapped source is read without holding the lock, this is
+		//where reading overlaps with the consumer
+		block.bytes.resize(m_options.block_size);
+		block.size = m_source->read(block.bytes.data(), block.bytes.size());
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if( block.size == 0 ){
+			m_source_finished = true;
+			m_block_loaded.notify_one();
+			return;
+		}
+
+		m_loaded_blocks.push_back(std::move(block));
+		m_block_loaded.notify_one();
+	}
+}
+//END OF INTERNAL AUX CLASS DEFINITIONS
+
+}//ANONYMOUS NAMESPACE
+//END OF INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+
+
+
+//EXTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//								 ByteSource									|
+//==========================================================================|
+std::optional<std::string_view> ByteSource::contiguousView() const
+{
+	return std::nullopt;
+}
+
+void ByteSource::release(std::string_view) const
+{
+}
+
+std::unique_ptr<ByteSource> ByteSource::makeFromFile(const std::string &filepath, ReadMode mode)
+{
+	if( mode == ReadMode::MemoryMapped ){
+		MemoryMappedFile mapped_file = MemoryMappedFile::makeFromFile(filepath);
+
+		if( mapped_file.isMapped() ){
+			return std::make_unique<MappedFileSource>(std::move(mapped_file));
+		}
+	}
+
+	return std::make_unique<StreamFileSource>(filepath);
+}
+
+std::unique_ptr<ByteSource> ByteSource::makeFromStdin()
+{
+	return std::make_unique<CFileSource>(stdin, leaveOpen);
+}
+
+std::unique_ptr<ByteSource> ByteSource::makeFromPipe(const std::string &command)
+{
+	return std::make_unique<CFileSource>(popen(command.c_str(), "r"), pclose);
+}
+
+std::unique_ptr<ByteSource> ByteSource::makeFromMemory(std::string text)
+{
+	return std::make_unique<MemorySource>(std::move(text));
+}
+
+std::unique_ptr<ByteSource> ByteSource::makeFromView(std::string_view text)
+{
+	return std::make_unique<ViewSource>(text);
+}
+
+std::unique_ptr<ByteSource> ByteSource::makeReadAhead(std::unique_ptr<ByteSource> source, const ReadAheadOptions &options)
+{
+	if( source->contiguousView() ){
+		return source;
+	}
+
+	return std::make_unique<ReadAheadSource>(std::move(source), options);
+}
+//END OF EXTERNAL CLASS DEFINITIONS
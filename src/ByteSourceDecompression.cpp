@@ -0,0 +1,324 @@
+#include "ByteSource.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef CONCORDANCE_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef CONCORDANCE_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+//INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+namespace
+{
+
+constexpr size_t MagicSize = 4;
+constexpr size_t CompressedBlockSize = 1 << 16;
+
+//INTERNAL AUX CLASS DECLARATIONS
+//==========================================================================|
+//							   PrefixedSource								|
+//==========================================================================|
+// @brief: Replays the bytes already taken from a source to detect its		|
+//		   format, then continues with the source itself					|
+//==========================================================================|
+class PrefixedSource : public ByteSource
+{
+public:
+	PrefixedSource(std::string prefix, std::unique_ptr<ByteSource> source)
+		: m_prefix(std::move(prefix)), m_source(std::move(source)) {}
+
+	size_t read(char *buffer, size_t capacity) override;
+
+private:
+	std::string m_prefix;
+	size_t m_prefix_position = 0;
+	std::unique_ptr<ByteSource> m_source;
+};
+
+//==========================================================================|
+//							 CompressedSource								|
+//==========================================================================|
+// @brief: Base of the decoders. Keeps a block of compressed bytes read		|
+//		   from the wrapped source, subclasses decode it into the caller's	|
+//		   buffer. Corrupt input ends the document where decoding failed	|
+//==========================================================================|
+class CompressedSource : public ByteSource
+{
+public:
+	CompressedSource(std::unique_ptr<ByteSource> source)
+		: m_source(std::move(source)), m_input(CompressedBlockSize) {}
+
+	size_t read(char *buffer, size_t capacity) override;
+
+protected:
+	//Decodes from m_input[m_input_position, m_input_size) into the output,
+	//advancing m_input_position. Returns false once decoding cannot go on
+	virtual bool decode(char *buffer, size_t capacity, size_t &produced) = 0;
+	bool refillInput();
+
+protected:
+	std::unique_ptr<ByteSource> m_source;
+	std::vector<char> m_input;
+	size_t m_input_position = 0;
+	size_t m_input_size = 0;
+	bool m_finished = false;
+};
+
+#ifdef CONCORDANCE_HAVE_ZLIB
+//==========================================================================|
+//								 GzipSource									|
+//==========================================================================|
+// @brief: Decodes gzip with zlib. Concatenated members, as written by		|
+//		   "cat a.gz b.gz", are decoded one after the other					|
+//==========================================================================|
+class GzipSource : public CompressedSource
+{
+public:
+	GzipSource(std::unique_ptr<ByteSource> source);
+	~GzipSource();
+
+protected:
+	bool decode(char *buffer, size_t capacity, size_t &produced) override;
+
+private:
+	z_stream m_stream = {};
+	bool m_initialized = false;
+};
+#endif
+
+#ifdef CONCORDANCE_HAVE_ZSTD
+//==========================================================================|
+//								 ZstdSource									|
+//==========================================================================|
+// @brief: Decodes zstd frames with the streaming API of libzstd			|
+//==========================================================================|
+class ZstdSource : public CompressedSource
+{
+public:
+	ZstdSource(std::unique_ptr<ByteSource> source);
+	~ZstdSource();
+
+protected:
+	bool decode(char *buffer, size_t capacity, size_t &produced) override;
+
+private:
+	ZSTD_DStream *m_stream = nullptr;
+};
+#endif
+//END OF INTERNAL AUX CLASS DECLARATIONS
+
+
+//INTERNAL AUX FUNCTIONS
+static Compression detectCompression(std::string_view head)
+{
+	if( head.size() >= 2 && head[0] == '\x1f' && head[1] == '\x8b' ){
+		return Compression::Gzip;
+	}
+
+	if( head.size() >= 4 && head.substr(0, 4) == std::string_view("\x28\xb5\x2f\xfd", 4) ){
+		return Compression::Zstd;
+	}
+
+	return Compression::None;
+}
+
+static std::string readHead(ByteSource &source)
+{
+	std::array<char, MagicSize> head;
+	size_t size = 0;
+
+	while( size < head.size() ){
+		size_t count = source.read(head.data() + size, head.size() - size);
+
+		if( count == 0 ){
+			break;
+		}
+		size += count;
+	}
+
+	return std::string(head.data(), size);
+}
+
+static std::unique_ptr<ByteSource> makeDecoder(Compression compression, std::unique_ptr<ByteSource> source)
+{
+	switch( compression ){
+#ifdef CONCORDANCE_HAVE_ZLIB
+	case Compression::Gzip:
+		return std::make_unique<GzipSource>(std::move(source));
+#endif
+#ifdef CONCORDANCE_HAVE_ZSTD
+	case Compression::Zstd:
+		return std::make_unique<ZstdSource>(std::move(source));
+#endif
+	default:
+		return source;
+	}
+}
+//END OF INTERNAL AUX FUNCTIONS
+
+
+//INTERNAL AUX CLASS DEFINITIONS
+size_t PrefixedSource::read(char *buffer, size_t capacity)
+{
+	if( m_prefix_position < m_prefix.size() ){
+		size_t count = std::min(capacity, m_prefix.size() - m_prefix_position);
+		std::memcpy(buffer, m_prefix.data() + m_prefix_position, count);
+		m_prefix_position += count;
+		return count;
+	}
+
+	return m_source->read(buffer, capacity);
+}
+
+size_t CompressedSource::read(char *buffer, size_t capacity)
+{
+	size_t produced = 0;
+
+	//A call may consume input without producing output (headers, frame
+	//boundaries), so decoding goes on until something is produced
+	while( produced == 0 && capacity && !m_finished ){
+		if( m_input_position == m_input_size && !refillInput() ){
+			m_finished = true;
+			break;
+		}
+
+		if( !decode(buffer, capacity, produced) ){
+			m_finished = true;
+		}
+	}
+
+	return produced;
+}
+
+bool CompressedSource::refillInput()
+{
+	m_input_position = 0;
+	m_input_size = m_source->read(m_input.data(), m_input.size());
+	return m_input_size;
+}
+
+#ifdef CONCORDANCE_HAVE_ZLIB
+GzipSource::GzipSource(std::unique_ptr<ByteSource> source) : CompressedSource(std::move(source))
+{
+	//15 + 32 selects the largest window and automatic gzip/zlib header detection
+	m_initialized = inflateInit2(&m_stream, 15 + 32) == Z_OK;
+	m_finished = !m_initialized;
+}
+
+GzipSource::~GzipSource()
+{
+	if( m_initialized ){
+		inflateEnd(&m_stream);
+	}
+}
+
+bool GzipSource::decode(char *buffer, size_t capacity, size_t &produced)
+{
+	size_t available_in = m_input_size - m_input_position;
+	size_t available_out = std::min<size_t>(capacity, UINT32_MAX);
+
+	m_stream.next_in = reinterpret_cast<Bytef *>(m_input.data() + m_input_position);
+	m_stream.avail_in = static_cast<uInt>(available_in);
+	m_stream.next_out = reinterpret_cast<Bytef *>(buffer);
+	m_stream.avail_out = static_cast<uInt>(available_out);
+
+	int result = inflate(&m_stream, Z_NO_FLUSH);
+
+	m_input_position += available_in - m_stream.avail_in;
+	produced = available_out - m_stream.avail_out;
+
+	if( result == Z_STREAM_END ){
+		//Another member may follow, trailing garbage fails on the next call
+		if( m_input_position == m_input_size && !refillInput() ){
+			return false;
+		}
+		return inflateReset(&m_stream) == Z_OK;
+	}
+
+	return result == Z_OK || result == Z_BUF_ERROR;
+}
+#endif
+
+#ifdef CONCORDANCE_HAVE_ZSTD
+ZstdSource::ZstdSource(std::unique_ptr<ByteSource> source)
+	: CompressedSource(std::move(source)), m_stream(ZSTD_createDStream())
+{
+	m_finished = !m_stream || ZSTD_isError(ZSTD_initDStream(m_stream));
+}
+
+ZstdSource::~ZstdSource()
+{
+	ZSTD_freeDStream(m_stream);
+}
+
+bool ZstdSource::decode(char *buffer, size_t capacity, size_t &produced)
+{
+	ZSTD_inBuffer input = { m_input.data(), m_input_size, m_input_position };
+	ZSTD_outBuffer output = { buffer, capacity, 0 };
+
+	//Consecutive frames are decoded by the same stream without a reset
+	size_t result = ZSTD_decompressStream(m_stream, &output, &input);
+
+	m_input_position = input.pos;
+	produced = output.pos;
+	return !ZSTD_isError(result);
+}
+#endif
+//END OF INTERNAL AUX CLASS DEFINITIONS
+
+}//ANONYMOUS NAMESPACE
+//END OF INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+
+
+
+//EXTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//								 ByteSource									|
+//==========================================================================|
+std::unique_ptr<ByteSource> ByteSource::makeDecompressing(std::unique_ptr<ByteSource> source)
+{
+	Compression compression = Compression::None;
+
+	if( std::optional<std::string_view> view = source->contiguousView() ){
+		//In memory sources are checked without consuming anything
+		compression = detectCompression(view->substr(0, MagicSize));
+	} else{
+		std::string head = readHead(*source);
+		compression = detectCompression(head);
+		source = std::make_unique<PrefixedSource>(std::move(head), std::move(source));
+	}
+
+	if( compression == Compression::None || !isSupported(compression) ){
+		return source;
+	}
+
+	return makeReadAhead(makeDecoder(compression, std::move(source)));
+}
+
+bool ByteSource::isSupported(Compression compression)
+{
+	switch( compression ){
+	case Compression::Gzip:
+#ifdef CONCORDANCE_HAVE_ZLIB
+		return true;
+#else
+		return false;
+#endif
+	case Compression::Zstd:
+#ifdef CONCORDANCE_HAVE_ZSTD
+		return true;
+#else
+		return false;
+#endif
+	default:
+		return true;
+	}
+}
+//END OF EXTERNAL CLASS DEFINITIONS
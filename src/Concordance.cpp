@@ -1,156 +1,1334 @@
 #include "Concordance.hpp"
 
 #include <map>
-#include <deque>
+#include <array>
+#include <span>
 #include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <utility>
 
+#if defined(__unix__) || defined(__APPLE__)
+#define CONCORDANCE_HAS_MKSTEMP 1
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+#include "CharacterClasses.hpp"
 #include "WordSanitizer.hpp"
 #include "TextDocumentTraveller.hpp"
 #include "WordValidator.hpp"
+#include "DelimiterScanner.hpp"
+#include "WordTable.hpp"
+#include "RadixTrie.hpp"
+#include "ConcordanceIndex.hpp"
+#include "ConcordanceRuns.hpp"
+#include "WorkStealingPool.hpp"
+
+static constexpr size_t TokenBatchSize = 256;
+
+//Files parsed before their concordances are merged, which bounds how many
+//partial concordances are alive at once
+static constexpr size_t FileBatchSize = 1024;
+
+//Bytes before the checkpoint of a document which are fingerprinted
+static constexpr size_t BoundaryHashSize = 4096;
+
+//Bytes of a document parsed between two releases of its pages
+static constexpr size_t ReleasedDocumentSize = 1 << 24;
+
+//Bytes a word costs besides its own: its list, its slot in the engine and
+//the allocations around them, roughly
+static constexpr size_t WordMemoryOverhead = 96;
+
+//INTERNAL CLASS DECLARATIONS
+//==========================================================================|
+//							Concordance::Impl								|
+//==========================================================================|
+class Concordance::Impl
+{
+public:
+	Impl(ConcordanceEngine engine);
+	Impl(ConcordanceEngine engine, std::shared_ptr<const ConcordanceRuns> runs);
+
+	size_t size() const;
+	bool equalsWith(const Concordance::Impl &other) const;
+	bool exists(std::string_view word);
+	std::optional<Occurrences> lookup(std::string_view word) const;
+	std::vector<WordCount> topWords(size_t k) const;
+	void addOccurrence(std::string_view word, Sentence sentence);
+	void addOccurrences(std::string_view word, Occurrences &&occurrences);
+	void forEachWord(const IteratorFunc &run_callback) const;
+	void forEachWithPrefix(std::string_view prefix, const IteratorFunc &run_callback) const;
+	void forEachInRange(std::string_view first, std::string_view last, const IteratorFunc &run_callback) const;
+
+	Sentence sentenceCount() const;
+	size_t memoryEstimate() const;
+	ConcordanceEngine engine() const;
+
+	template <typename Source>
+	void merge(Source &&other, Sentence offset);
+	void mergeAll(std::vector<Concordance::Impl *> partials, const std::vector<Sentence> &offsets);
+
+	bool save(const std::string &filepath) const;
+
+private:
+	Occurrences &findOrInsert(std::string_view word);
+	const Occurrences *find(std::string_view word) const;
+	bool holds(std::string_view word, const Occurrences &occurrences) const;
+	void loadRuns();
+	bool joinsRuns(const std::vector<Concordance::Impl *> &partials) const;
+	bool mergesThroughHeap(const std::vector<Concordance::Impl *> &partials) const;
+
+	template <typename Predicate>
+	void forEachHashedMatch(Predicate &&matches, const IteratorFunc &run_callback) const;
+	RadixTrie::WordVisitor visitTrieWords(const IteratorFunc &run_callback) const;
+	void forEachRunMatch(std::string_view first, const ConcordanceRuns::WordBound &matches, const IteratorFunc &run_callback) const;
+
+	template <typename Self, typename Function>
+	static void forEachUnordered(Self &self, Function &&function);
+	template <typename Self, typename Function>
+	static void forEachSorted(Self &self, Function &&function);
+
+private:
+	ConcordanceEngine m_engine;
+	Sentence m_sentence_count = 0;
+	std::map<Word, Occurrences, std::less<> > m_ordered_words;
+	WordTable m_hashed_words;
+	RadixTrie m_trie_words;
+
+	//Bytes the words and lists added one by one take, roughly
+	size_t m_memory_estimate = 0;
+
+	//Serves every read while set, the words are only loaded into the
+	//engine once the concordance is modified. Copies share the mappings
+	std::shared_ptr<const ConcordanceRuns> m_runs;
+};
+//END OF INTERNAL CLASS DECLARATIONS`
+
+
+//INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+namespace
+{
+
+//A consumed list is moved whenever it does not need to be shifted
+static void appendShifted(Occurrences &target, const Occurrences &source, Sentence offset)
+{
+	target.append(source, offset);
+}
+
+static void appendShifted(Occurrences &target, Occurrences &&source, Sentence offset)
+{
+	if( target.empty() && offset == 0 ){
+		target = std::move(source);
+		return;
+	}
+
+	target.append(source, offset);
+}
+
+static bool isAbbreviation(const Word &word)
+{
+	return std::count(word.begin(), word.end(), '.') > 1;
+}
+
+static bool startsWithCapital(std::string_view word)
+{
+	return Utf8::startsWithUppercase(word);
+}
+
+//A new empty file in directory, or the temporary directory when it is
+//empty, which no other run is given
+static std::optional<std::string> makeSpillPath(const std::string &directory)
+{
+#ifdef CONCORDANCE_HAS_MKSTEMP
+	std::error_code error;
+	std::filesystem::path parent = directory.empty() ? std::filesystem::temp_directory_path(error) : std::filesystem::path(directory);
+	std::string path = (parent / "concordance-run-XXXXXX").string();
+	int descriptor = ::mkstemp(path.data());
+
+	if( error || descriptor < 0 ){
+		return std::nullopt;
+	}
+
+	::close(descriptor);
+	return path;
+#else
+	return std::nullopt;
+#endif
+}
+
+//Saves concordance as a run and opens it back Sequential, as runs are only
+//read in passes. The file is removed right away, its mapping keeps it
+//readable for as long as the run is alive
+static std::optional<Concordance> spillRun(const Concordance &concordance, const ParseOptions &options)
+{
+	std::optional<std::string> path = makeSpillPath(options.spill_directory);
+	if( !path ){
+		return std::nullopt;
+	}
+
+	std::optional<Concordance> run = concordance.save(*path) ? Concordance::open(*path, options.engine, MappedAccess::Sequential) : std::nullopt;
+	std::remove(path->c_str());
+	return run;
+}
+
+//==========================================================================|
+//							  SentenceTracker								|
+//==========================================================================|
+// @brief: Numbers the sentences of a run of elements. A word starting with	|
+//		   a capital which follows a sentence terminating symbol opens a	|
+//		   new sentence. What the run starts and ends with is kept, so that	|
+//		   runs parsed separately can be stitched back together				|
+//==========================================================================|
+class SentenceTracker
+{
+public:
+	SentenceTracker() {}
+	SentenceTracker(Sentence current_sentence, bool previous_changes_sentence);
+
+	void onWord(std::string_view word);
+	void onSymbol(bool changes_sentence);
+
+	Sentence currentSentence() const;
+	bool isEmpty() const;
+	bool opensWithCapital() const;
+	bool endsWithSentenceChange() const;
+
+private:
+	Sentence m_current_sentence = 1;
+	bool m_previous_changes_sentence = false;
+	bool m_is_empty = true;
+	bool m_opens_with_capital = false;
+};
+
+//==========================================================================|
+//							ParsedElementVisitor							|
+//==========================================================================|
+// @brief: Adds the words of a run of elements to a concordance. Under a	|
+//		   memory budget, the words parsed so far are spilled as a run		|
+//		   whenever they outgrow it, and parsing goes on from an empty		|
+//		   concordance. A run which cannot be written leaves the words in	|
+//		   memory and stops any further spill								|
+//==========================================================================|
+class ParsedElementVisitor
+{
+public:
+	ParsedElementVisitor(const ParseOptions &options = ParseOptions());
+	ParsedElementVisitor(const ParseOptions &options, const SentenceTracker &sentence_tracker);
+
+	void visit(const Token &token);
+	void operator()(std::string_view word);
+	void spillIfOverBudget();
+
+	Concordance &getParsedConcordance();
+	const SentenceTracker &getSentenceTracker() const;
+
+	bool hasSpilled() const;
+
+	//Every run spilled, then the words left in memory, in the order of
+	//their sentences. Only the parsed concordance when nothing was spilled
+	std::vector<Concordance> takeParsedParts();
+
+private:
+	Concordance m_concordance;
+	SentenceTracker m_sentence_tracker;
+	ParseOptions m_options;
+	std::vector<Concordance> m_spilled_runs;
+	bool m_spill_failed = false;
+};
+
+//Continues sentences which were numbered elsewhere
+SentenceTracker::SentenceTracker(Sentence current_sentence, bool previous_changes_sentence)
+	: m_current_sentence(current_sentence), m_previous_changes_sentence(previous_changes_sentence)
+{
+}
+
+void SentenceTracker::onWord(std::string_view word)
+{
+	if( m_is_empty ){
+		m_opens_with_capital = startsWithCapital(word);
+		m_is_empty = false;
+	}
+
+	if( startsWithCapital(word) && m_previous_changes_sentence ){
+		++m_current_sentence;
+	}
+
+	m_previous_changes_sentence = false;
+}
+
+void SentenceTracker::onSymbol(bool changes_sentence)
+{
+	m_is_empty = false;
+	m_previous_changes_sentence = changes_sentence;
+}
+
+Sentence SentenceTracker::currentSentence() const
+{
+	return m_current_sentence;
+}
+
+bool SentenceTracker::isEmpty() const
+{
+	return m_is_empty;
+}
+
+bool SentenceTracker::opensWithCapital() const
+{
+	return m_opens_with_capital;
+}
+
+bool SentenceTracker::endsWithSentenceChange() const
+{
+	return m_previous_changes_sentence;
+}
+
+ParsedElementVisitor::ParsedElementVisitor(const ParseOptions &options)
+	: m_concordance( Concordance::makeEmpty(options.engine) ), m_options(options)
+{
+}
+
+ParsedElementVisitor::ParsedElementVisitor(const ParseOptions &options, const SentenceTracker &sentence_tracker)
+	: ParsedElementVisitor(options)
+{
+	m_sentence_tracker = sentence_tracker;
+}
+
+void ParsedElementVisitor::visit(const Token &token)
+{
+	if( token.isSymbol() ){
+		m_sentence_tracker.onSymbol(changesSentence(token));
+	} else{
+		(*this)(token.text());
+	}
+}
+
+void ParsedElementVisitor::operator()(std::string_view word)
+{
+	m_sentence_tracker.onWord(word);
+	m_concordance.add(word, m_sentence_tracker.currentSentence(), m_options.encoding);
+}
+
+void ParsedElementVisitor::spillIfOverBudget()
+{
+	if( !m_options.max_memory || m_spill_failed || m_concordance.memoryEstimate() <= m_options.max_memory ){
+		return;
+	}
+
+	std::optional<Concordance> run = spillRun(m_concordance, m_options);
+	if( !run ){
+		m_spill_failed = true;
+		return;
+	}
+
+	m_spilled_runs.push_back(std::move(*run));
+	m_concordance = Concordance::makeEmpty(m_options.engine);
+}
+
+Concordance &ParsedElementVisitor::getParsedConcordance()
+{
+	return m_concordance;
+}
+
+const SentenceTracker &ParsedElementVisitor::getSentenceTracker() const
+{
+	return m_sentence_tracker;
+}
+
+bool ParsedElementVisitor::hasSpilled() const
+{
+	return !m_spilled_runs.empty();
+}
+
+//The words left are spilled as well when they can be, so that the parts
+//are only runs and join without being loaded
+std::vector<Concordance> ParsedElementVisitor::takeParsedParts()
+{
+	std::vector<Concordance> parts = std::move(m_spilled_runs);
+	m_spilled_runs.clear();
+
+	if( !parts.empty() && m_concordance.size() > 0 ){
+		std::optional<Concordance> run = spillRun(m_concordance, m_options);
+		parts.push_back(run ? std::move(*run) : std::move(m_concordance));
+	} else if( parts.empty() ){
+		parts.push_back(std::move(m_concordance));
+	}
+
+	m_concordance = Concordance::makeEmpty(m_options.engine);
+	return parts;
+}
+
+//==========================================================================|
+//							  DocumentReleaser								|
+//==========================================================================|
+// @brief: Hands the bytes of a document already parsed back to its source	|
+//		   under a memory budget, so that a mapped document is never held	|
+//		   whole in memory. Tokens come in the order of the document and	|
+//		   the next ones never view bytes before the last one, so every		|
+//		   byte before it is done with										|
+//==========================================================================|
+class DocumentReleaser
+{
+public:
+	DocumentReleaser() {}
+	DocumentReleaser(const ByteSource *source, std::string_view document, const ParseOptions &options);
+
+	void releaseBefore(const Token &token);
+
+private:
+	const ByteSource *m_source = nullptr;
+	std::string_view m_document;
+	size_t m_released_size = 0;
+};
+
+DocumentReleaser::DocumentReleaser(const ByteSource *source, std::string_view document, const ParseOptions &options)
+	: m_source(options.max_memory ? source : nullptr), m_document(document)
+{
+}
+
+void DocumentReleaser::releaseBefore(const Token &token)
+{
+	const char *position = token.text().data();
+
+	if( !m_source || position < m_document.data() || position > m_document.data() + m_document.size() ){
+		return;
+	}
+
+	size_t parsed_size = position - m_document.data();
+	if( parsed_size - std::min(parsed_size, m_released_size) >= ReleasedDocumentSize ){
+		m_source->release(m_document.substr(0, parsed_size));
+		m_released_size = parsed_size;
+	}
+}
+
+static void parseDocument(TextDocumentTraveller &document_traveller, ParsedElementVisitor &element_visitor,
+						  DocumentReleaser document_releaser = DocumentReleaser())
+{
+	std::array<Token, TokenBatchSize> tokens;
+	while( size_t count = document_traveller.next(tokens) ){
+		for( const Token &token : std::span(tokens).first(count) ){
+			element_visitor.visit(token);
+		}
+
+		element_visitor.spillIfOverBudget();
+		document_releaser.releaseBefore(tokens[count - 1]);
+	}
+}
+
+//Parts of one document, each shifted by its offset. A single part which is
+//not shifted is taken over as it is
+static Concordance joinParts(std::vector<Concordance> &&parts, std::vector<Sentence> offsets)
+{
+	if( parts.size() == 1 && offsets.front() == 0 ){
+		return std::move(parts.front());
+	}
+
+	return Concordance::merge(std::move(parts), std::move(offsets));
+}
+
+static size_t resolveShardCount(size_t document_size, const ParseOptions &options)
+{
+	size_t shard_count = options.shard_count ? options.shard_count : std::thread::hardware_concurrency();
+	size_t max_shard_count = document_size / std::max<size_t>(options.min_shard_size, 1);
+
+	return std::max<size_t>(std::min(shard_count, max_shard_count), 1);
+}
+
+//Shards end right before a whitespace, so no chunk of the tokenizer is
+//ever split between two shards
+static std::vector<std::string_view> splitIntoShards(std::string_view document, size_t shard_count)
+{
+	std::vector<std::string_view> shards;
+	const char *shard_begin = document.data();
+	const char *document_end = document.data() + document.size();
+
+	for( size_t shard = 1; shard <= shard_count; shard++ ){
+		const char *shard_end = document_end;
+
+		if( shard < shard_count ){
+			const char *target = document.data() + document.size() / shard_count * shard;
+			shard_end = DelimiterScanner::findWhitespace(std::max(target, shard_begin), document_end);
+		}
+
+		shards.emplace_back(shard_begin, shard_end - shard_begin);
+		shard_begin = shard_end;
+	}
+
+	return shards;
+}
+
+//Parses document, the contiguous view of source, on shard_count threads.
+//The first shard continues the sentences of sentence_tracker, which is
+//left where the document ends
+static Concordance parseInShards(const ByteSource &source, std::string_view document, size_t shard_count,
+								 const ParseOptions &options, SentenceTracker &sentence_tracker)
+{
+	//Every shard but the first numbers its sentences from 1, as if it was
+	//a document. The memory budget is split evenly between the shards
+	std::vector<std::string_view> shards = splitIntoShards(document, shard_count);
+	ParseOptions shard_options = options;
+	shard_options.max_memory = options.max_memory ? std::max<size_t>(options.max_memory / shards.size(), 1) : 0;
+
+	std::vector<ParsedElementVisitor> element_visitors(shards.size(), ParsedElementVisitor(shard_options));
+	element_visitors.front() = ParsedElementVisitor(shard_options, sentence_tracker);
+	std::vector<std::thread> workers;
+
+	auto parse_shard = [&source, &shards, &element_visitors, &options](size_t shard){
+		TextDocumentTraveller document_traveller(ByteSource::makeFromView(shards[shard]), options.encoding, SourceDecoding::Decoded);
+		parseDocument(document_traveller, element_visitors[shard], DocumentReleaser(&source, shards[shard], options));
+	};
+
+	for( size_t shard = 1; shard < shards.size(); shard++ ){
+		workers.emplace_back(parse_shard, shard);
+	}
+	parse_shard(0);
+
+	for( std::thread &worker : workers ){
+		worker.join();
+	}
+
+	//Shards are shifted by the sentences of the shards before them. A seam
+	//opens a new sentence under the same rule the visitor applies inside a
+	//shard: the previous shard ends with a sentence terminating symbol and
+	//this one opens with a capitalized word. Once any shard has spilled,
+	//the parts of every shard are joined in one merge instead
+	bool has_spilled = std::any_of(element_visitors.begin(), element_visitors.end(), [](const ParsedElementVisitor &element_visitor){
+		return element_visitor.hasSpilled();
+	});
+	std::vector<Concordance> parts;
+	std::vector<Sentence> part_offsets;
+
+	auto add_shard = [&](size_t shard, Sentence offset){
+		if( !has_spilled ){
+			parts.push_back(std::move(element_visitors[shard].getParsedConcordance()));
+			part_offsets.push_back(offset);
+			return;
+		}
+
+		for( Concordance &part : element_visitors[shard].takeParsedParts() ){
+			parts.push_back(std::move(part));
+			part_offsets.push_back(offset);
+		}
+	};
+
+	add_shard(0, 0);
+	const SentenceTracker &first_tracker = element_visitors.front().getSentenceTracker();
+	Sentence offset = first_tracker.currentSentence() - 1;
+	bool previous_changes_sentence = first_tracker.endsWithSentenceChange();
+
+	for( size_t shard = 1; shard < shards.size(); shard++ ){
+		const SentenceTracker &tracker = element_visitors[shard].getSentenceTracker();
+
+		if( tracker.isEmpty() ){
+			continue;
+		}
+
+		if( previous_changes_sentence && tracker.opensWithCapital() ){
+			++offset;
+		}
+
+		add_shard(shard, offset);
+		offset += tracker.currentSentence() - 1;
+		previous_changes_sentence = tracker.endsWithSentenceChange();
+	}
+
+	sentence_tracker = SentenceTracker(offset + 1, previous_changes_sentence);
+
+	if( has_spilled ){
+		return joinParts(std::move(parts), std::move(part_offsets));
+	}
+
+	Concordance concordance = std::move(parts.front());
+	for( size_t part = 1; part < parts.size(); part++ ){
+		concordance.merge(std::move(parts[part]), part_offsets[part]);
+	}
+
+	return concordance;
+}
+
+//Parses a source which went through makeDecompressing already, so that it
+//is never decoded twice
+static Concordance parseDecodedSource(std::unique_ptr<ByteSource> source, const ParseOptions &options)
+{
+	std::optional<std::string_view> document = source->contiguousView();
+	size_t shard_count = document ? resolveShardCount(document->size(), options) : 1;
+
+	if( shard_count == 1 ){
+		DocumentReleaser document_releaser(source.get(), document.value_or(std::string_view()), options);
+		TextDocumentTraveller document_traveller(std::move(source), options.encoding, SourceDecoding::Decoded);
+		ParsedElementVisitor element_visitor(options);
+		parseDocument(document_traveller, element_visitor, document_releaser);
+
+		//Spilled runs number their sentences on from the ones before them
+		std::vector<Concordance> parts = element_visitor.takeParsedParts();
+		std::vector<Sentence> offsets(parts.size(), 0);
+		return joinParts(std::move(parts), std::move(offsets));
+	}
+
+	SentenceTracker sentence_tracker;
+	return parseInShards(*source, *document, shard_count, options, sentence_tracker);
+}
+
+//==========================================================================|
+//								SpilledFiles								|
+//==========================================================================|
+// @brief: Gathers the concordances of consecutive files under a memory		|
+//		   budget. Files which were spilled while parsed are kept as runs.	|
+//		   Consecutive files held in memory are merged and spilled			|
+//		   together once they outgrow half of the budget, or before a run,	|
+//		   so the parts stay in the order of their sentences and join		|
+//		   without being loaded												|
+//==========================================================================|
+class SpilledFiles
+{
+public:
+	SpilledFiles(const ParseOptions &options) : m_options(options) {}
+
+	void add(Concordance &&concordance, Sentence offset);
+	Concordance join();
+
+private:
+	void spillPending();
+
+private:
+	ParseOptions m_options;
+	std::vector<Concordance> m_parts;
+	std::vector<Sentence> m_part_offsets;
+	std::vector<Concordance> m_pending;
+	Sentence m_pending_offset = 0;
+	size_t m_pending_memory = 0;
+};
+
+//Only a concordance read from runs holds words without taking memory for
+//them
+void SpilledFiles::add(Concordance &&concordance, Sentence offset)
+{
+	if( concordance.size() > 0 && concordance.memoryEstimate() == 0 ){
+		spillPending();
+		m_parts.push_back(std::move(concordance));
+		m_part_offsets.push_back(offset);
+		return;
+	}
+
+	if( m_pending.empty() ){
+		m_pending_offset = offset;
+	}
+
+	m_pending_memory += concordance.memoryEstimate();
+	m_pending.push_back(std::move(concordance));
+
+	if( m_pending_memory > m_options.max_memory / 2 ){
+		spillPending();
+	}
+}
+
+//Nothing was spilled at all when there are no parts yet, the files are
+//then merged in memory
+Concordance SpilledFiles::join()
+{
+	if( m_parts.empty() && m_pending.empty() ){
+		return Concordance::makeEmpty(m_options.engine);
+	}
+
+	if( m_parts.empty() ){
+		return Concordance::merge(std::move(m_pending));
+	}
+
+	spillPending();
+	return Concordance::merge(std::move(m_parts), std::move(m_part_offsets));
+}
+
+void SpilledFiles::spillPending()
+{
+	if( m_pending.empty() ){
+		return;
+	}
+
+	Concordance merged = Concordance::merge(std::move(m_pending));
+	std::optional<Concordance> run = spillRun(merged, m_options);
+
+	m_parts.push_back(run ? std::move(*run) : std::move(merged));
+	m_part_offsets.push_back(m_pending_offset);
+	m_pending.clear();
+	m_pending_memory = 0;
+}
+
+//Only the words a concordance would hold are counted, sanitized alike
+static void countWords(TextDocumentTraveller &document_traveller, TextEncoding encoding, HeavyHitters &heavy_hitters)
+{
+	std::array<Token, TokenBatchSize> tokens;
+	Word sanitized;
+
+	while( size_t count = document_traveller.next(tokens) ){
+		for( const Token &token : std::span(tokens).first(count) ){
+			if( token.isWord() && WordValidator::isValid(token.text(), encoding) ){
+				WordSanitizer::sanitize(token.text(), sanitized, encoding);
+				heavy_hitters.add(sanitized);
+			}
+		}
+	}
+}
+
+//A missing document, a directory or a regular file which cannot be read
+//leaves nothing to index. Other files, like pipes, are only found out by
+//reading them
+static bool isReadableDocument(const std::string &filepath)
+{
+	std::error_code error;
+	std::filesystem::file_status status = std::filesystem::status(filepath, error);
+
+	if( !std::filesystem::exists(status) || std::filesystem::is_directory(status) ){
+		return false;
+	}
+
+	return !std::filesystem::is_regular_file(status) || std::ifstream(filepath).is_open();
+}
+
+//FNV-1a over the bytes right before offset, and offset itself
+static uint64_t hashBoundary(std::string_view document, size_t offset)
+{
+	uint64_t hash = 14695981039346656037ull ^ offset;
+
+	for( char c : document.substr(offset - std::min(offset, BoundaryHashSize), std::min(offset, BoundaryHashSize)) ){
+		hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+	}
+
+	return hash;
+}
+
+//A document can be resumed when it still holds the bytes it was parsed up
+//to, unchanged as far as their fingerprint tells
+static bool isResumable(const std::optional<ConcordanceIndex::Checkpoint> &checkpoint, std::string_view document,
+						TextEncoding encoding)
+{
+	return checkpoint && checkpoint->encoding == encoding && checkpoint->document_offset <= document.size() &&
+		   checkpoint->boundary_hash == hashBoundary(document, checkpoint->document_offset);
+}
+
+//Past the last whitespace of document after begin, or begin when there is
+//none. The bytes after it may be a word still being written
+static size_t findResumableEnd(std::string_view document, size_t begin)
+{
+	for( size_t end = document.size(); end > begin; end-- ){
+		if( hasCharacterClass(document[end - 1], Whitespace) ){
+			return end;
+		}
+	}
+
+	return begin;
+}
+
+//Both are sorted, so the words of previous and appended are merged in one
+//pass. The lists of a word found in both are joined, the sentences of
+//appended always come after those of previous
+static bool writeUpdatedIndex(const ConcordanceIndex *previous, const Concordance &appended, const std::string &index_path,
+							  Sentence sentence_count, const ConcordanceIndex::Checkpoint &checkpoint)
+{
+	ConcordanceIndex::Writer writer;
+	size_t entry = 0;
+	size_t entry_count = previous ? previous->size() : 0;
+
+	auto copy_previous_before = [&](std::string_view word){
+		for( ; entry < entry_count && previous->word(entry) < word; entry++ ){
+			writer.add(previous->word(entry), previous->occurrences(entry));
+		}
+	};
+
+	appended.forEachWord([&](WordIndex, const Word &word, const Occurrences &occurrences){
+		copy_previous_before(word);
+
+		if( entry < entry_count && previous->word(entry) == word ){
+			Occurrences joined = previous->occurrences(entry++);
+			joined.append(occurrences);
+			writer.add(word, joined);
+		} else{
+			writer.add(word, occurrences);
+		}
+	});
+
+	for( ; entry < entry_count; entry++ ){
+		writer.add(previous->word(entry), previous->occurrences(entry));
+	}
+
+	return writer.write(index_path, sentence_count, checkpoint);
+}
+
+}
+//END OF INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+
+
+//INTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//							Concordance::Impl								|
+//==========================================================================|
+Concordance::Impl::Impl(ConcordanceEngine engine) : m_engine(engine)
+{
+}
+
+Concordance::Impl::Impl(ConcordanceEngine engine, std::shared_ptr<const ConcordanceRuns> runs)
+	: m_engine(engine), m_sentence_count(runs->sentenceCount()), m_runs(std::move(runs))
+{
+}
+
+size_t Concordance::Impl::size() const
+{
+	if( m_runs ){
+		return m_runs->size();
+	}
+
+	switch( m_engine ){
+	case ConcordanceEngine::Hash:
+		return m_hashed_words.size();
+	case ConcordanceEngine::RadixTrie:
+		return m_trie_words.size();
+	default:
+		return m_ordered_words.size();
+	}
+}
+
+//Compared word by word, so concordances built by different engines compare
+//equal when they hold the same words
+bool Concordance::Impl::equalsWith(const Concordance::Impl &other) const
+{
+	if( size() != other.size() ){
+		return false;
+	}
+
+	bool equal = true;
+	forEachUnordered(*this, [&other, &equal](std::string_view word, const Occurrences &occurrences){
+		equal = equal && other.holds(word, occurrences);
+	});
+
+	return equal;
+}
+
+bool Concordance::Impl::exists(std::string_view word)
+{
+	if( m_runs ){
+		return m_runs->exists(word);
+	}
+
+	return find(word) != nullptr;
+}
+
+std::optional<Occurrences> Concordance::Impl::lookup(std::string_view word) const
+{
+	if( m_runs ){
+		return m_runs->lookup(word);
+	}
+
+	const Occurrences *occurrences = find(word);
+	return occurrences ? std::optional(*occurrences) : std::nullopt;
+}
+
+//A min heap of the k best ranked words so far, the worst of them on top.
+//Runs hand out their counts without decoding a single list
+std::vector<WordCount> Concordance::Impl::topWords(size_t k) const
+{
+	std::vector<WordCount> heap;
+
+	auto offer = [&heap, k](std::string_view word, size_t count){
+		if( heap.size() < k ){
+			heap.push_back(WordCount{Word(word), count, 0});
+			std::push_heap(heap.begin(), heap.end(), ranksBefore);
+		} else if( k && (count > heap.front().count || (count == heap.front().count && word < heap.front().word)) ){
+			std::pop_heap(heap.begin(), heap.end(), ranksBefore);
+			heap.back() = WordCount{Word(word), count, 0};
+			std::push_heap(heap.begin(), heap.end(), ranksBefore);
+		}
+	};
+
+	if( m_runs ){
+		m_runs->forEachCount(offer);
+	} else{
+		forEachUnordered(*this, [&offer](std::string_view word, const Occurrences &occurrences){
+			offer(word, occurrences.size());
+		});
+	}
+
+	std::sort_heap(heap.begin(), heap.end(), ranksBefore);
+	return heap;
+}
+
+//A new word costs its bytes and the bookkeeping around it, an occurrence
+//about the bytes its gap is encoded in
+void Concordance::Impl::addOccurrence(std::string_view word, Sentence sentence)
+{
+	loadRuns();
+	Occurrences &occurrences = findOrInsert(word);
+
+	if( occurrences.empty() ){
+		m_memory_estimate += word.size() + WordMemoryOverhead;
+	} else{
+		for( Sentence gap = sentence - occurrences.back(); gap; gap >>= 7 ){
+			++m_memory_estimate;
+		}
+	}
+
+	occurrences << sentence;
+	m_sentence_count = std::max(m_sentence_count, sentence);
+}
+
+//Costs like adding the occurrences one by one, with the list taken as the
+//bytes it is encoded in. An empty list adds nothing, not even its word
+void Concordance::Impl::addOccurrences(std::string_view word, Occurrences &&occurrences)
+{
+	if( occurrences.empty() ){
+		return;
+	}
+
+	loadRuns();
+	Occurrences &existing = findOrInsert(word);
+	m_sentence_count = std::max(m_sentence_count, occurrences.back());
+	m_memory_estimate += occurrences.encodedSize();
 
+	if( existing.empty() ){
+		m_memory_estimate += word.size() + WordMemoryOverhead;
+		existing = std::move(occurrences);
+		return;
+	}
 
-//INTERNAL CLASS DECLARATIONS
-//==========================================================================|
-//							Concordance::Impl								|
-//==========================================================================|
-class Concordance::Impl
+	for( Sentence sentence : occurrences ){
+		existing << sentence;
+	}
+}
+
+void Concordance::Impl::forEachWord(const IteratorFunc &run_callback) const
 {
-public:
-	size_t size() const;
-	bool equalsWith(const Concordance::Impl &other) const;
-	bool exists(const Word &word);
-	void addOccurrence(const Word &word, Sentence sentence);
-	void forEachWord(const IteratorFunc &run_callback) const;
+	WordIndex index = 1;
 
-private:
-	std::map<Word, Occurrences> m_concordance;
-};
-//END OF INTERNAL CLASS DECLARATIONS`
+	if( m_runs ){
+		forEachRunMatch(std::string_view(), [](std::string_view){ return true; }, run_callback);
+		return;
+	}
 
+	if( m_engine == ConcordanceEngine::Hash ){
+		//The only point where the hashed words are put in order. Words are
+		//handed out through one reused buffer, not copied one by one
+		Word word;
+		for( WordId id : m_hashed_words.sortedIds() ){
+			word.assign(m_hashed_words.word(id));
+			run_callback(index++, word, m_hashed_words.occurrences(id));
+		}
+		return;
+	}
 
-//INTERNAL AUXILIARY CLASSES AND FUNCTIONS
-namespace
+	if( m_engine == ConcordanceEngine::RadixTrie ){
+		m_trie_words.forEachWord(visitTrieWords(run_callback));
+		return;
+	}
+
+	for( const auto &pair : m_ordered_words ){
+		const Word &word = pair.first;
+		const Occurrences &occurrences = pair.second;
+		run_callback(index++, word, occurrences);
+	}
+}
+
+//Matches are indexed from 1 in alphabetical order. The map and the trie
+//only visit the words around the match, a hashed concordance checks every
+//word and sorts the matches
+void Concordance::Impl::forEachWithPrefix(std::string_view prefix, const IteratorFunc &run_callback) const
+{
+	if( m_runs ){
+		forEachRunMatch(prefix, [prefix](std::string_view word){ return word.starts_with(prefix); }, run_callback);
+		return;
+	}
+
+	if( m_engine == ConcordanceEngine::Hash ){
+		forEachHashedMatch([prefix](std::string_view word){ return word.starts_with(prefix); }, run_callback);
+		return;
+	}
+
+	if( m_engine == ConcordanceEngine::RadixTrie ){
+		m_trie_words.forEachWithPrefix(prefix, visitTrieWords(run_callback));
+		return;
+	}
+
+	WordIndex index = 1;
+	for( auto position = m_ordered_words.lower_bound(prefix); position != m_ordered_words.end() && position->first.starts_with(prefix); ++position ){
+		run_callback(index++, position->first, position->second);
+	}
+}
+
+void Concordance::Impl::forEachInRange(std::string_view first, std::string_view last, const IteratorFunc &run_callback) const
 {
+	if( m_runs ){
+		forEachRunMatch(first, [last](std::string_view word){ return word < last; }, run_callback);
+		return;
+	}
 
-static bool isAbbreviation(const Word &word)
+	if( m_engine == ConcordanceEngine::Hash ){
+		forEachHashedMatch([first, last](std::string_view word){ return first <= word && word < last; }, run_callback);
+		return;
+	}
+
+	if( m_engine == ConcordanceEngine::RadixTrie ){
+		m_trie_words.forEachInRange(first, last, visitTrieWords(run_callback));
+		return;
+	}
+
+	WordIndex index = 1;
+	for( auto position = m_ordered_words.lower_bound(first); position != m_ordered_words.end() && position->first < last; ++position ){
+		run_callback(index++, position->first, position->second);
+	}
+}
+
+Sentence Concordance::Impl::sentenceCount() const
 {
-	return std::count(word.begin(), word.end(), '.') > 1;
+	return m_sentence_count;
 }
 
-static bool changesSentence(const DocumentElement &element)
+size_t Concordance::Impl::memoryEstimate() const
 {
-	const Symbol *symbol = std::get_if<Symbol>(&element);
-	return symbol ? changesSentence(*symbol) : false;
+	return m_memory_estimate;
 }
 
-static bool startsWithCapital(const Word &word)
+ConcordanceEngine Concordance::Impl::engine() const
 {
-	return word.size() ? std::isupper(static_cast<unsigned char>(word.front())) : false;
+	return m_engine;
 }
 
-class ParsedElementVisitor
+//A merge join while both sides are sorted: the words of other come in
+//order, so the position of each in the map is only ever searched forward
+//from the one before it. A hashed concordance has no order to walk and a
+//trie finds a word in a single descent, both join with one lookup per
+//word of other instead. Other is consumed when it is passed as an rvalue
+template <typename Source>
+void Concordance::Impl::merge(Source &&other, Sentence offset)
 {
-public:
-	ParsedElementVisitor();
+	auto append = [offset](Occurrences &target, auto &occurrences){
+		appendShifted(target, std::move(occurrences), offset);
+	};
 
-	void operator()(const Word &word);
-	void operator()(const Symbol &symbol);
+	loadRuns();
 
-	const Concordance &getParsedConcordance() const;
+	if( m_engine != ConcordanceEngine::OrderedMap ){
+		forEachUnordered(other, [this, &append](std::string_view word, auto &occurrences){
+			append(findOrInsert(word), occurrences);
+		});
+	} else{
+		auto position = m_ordered_words.begin();
 
-private:
-	Concordance m_concordance;
-	DocumentElement m_previous_element;
-	Sentence m_current_sentence = 1;
-};
+		forEachSorted(other, [this, &append, &position](std::string_view word, auto &occurrences){
+			while( position != m_ordered_words.end() && position->first < word ){
+				++position;
+			}
 
-ParsedElementVisitor::ParsedElementVisitor() : m_concordance( Concordance::makeEmpty() )
-{
+			if( position == m_ordered_words.end() || position->first != word ){
+				position = m_ordered_words.emplace_hint(position, Word(word), Occurrences());
+			}
+
+			append(position->second, occurrences);
+		});
+	}
+
+	if( other.m_sentence_count ){
+		m_sentence_count = std::max(m_sentence_count, other.m_sentence_count + offset);
+	}
+
+	m_memory_estimate += other.m_memory_estimate;
 }
 
-void ParsedElementVisitor::operator()(const Word &word)
+//Merges the sorted words of every partial at once, always taking the
+//smallest word left through a heap. A word found in several partials is
+//appended in the order of the partials, and as the words come out sorted
+//every one of them is inserted at the end of the map. Any other target
+//rather joins the partials one after the other, so none of them has to be
+//sorted. The partials are consumed
+void Concordance::Impl::mergeAll(std::vector<Concordance::Impl *> partials, const std::vector<Sentence> &offsets)
 {
-	if( startsWithCapital(word) && changesSentence(m_previous_element) ){
-		++m_current_sentence;
+	if( joinsRuns(partials) ){
+		std::vector<ConcordanceRuns::Run> runs;
+
+		for( size_t partial = 0; partial < partials.size(); partial++ ){
+			if( partials[partial]->m_runs ){
+				for( const ConcordanceRuns::Run &run : partials[partial]->m_runs->runs() ){
+					runs.push_back(ConcordanceRuns::Run{run.index, run.offset + offsets[partial]});
+				}
+			}
+		}
+
+		m_runs = std::make_shared<ConcordanceRuns>(std::move(runs));
+		m_sentence_count = m_runs->sentenceCount();
+		return;
+	}
+
+	loadRuns();
+
+	for( const Concordance::Impl *partial : partials ){
+		m_memory_estimate += partial->m_memory_estimate;
+	}
+
+	if( !mergesThroughHeap(partials) ){
+		for( size_t partial = 0; partial < partials.size(); partial++ ){
+			merge(std::move(*partials[partial]), offsets[partial]);
+		}
+		return;
+	}
+
+	using Entry = std::pair<std::string_view, Occurrences *>;
+	std::vector< std::vector<Entry> > entries(partials.size());
+
+	for( size_t partial = 0; partial < partials.size(); partial++ ){
+		entries[partial].reserve(partials[partial]->size());
+		forEachSorted(*partials[partial], [&entries, partial](std::string_view word, Occurrences &occurrences){
+			entries[partial].emplace_back(word, &occurrences);
+		});
+
+		if( partials[partial]->m_sentence_count ){
+			m_sentence_count = std::max(m_sentence_count, partials[partial]->m_sentence_count + offsets[partial]);
+		}
 	}
 
-	m_concordance.add(word, m_current_sentence);
-	m_previous_element = word;
+	//Cursors are (partial, position) pairs, the heap keeps the smallest
+	//word on top and breaks ties by partial
+	using Cursor = std::pair<size_t, size_t>;
+	auto comes_after = [&entries](const Cursor &first, const Cursor &second){
+		std::string_view first_word = entries[first.first][first.second].first;
+		std::string_view second_word = entries[second.first][second.second].first;
+		return first_word != second_word ? first_word > second_word : first.first > second.first;
+	};
+
+	std::vector<Cursor> heap;
+	for( size_t partial = 0; partial < partials.size(); partial++ ){
+		if( !entries[partial].empty() ){
+			heap.emplace_back(partial, 0);
+		}
+	}
+	std::make_heap(heap.begin(), heap.end(), comes_after);
+
+	Occurrences *target = nullptr;
+	std::string_view target_word;
+
+	while( !heap.empty() ){
+		std::pop_heap(heap.begin(), heap.end(), comes_after);
+		auto [partial, position] = heap.back();
+		auto [word, occurrences] = entries[partial][position];
+
+		if( !target || word != target_word ){
+			target = &m_ordered_words.emplace_hint(m_ordered_words.end(), Word(word), Occurrences())->second;
+			target_word = word;
+		}
+		appendShifted(*target, std::move(*occurrences), offsets[partial]);
+
+		if( ++position < entries[partial].size() ){
+			heap.back().second = position;
+			std::push_heap(heap.begin(), heap.end(), comes_after);
+		} else{
+			heap.pop_back();
+		}
+	}
 }
 
-void ParsedElementVisitor::operator()(const Symbol &symbol)
+bool Concordance::Impl::save(const std::string &filepath) const
 {
-	m_previous_element = symbol;
+	ConcordanceIndex::Writer writer;
+
+	forEachSorted(*this, [&writer](std::string_view word, const Occurrences &occurrences){
+		writer.add(word, occurrences);
+	});
+
+	return writer.write(filepath, m_sentence_count);
 }
 
-const Concordance &ParsedElementVisitor::getParsedConcordance() const
+Occurrences &Concordance::Impl::findOrInsert(std::string_view word)
 {
-	return m_concordance;
-}
+	if( m_engine == ConcordanceEngine::Hash ){
+		return m_hashed_words.findOrInsert(word);
+	} else if( m_engine == ConcordanceEngine::RadixTrie ){
+		return m_trie_words.findOrInsert(word);
+	}
+
+	//The key is only materialized into a Word the first time it is seen
+	auto position = m_ordered_words.lower_bound(word);
 
+	if( position == m_ordered_words.end() || position->first != word ){
+		position = m_ordered_words.emplace_hint(position, Word(word), Occurrences());
+	}
+
+	return position->second;
 }
-//END OF INTERNAL AUXILIARY CLASSES AND FUNCTIONS
 
+const Occurrences *Concordance::Impl::find(std::string_view word) const
+{
+	if( m_engine == ConcordanceEngine::Hash ){
+		return m_hashed_words.find(word);
+	} else if( m_engine == ConcordanceEngine::RadixTrie ){
+		return m_trie_words.find(word);
+	}
 
-//INTERNAL CLASS DEFINITIONS
-//==========================================================================|
-//							Concordance::Impl								|
-//==========================================================================|
-size_t Concordance::Impl::size() const
+	auto position = m_ordered_words.find(word);
+	return position != m_ordered_words.end() ? &position->second : nullptr;
+}
+
+bool Concordance::Impl::holds(std::string_view word, const Occurrences &occurrences) const
 {
-	return m_concordance.size();
+	if( m_runs ){
+		std::optional<Occurrences> held = m_runs->lookup(word);
+		return held && *held == occurrences;
+	}
+
+	const Occurrences *held = find(word);
+	return held && *held == occurrences;
 }
 
-bool Concordance::Impl::equalsWith(const Concordance::Impl &other) const
+//The words come sorted, so they are inserted at the end of the map
+void Concordance::Impl::loadRuns()
 {
-	return m_concordance == other.m_concordance;
+	if( !m_runs ){
+		return;
+	}
+
+	std::shared_ptr<const ConcordanceRuns> runs = std::move(m_runs);
+
+	runs->forEachWord(std::string_view(), [](std::string_view){ return true; }, [this](std::string_view word, Occurrences &occurrences){
+		if( m_engine == ConcordanceEngine::OrderedMap ){
+			m_ordered_words.emplace_hint(m_ordered_words.end(), Word(word), std::move(occurrences));
+		} else{
+			findOrInsert(word) = std::move(occurrences);
+		}
+	});
 }
 
-bool Concordance::Impl::exists(const Word &word)
+//Runs are joined in the order of the partials, just like the lists of the
+//words they hold would be appended. This needs an empty target, and every
+//partial to be read from runs or be empty
+bool Concordance::Impl::joinsRuns(const std::vector<Concordance::Impl *> &partials) const
 {
-	return m_concordance.find(word) != m_concordance.end();
+	auto is_read_from_runs = [](const Concordance::Impl *partial){
+		return static_cast<bool>(partial->m_runs);
+	};
+
+	auto is_joinable = [](const Concordance::Impl *partial){
+		return partial->m_runs || partial->size() == 0;
+	};
+
+	return !m_runs && size() == 0 && std::any_of(partials.begin(), partials.end(), is_read_from_runs) &&
+		   std::all_of(partials.begin(), partials.end(), is_joinable);
 }
 
-void Concordance::Impl::addOccurrence(const Word &word, Sentence sentence)
+//The heap holds on to the words and lists of the partials while it merges
+//them. A trie hands its words out through a buffer which is reused, and
+//runs decode every list into a temporary
+bool Concordance::Impl::mergesThroughHeap(const std::vector<Concordance::Impl *> &partials) const
 {
-	Occurrences &word_occurrences = m_concordance[word];
-	word_occurrences << sentence;
+	auto is_transient = [](const Concordance::Impl *partial){
+		return partial->m_engine == ConcordanceEngine::RadixTrie || partial->m_runs;
+	};
+
+	return m_engine == ConcordanceEngine::OrderedMap && std::none_of(partials.begin(), partials.end(), is_transient);
 }
 
-void Concordance::Impl::forEachWord(const IteratorFunc &run_callback) const
+template <typename Predicate>
+void Concordance::Impl::forEachHashedMatch(Predicate &&matches, const IteratorFunc &run_callback) const
 {
-	WordIndex index = 1;
+	std::vector<WordId> ids;
+	for( WordId id = 0; id < m_hashed_words.size(); id++ ){
+		if( matches(m_hashed_words.word(id)) ){
+			ids.push_back(id);
+		}
+	}
 
-	for( const auto &pair : m_concordance ){
-		const Word &word = pair.first;
-		const Occurrences &occurrences = pair.second;
-		run_callback(index++, word, occurrences);
+	std::sort(ids.begin(), ids.end(), [this](WordId first, WordId second){
+		return m_hashed_words.word(first) < m_hashed_words.word(second);
+	});
+
+	WordIndex index = 1;
+	Word word;
+	for( WordId id : ids ){
+		word.assign(m_hashed_words.word(id));
+		run_callback(index++, word, m_hashed_words.occurrences(id));
 	}
 }
-//END OF INTERNAL CLASS DEFINITIONS
 
+//Runs are sorted, so the matches are the words from first on for which
+//matches holds
+void Concordance::Impl::forEachRunMatch(std::string_view first, const ConcordanceRuns::WordBound &matches,
+										const IteratorFunc &run_callback) const
+{
+	WordIndex index = 1;
+	Word word;
 
+	m_runs->forEachWord(first, matches, [&index, &word, &run_callback](std::string_view run_word, const Occurrences &occurrences){
+		word.assign(run_word);
+		run_callback(index++, word, occurrences);
+	});
+}
 
-//EXTERNAL CLASS DEFINITIONS
-//==========================================================================|
-//								Occurrences									|
-//==========================================================================|
-Occurrences &Occurrences::operator<<(Sentence sentence)
+RadixTrie::WordVisitor Concordance::Impl::visitTrieWords(const IteratorFunc &run_callback) const
 {
-	m_occurrences.push_back(sentence);
-	return *this;
+	return [this, &run_callback, index = WordIndex(1)](const Word &word, WordId id) mutable {
+		run_callback(index++, word, m_trie_words.occurrences(id));
+	};
 }
 
-bool Occurrences::operator==(const Occurrences &other) const
+//Self is either const or not, and so are the occurrences handed out
+template <typename Self, typename Function>
+void Concordance::Impl::forEachUnordered(Self &self, Function &&function)
 {
-	return m_occurrences == other.m_occurrences;
+	if( self.m_runs ){
+		forEachSorted(self, function);
+		return;
+	}
+
+	if( self.m_engine == ConcordanceEngine::Hash ){
+		for( WordId id = 0; id < self.m_hashed_words.size(); id++ ){
+			function(self.m_hashed_words.word(id), self.m_hashed_words.occurrences(id));
+		}
+		return;
+	}
+
+	if( self.m_engine == ConcordanceEngine::RadixTrie ){
+		self.m_trie_words.forEachWord([&self, &function](const Word &word, WordId id){
+			function(word, self.m_trie_words.occurrences(id));
+		});
+		return;
+	}
+
+	for( auto &[word, occurrences] : self.m_ordered_words ){
+		function(word, occurrences);
+	}
 }
 
-const std::vector<Sentence> &Occurrences::get() const
+template <typename Self, typename Function>
+void Concordance::Impl::forEachSorted(Self &self, Function &&function)
 {
-	return m_occurrences;
+	//Every list of the runs is decoded into a temporary, which may be
+	//consumed whatever self is
+	if( self.m_runs ){
+		self.m_runs->forEachWord(std::string_view(), [](std::string_view){ return true; }, [&function](std::string_view word, Occurrences &occurrences){
+			function(word, occurrences);
+		});
+		return;
+	}
+
+	if( self.m_engine == ConcordanceEngine::Hash ){
+		for( WordId id : self.m_hashed_words.sortedIds() ){
+			function(self.m_hashed_words.word(id), self.m_hashed_words.occurrences(id));
+		}
+		return;
+	}
+
+	if( self.m_engine == ConcordanceEngine::RadixTrie ){
+		self.m_trie_words.forEachWord([&self, &function](const Word &word, WordId id){
+			function(word, self.m_trie_words.occurrences(id));
+		});
+		return;
+	}
+
+	for( auto &[word, occurrences] : self.m_ordered_words ){
+		function(word, occurrences);
+	}
 }
+//END OF INTERNAL CLASS DEFINITIONS
+
 
+
+//EXTERNAL CLASS DEFINITIONS
 //==========================================================================|
 //								Concordance									|
 //==========================================================================|
@@ -164,9 +1342,9 @@ bool Concordance::operator!=(const Concordance &other) const
 	return !m_impl->equalsWith(*other.m_impl);
 }
 
-Concordance::Concordance()
+Concordance::Concordance(ConcordanceEngine engine)
 {
-	m_impl = std::make_unique<Impl>();
+	m_impl = std::make_unique<Impl>(engine);
 }
 
 Concordance::~Concordance()
@@ -209,27 +1387,50 @@ void Concordance::forEachWord(const IteratorFunc &run_callback) const
 	m_impl->forEachWord(run_callback);
 }
 
-void Concordance::add(const Word &word, const Sentence &sentence)
+void Concordance::forEachWithPrefix(std::string_view prefix, const IteratorFunc &run_callback) const
+{
+	m_impl->forEachWithPrefix(prefix, run_callback);
+}
+
+void Concordance::forEachInRange(std::string_view first, std::string_view last, const IteratorFunc &run_callback) const
+{
+	m_impl->forEachInRange(first, last, run_callback);
+}
+
+void Concordance::add(std::string_view word, const Sentence &sentence, TextEncoding encoding)
 {
-	if( WordValidator::isValid(word) ){
-		Word sanitized = WordSanitizer::sanitize(word);
+	if( WordValidator::isValid(word, encoding) ){
+		//Reused between calls, so sanitizing allocates only while the
+		//buffer grows to the longest word seen
+		thread_local Word sanitized;
+		WordSanitizer::sanitize(word, sanitized, encoding);
 		m_impl->addOccurrence(sanitized, sentence);
 	}
 }
 
-bool Concordance::exists(const Word &word) const
+bool Concordance::exists(std::string_view word) const
 {
 	return m_impl->exists(word);
 }
 
-Concordance Concordance::makeEmpty()
+std::optional<Occurrences> Concordance::lookup(std::string_view word) const
+{
+	return m_impl->lookup(word);
+}
+
+std::vector<WordCount> Concordance::topWords(size_t k) const
+{
+	return m_impl->topWords(k);
+}
+
+Concordance Concordance::makeEmpty(ConcordanceEngine engine)
 {
-	return Concordance();
+	return Concordance(engine);
 }
 
 Concordance Concordance::makeFromSentences(const std::vector< std::vector<Word> > &sentences)
 {
-	Concordance concordance;
+	Concordance concordance(ConcordanceEngine::Hash);
 	
 	size_t current_sentence = 1;
 
@@ -243,16 +1444,230 @@ Concordance Concordance::makeFromSentences(const std::vector< std::vector<Word>
 
 	return concordance;
 }
-Concordance Concordance::makeFromFile(const std::string &filepath)
+Concordance Concordance::makeFromFile(const std::string &filepath, const ParseOptions &options)
+{
+	return makeFromSource(ByteSource::makeFromFile(filepath), options);
+}
+
+Concordance Concordance::makeFromSource(std::unique_ptr<ByteSource> source, const ParseOptions &options)
+{
+	return parseDecodedSource(ByteSource::makeDecompressing(std::move(source)), options);
+}
+
+//Only the bytes after the checkpoint of the previous index are parsed, up
+//to the last whitespace of the document. A document which cannot be
+//resumed, or is not a regular uncompressed file, is parsed whole. One which
+//cannot be read leaves the index as it is
+std::optional<Concordance> Concordance::updateIndex(const std::string &filepath, const std::string &index_path,
+													const ParseOptions &options)
+{
+	if( !isReadableDocument(filepath) ){
+		return std::nullopt;
+	}
+
+	std::unique_ptr<ByteSource> source = ByteSource::makeDecompressing(ByteSource::makeFromFile(filepath));
+	std::optional<std::string_view> document = source->contiguousView();
+
+	if( !document ){
+		if( !parseDecodedSource(std::move(source), options).save(index_path) ){
+			return std::nullopt;
+		}
+
+		return open(index_path, options.engine);
+	}
+
+	ConcordanceIndex previous = ConcordanceIndex::makeFromFile(index_path);
+	bool resumes = previous.isValid() && isResumable(previous.checkpoint(), *document, options.encoding);
+	ConcordanceIndex::Checkpoint checkpoint = resumes ? *previous.checkpoint() : ConcordanceIndex::Checkpoint();
+
+	size_t parse_end = findResumableEnd(*document, checkpoint.document_offset);
+	std::string_view appended = document->substr(checkpoint.document_offset, parse_end - checkpoint.document_offset);
+	SentenceTracker sentence_tracker(checkpoint.sentence, checkpoint.changes_sentence);
+	Concordance concordance = parseInShards(*source, appended, resolveShardCount(appended.size(), options), options, sentence_tracker);
+
+	checkpoint.document_offset = parse_end;
+	checkpoint.boundary_hash = hashBoundary(*document, parse_end);
+	checkpoint.sentence = sentence_tracker.currentSentence();
+	checkpoint.changes_sentence = sentence_tracker.endsWithSentenceChange();
+	checkpoint.encoding = options.encoding;
+
+	Sentence sentence_count = std::max(resumes ? previous.sentenceCount() : 0, concordance.sentenceCount());
+	if( !writeUpdatedIndex(resumes ? &previous : nullptr, concordance, index_path, sentence_count, checkpoint) ){
+		return std::nullopt;
+	}
+
+	return open(index_path, options.engine);
+}
+
+//Shards are counted on threads of their own, their summaries are merged
+//once they are done. The source is decoded here only, to be split
+HeavyHitters Concordance::countFrequentWords(std::unique_ptr<ByteSource> source, size_t capacity, const ParseOptions &options)
+{
+	source = ByteSource::makeDecompressing(std::move(source));
+	std::optional<std::string_view> document = source->contiguousView();
+	size_t shard_count = document ? resolveShardCount(document->size(), options) : 1;
+
+	if( shard_count == 1 ){
+		HeavyHitters heavy_hitters(capacity);
+		TextDocumentTraveller document_traveller(std::move(source), options.encoding, SourceDecoding::Decoded);
+		countWords(document_traveller, options.encoding, heavy_hitters);
+		return heavy_hitters;
+	}
+
+	std::vector<std::string_view> shards = splitIntoShards(*document, shard_count);
+	std::vector<HeavyHitters> partials;
+	std::vector<std::thread> workers;
+
+	for( size_t shard = 0; shard < shards.size(); shard++ ){
+		partials.emplace_back(capacity);
+	}
+
+	auto count_shard = [&shards, &partials, &options](size_t shard){
+		TextDocumentTraveller document_traveller(ByteSource::makeFromView(shards[shard]), options.encoding, SourceDecoding::Decoded);
+		countWords(document_traveller, options.encoding, partials[shard]);
+	};
+
+	for( size_t shard = 1; shard < shards.size(); shard++ ){
+		workers.emplace_back(count_shard, shard);
+	}
+	count_shard(0);
+
+	for( std::thread &worker : workers ){
+		worker.join();
+	}
+
+	for( size_t shard = 1; shard < shards.size(); shard++ ){
+		partials.front().merge(partials[shard]);
+	}
+
+	return std::move(partials.front());
+}
+
+//Each batch of files is parsed by the pool, then merged in one pass and
+//appended after the batches before it. Every file gets a single thread, a
+//thread done with its share of the batch steals files from the others
+Concordance Concordance::makeFromFiles(const std::vector<std::string> &filepaths, const ParseOptions &options)
+{
+	if( filepaths.size() == 1 ){
+		return makeFromFile(filepaths.front(), options);
+	}
+
+	ParseOptions file_options = options;
+	file_options.shard_count = 1;
+
+	//Under a memory budget, half of it goes to the files being parsed, one
+	//per thread, and half to the files waiting to be spilled together
+	WorkStealingPool pool(options.shard_count);
+	size_t batch_capacity = options.max_memory ? pool.threadCount() : FileBatchSize;
+	file_options.max_memory = options.max_memory ? std::max<size_t>(options.max_memory / (2 * pool.threadCount()), 1) : 0;
+
+	Concordance concordance(options.engine);
+	Sentence offset = 0;
+	SpilledFiles spilled_files(options);
+
+	for( size_t batch_begin = 0; batch_begin < filepaths.size(); batch_begin += batch_capacity ){
+		size_t batch_size = std::min(batch_capacity, filepaths.size() - batch_begin);
+		std::vector<Concordance> partials(batch_size, Concordance(options.engine));
+
+		pool.run(batch_size, [&partials, &filepaths, &file_options, batch_begin](size_t file){
+			partials[file] = makeFromFile(filepaths[batch_begin + file], file_options);
+		});
+
+		if( options.max_memory ){
+			for( Concordance &partial : partials ){
+				Sentence partial_sentences = partial.sentenceCount();
+				spilled_files.add(std::move(partial), offset);
+				offset += partial_sentences;
+			}
+			continue;
+		}
+
+		Concordance batch = merge(std::move(partials));
+		Sentence batch_sentences = batch.sentenceCount();
+		concordance.merge(std::move(batch), offset);
+		offset += batch_sentences;
+	}
+
+	return options.max_memory ? spilled_files.join() : concordance;
+}
+
+void Concordance::merge(const Concordance &other, Sentence offset)
+{
+	if( this == &other ){
+		merge(Concordance(other), offset);
+		return;
+	}
+
+	//The pointer is const, not the Impl it points at
+	m_impl->merge(std::as_const(*other.m_impl), offset);
+}
+
+//An empty concordance takes over all of other when nothing has to be shifted
+void Concordance::merge(Concordance &&other, Sentence offset)
+{
+	if( this == &other ){
+		merge(Concordance(other), offset);
+		return;
+	}
+
+	if( m_impl->size() == 0 && offset == 0 && m_impl->engine() == other.m_impl->engine() ){
+		m_impl = std::move(other.m_impl);
+		return;
+	}
+
+	m_impl->merge(std::move(*other.m_impl), offset);
+}
+
+Concordance Concordance::merge(std::vector<Concordance> &&partials, std::vector<Sentence> offsets)
+{
+	ConcordanceEngine engine = partials.empty() ? ConcordanceEngine::Hash : partials.front().m_impl->engine();
+	std::vector<Impl *> impls;
+
+	for( size_t partial = 0; partial < partials.size(); partial++ ){
+		impls.push_back(partials[partial].m_impl.get());
+
+		if( partial == offsets.size() ){
+			offsets.push_back(partial == 0 ? 0 : offsets[partial - 1] + impls[partial - 1]->sentenceCount());
+		}
+	}
+
+	Concordance concordance(engine);
+	concordance.m_impl->mergeAll(std::move(impls), offsets);
+	partials.clear();
+	return concordance;
+}
+
+Sentence Concordance::sentenceCount() const
+{
+	return m_impl->sentenceCount();
+}
+
+size_t Concordance::memoryEstimate() const
+{
+	return m_impl->memoryEstimate();
+}
+
+bool Concordance::save(const std::string &filepath) const
+{
+	return m_impl->save(filepath);
+}
+
+std::optional<Concordance> Concordance::open(const std::string &filepath, ConcordanceEngine engine, MappedAccess access)
 {
-	TextDocumentTraveller document_traveller(filepath);
-	ParsedElementVisitor element_visitor;
+	auto index = std::make_shared<ConcordanceIndex>(ConcordanceIndex::makeFromFile(filepath, access));
 
-	while( document_traveller.hasNext() ){
-		DocumentElement element = document_traveller.getNext();
-		std::visit(element_visitor, element);
+	if( !index->isValid() ){
+		return std::nullopt;
 	}
-	return element_visitor.getParsedConcordance();
+
+	Concordance concordance(engine);
+	concordance.m_impl = std::make_unique<Impl>(engine, std::make_shared<ConcordanceRuns>(std::vector<ConcordanceRuns::Run>{{std::move(index), 0}}));
+	return concordance;
+}
+
+void Concordance::addOccurrences(std::string_view word, Occurrences &&occurrences)
+{
+	m_impl->addOccurrences(word, std::move(occurrences));
 }
 //END OF EXTERNAL CLASS DEFINITIONS
 
@@ -0,0 +1,368 @@
+#include "ConcordanceIndex.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+static constexpr char IndexMagic[8] = {'C', 'O', 'N', 'C', 'I', 'D', 'X', '\0'};
+
+//Written in the byte order of the machine, which reads it back as this
+//value only when its byte order is the same
+static constexpr uint32_t ByteOrderMark = 0x01020304;
+
+static constexpr uint32_t HasCheckpointFlag = 1 << 0;
+static constexpr uint32_t ChangesSentenceFlag = 1 << 1;
+static constexpr uint32_t Utf8Flag = 1 << 2;
+
+//INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+namespace
+{
+
+//==========================================================================|
+//								IndexHeader									|
+//==========================================================================|
+// @brief: First bytes of an index. Offsets count from the start of the		|
+//		   file, the blocks follow each other in the order of their offsets.|
+//		   The checkpoint fields only hold when HasCheckpointFlag is set	|
+//==========================================================================|
+struct IndexHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order;
+	uint64_t word_count;
+	uint64_t sentence_count;
+	uint64_t entries_offset;
+	uint64_t words_offset;
+	uint64_t postings_offset;
+	uint64_t file_size;
+	uint64_t document_offset;
+	uint64_t boundary_hash;
+	uint64_t document_sentence;
+	uint32_t checkpoint_flags;
+	uint32_t reserved;
+};
+
+//Plain structs are copied in and out of the mapping byte by byte, it gives
+//no guarantee about their alignment
+template <typename Plain>
+static void appendPlain(std::string &bytes, const Plain &plain)
+{
+	bytes.append(reinterpret_cast<const char *>(&plain), sizeof(plain));
+}
+
+template <typename Plain>
+static Plain readPlain(std::string_view bytes, size_t offset)
+{
+	Plain plain;
+	std::memcpy(&plain, bytes.data() + offset, sizeof(plain));
+	return plain;
+}
+
+static void storeCheckpoint(IndexHeader &header, const ConcordanceIndex::Checkpoint &checkpoint)
+{
+	header.document_offset = checkpoint.document_offset;
+	header.boundary_hash = checkpoint.boundary_hash;
+	header.document_sentence = checkpoint.sentence;
+	header.checkpoint_flags = HasCheckpointFlag;
+
+	if( checkpoint.changes_sentence ){
+		header.checkpoint_flags |= ChangesSentenceFlag;
+	}
+
+	if( checkpoint.encoding == TextEncoding::Utf8 ){
+		header.checkpoint_flags |= Utf8Flag;
+	}
+}
+
+static std::optional<ConcordanceIndex::Checkpoint> loadCheckpoint(const IndexHeader &header)
+{
+	if( !(header.checkpoint_flags & HasCheckpointFlag) ){
+		return std::nullopt;
+	}
+
+	ConcordanceIndex::Checkpoint checkpoint;
+	checkpoint.document_offset = header.document_offset;
+	checkpoint.boundary_hash = header.boundary_hash;
+	checkpoint.sentence = header.document_sentence;
+	checkpoint.changes_sentence = header.checkpoint_flags & ChangesSentenceFlag;
+	checkpoint.encoding = header.checkpoint_flags & Utf8Flag ? TextEncoding::Utf8 : TextEncoding::Ascii;
+	return checkpoint;
+}
+
+static bool isValidHeader(const IndexHeader &header, size_t file_size, size_t entry_size)
+{
+	bool is_index = std::equal(std::begin(IndexMagic), std::end(IndexMagic), header.magic) &&
+					header.version == ConcordanceIndex::Version && header.byte_order == ByteOrderMark;
+
+	return is_index && header.file_size == file_size && header.entries_offset == sizeof(IndexHeader) &&
+		   header.word_count < file_size / entry_size &&
+		   header.words_offset == header.entries_offset + (header.word_count + 1) * entry_size &&
+		   header.words_offset <= header.postings_offset && header.postings_offset <= file_size;
+}
+
+}
+//END OF INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+
+
+//EXTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//							ConcordanceIndex::Writer						|
+//==========================================================================|
+ConcordanceIndex::Writer::Writer(size_t buffer_size) : m_buffer_size(std::max<size_t>(buffer_size, 1))
+{
+}
+
+void ConcordanceIndex::Writer::add(std::string_view word, const Occurrences &occurrences)
+{
+	Entry entry{m_words.size(), m_postings.size(), occurrences.back(), word.size(), occurrences.size()};
+
+	appendPlain(m_entries.bytes, entry);
+	m_words.bytes.append(word);
+	m_postings.bytes.append(occurrences.encodeGaps());
+	++m_word_count;
+
+	for( Block *block : {&m_entries, &m_words, &m_postings} ){
+		spillIfFull(*block);
+	}
+}
+
+bool ConcordanceIndex::Writer::write(const std::string &filepath, Sentence sentence_count,
+									 const std::optional<Checkpoint> &checkpoint) const
+{
+	IndexHeader header{};
+	std::copy(std::begin(IndexMagic), std::end(IndexMagic), header.magic);
+	header.version = Version;
+	header.byte_order = ByteOrderMark;
+	header.word_count = m_word_count;
+	header.sentence_count = sentence_count;
+	header.entries_offset = sizeof(IndexHeader);
+	header.words_offset = header.entries_offset + m_entries.size() + sizeof(Entry);
+	header.postings_offset = header.words_offset + m_words.size();
+	header.file_size = header.postings_offset + m_postings.size();
+
+	if( checkpoint ){
+		storeCheckpoint(header, *checkpoint);
+	}
+
+	std::string head;
+	appendPlain(head, header);
+	std::string end_entry;
+	appendPlain(end_entry, Entry{m_words.size(), m_postings.size(), 0, 0, 0});
+
+	//Mappings of the replaced file keep viewing its old contents
+	std::string temp_filepath = filepath + ".partial";
+	std::ofstream out(temp_filepath, std::ios::binary | std::ios::trunc);
+	out.write(head.data(), static_cast<std::streamsize>(head.size()));
+	bool written = !m_failed && copyBlock(m_entries, out);
+	out.write(end_entry.data(), static_cast<std::streamsize>(end_entry.size()));
+	written = written && copyBlock(m_words, out) && copyBlock(m_postings, out);
+
+	written = written && static_cast<bool>(out.flush());
+	out.close();
+
+	if( !written || std::rename(temp_filepath.c_str(), filepath.c_str()) != 0 ){
+		std::remove(temp_filepath.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+uint64_t ConcordanceIndex::Writer::Block::size() const
+{
+	return spilled_size + bytes.size();
+}
+
+//Without a temporary file the block simply stays in memory
+void ConcordanceIndex::Writer::spillIfFull(Block &block)
+{
+	if( block.bytes.size() < m_buffer_size ){
+		return;
+	}
+
+	if( !block.spilled ){
+		block.spilled.reset(std::tmpfile());
+
+		if( !block.spilled ){
+			return;
+		}
+	}
+
+	if( std::fwrite(block.bytes.data(), 1, block.bytes.size(), block.spilled.get()) != block.bytes.size() ){
+		m_failed = true;
+	}
+
+	block.spilled_size += block.bytes.size();
+	block.bytes.clear();
+}
+
+//The spilled part of the block is read back from the start, the part still
+//in memory follows it
+bool ConcordanceIndex::Writer::copyBlock(const Block &block, std::ostream &out) const
+{
+	if( block.spilled ){
+		std::FILE *spilled = block.spilled.get();
+		char buffer[1 << 16];
+		uint64_t copied = 0;
+
+		if( std::fflush(spilled) != 0 || std::fseek(spilled, 0, SEEK_SET) != 0 ){
+			return false;
+		}
+
+		while( size_t read = std::fread(buffer, 1, sizeof(buffer), spilled) ){
+			out.write(buffer, static_cast<std::streamsize>(read));
+			copied += read;
+		}
+
+		//Later blocks are appended at the end again
+		std::fseek(spilled, 0, SEEK_END);
+
+		if( copied != block.spilled_size ){
+			return false;
+		}
+	}
+
+	out.write(block.bytes.data(), static_cast<std::streamsize>(block.bytes.size()));
+	return static_cast<bool>(out);
+}
+
+//==========================================================================|
+//							  ConcordanceIndex								|
+//==========================================================================|
+ConcordanceIndex ConcordanceIndex::makeFromFile(const std::string &filepath, MappedAccess access)
+{
+	ConcordanceIndex index;
+	index.m_file = MemoryMappedFile::makeFromFile(filepath, access);
+	index.m_access = access;
+	std::string_view bytes = index.m_file.view();
+
+	if( bytes.size() < sizeof(IndexHeader) ){
+		return index;
+	}
+
+	IndexHeader header = readPlain<IndexHeader>(bytes, 0);
+	if( !isValidHeader(header, bytes.size(), sizeof(Entry)) ){
+		return index;
+	}
+
+	index.m_entries = bytes.substr(header.entries_offset, header.words_offset - header.entries_offset);
+	index.m_words = bytes.substr(header.words_offset, header.postings_offset - header.words_offset);
+	index.m_postings = bytes.substr(header.postings_offset);
+	index.m_size = header.word_count;
+	index.m_sentence_count = header.sentence_count;
+	index.m_checkpoint = loadCheckpoint(header);
+	index.m_valid = true;
+	return index;
+}
+
+bool ConcordanceIndex::isValid() const
+{
+	return m_valid;
+}
+
+size_t ConcordanceIndex::size() const
+{
+	return m_size;
+}
+
+Sentence ConcordanceIndex::sentenceCount() const
+{
+	return m_sentence_count;
+}
+
+const std::optional<ConcordanceIndex::Checkpoint> &ConcordanceIndex::checkpoint() const
+{
+	return m_checkpoint;
+}
+
+size_t ConcordanceIndex::find(std::string_view word) const
+{
+	size_t entry = lowerBound(word);
+	return entry < m_size && this->word(entry) == word ? entry : NoEntry;
+}
+
+//Binary search over the entries, the index of the first word not less
+//than word, or size
+size_t ConcordanceIndex::lowerBound(std::string_view word) const
+{
+	size_t first = 0;
+	size_t count = m_size;
+
+	while( count > 0 ){
+		size_t half = count / 2;
+
+		if( this->word(first + half) < word ){
+			first += half + 1;
+			count -= half + 1;
+		} else{
+			count = half;
+		}
+	}
+
+	return first;
+}
+
+//Entries pointing outside of their block read as empty, so a damaged index
+//never reads past its mapping
+std::string_view ConcordanceIndex::word(size_t entry) const
+{
+	Entry read = readEntry(entry);
+
+	if( read.word_offset > m_words.size() || read.word_size > m_words.size() - read.word_offset ){
+		return std::string_view();
+	}
+
+	return m_words.substr(read.word_offset, read.word_size);
+}
+
+size_t ConcordanceIndex::occurrenceCount(size_t entry) const
+{
+	return readEntry(entry).occurrence_count;
+}
+
+Occurrences ConcordanceIndex::occurrences(size_t entry) const
+{
+	Entry read = readEntry(entry);
+	uint64_t postings_end = readEntry(entry + 1).postings_offset;
+
+	if( read.postings_offset > postings_end || postings_end > m_postings.size() ){
+		return Occurrences();
+	}
+
+	std::string_view gaps = m_postings.substr(read.postings_offset, postings_end - read.postings_offset);
+	if( !gaps.empty() && (static_cast<unsigned char>(gaps.back()) & 0x80) ){
+		return Occurrences();
+	}
+
+	return Occurrences::makeFromGaps(gaps, read.last);
+}
+
+//Each block is read front to back by a pass, so what lies before the
+//entry, its word and its list has been read for the entries before it
+//Only whole pages are released, the ones straddling first or last are left
+//to the passes reading on
+void ConcordanceIndex::release(size_t first, size_t last) const
+{
+	if( m_access != MappedAccess::Sequential || first >= last || last > m_size ){
+		return;
+	}
+
+	auto between = [](std::string_view block, uint64_t begin, uint64_t end){
+		begin = std::min<uint64_t>(begin, block.size());
+		return block.substr(begin, std::min<uint64_t>(std::max(begin, end), block.size()) - begin);
+	};
+
+	Entry first_read = readEntry(first);
+	Entry last_read = readEntry(last);
+	m_file.release(m_entries.substr(first * sizeof(Entry), (last - first) * sizeof(Entry)));
+	m_file.release(between(m_words, first_read.word_offset, last_read.word_offset));
+	m_file.release(between(m_postings, first_read.postings_offset, last_read.postings_offset));
+}
+
+ConcordanceIndex::Entry ConcordanceIndex::readEntry(size_t entry) const
+{
+	return readPlain<Entry>(m_entries, entry * sizeof(Entry));
+}
+//END OF EXTERNAL CLASS DEFINITIONS
@@ -0,0 +1,179 @@
+#include "ConcordanceRuns.hpp"
+
+#include <algorithm>
+
+//Entries a pass goes through before releasing the pages behind it
+static constexpr size_t ReleaseInterval = 1 << 10;
+
+//INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+namespace
+{
+
+//A list is moved whenever it does not need to be shifted
+static void appendShifted(Occurrences &target, Occurrences &&source, Sentence offset)
+{
+	if( target.empty() && offset == 0 ){
+		target = std::move(source);
+		return;
+	}
+
+	target.append(source, offset);
+}
+
+static bool isAnyWord(std::string_view)
+{
+	return true;
+}
+
+}
+//END OF INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+
+
+//EXTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//							  ConcordanceRuns								|
+//==========================================================================|
+ConcordanceRuns::ConcordanceRuns(std::vector<Run> runs) : m_runs(std::move(runs))
+{
+	for( const Run &run : m_runs ){
+		if( run.index->sentenceCount() ){
+			m_sentence_count = std::max(m_sentence_count, run.index->sentenceCount() + run.offset);
+		}
+	}
+
+	if( m_runs.size() == 1 ){
+		m_size = m_runs.front().index->size();
+		return;
+	}
+
+	forEachMerged(std::string_view(), isAnyWord, [this](std::string_view, const std::vector<Cursor> &){
+		++m_size;
+	});
+}
+
+size_t ConcordanceRuns::size() const
+{
+	return m_size;
+}
+
+Sentence ConcordanceRuns::sentenceCount() const
+{
+	return m_sentence_count;
+}
+
+const std::vector<ConcordanceRuns::Run> &ConcordanceRuns::runs() const
+{
+	return m_runs;
+}
+
+bool ConcordanceRuns::exists(std::string_view word) const
+{
+	return std::any_of(m_runs.begin(), m_runs.end(), [word](const Run &run){
+		return run.index->find(word) != ConcordanceIndex::NoEntry;
+	});
+}
+
+std::optional<Occurrences> ConcordanceRuns::lookup(std::string_view word) const
+{
+	std::optional<Occurrences> joined;
+
+	for( const Run &run : m_runs ){
+		size_t entry = run.index->find(word);
+
+		if( entry != ConcordanceIndex::NoEntry ){
+			appendShifted(joined ? *joined : joined.emplace(), run.index->occurrences(entry), run.offset);
+		}
+	}
+
+	return joined;
+}
+
+void ConcordanceRuns::forEachWord(std::string_view first, const WordBound &within, const WordVisitor &visit) const
+{
+	forEachMerged(first, within, [this, &visit](std::string_view word, const std::vector<Cursor> &cursors){
+		Occurrences joined;
+
+		for( auto [run, entry] : cursors ){
+			appendShifted(joined, m_runs[run].index->occurrences(entry), m_runs[run].offset);
+		}
+
+		visit(word, joined);
+	});
+}
+
+void ConcordanceRuns::forEachCount(const CountVisitor &visit) const
+{
+	forEachMerged(std::string_view(), isAnyWord, [this, &visit](std::string_view word, const std::vector<Cursor> &cursors){
+		size_t count = 0;
+
+		for( auto [run, entry] : cursors ){
+			count += m_runs[run].index->occurrenceCount(entry);
+		}
+
+		visit(word, count);
+	});
+}
+
+//The heap holds one cursor per run, keeps the smallest word on top and
+//breaks ties by run, so the entries of a word are popped in run order.
+//Every run is read front to back, the pages of a Sequential one are
+//released behind its cursor as it moves on
+template <typename Function>
+void ConcordanceRuns::forEachMerged(std::string_view first, const WordBound &within, Function &&function) const
+{
+	auto word_of = [this](const Cursor &cursor){
+		return m_runs[cursor.first].index->word(cursor.second);
+	};
+
+	auto comes_after = [&word_of](const Cursor &first_cursor, const Cursor &second_cursor){
+		std::string_view first_word = word_of(first_cursor);
+		std::string_view second_word = word_of(second_cursor);
+		return first_word != second_word ? first_word > second_word : first_cursor.first > second_cursor.first;
+	};
+
+	auto is_visited = [this, &within, &word_of](const Cursor &cursor){
+		return cursor.second < m_runs[cursor.first].index->size() && within(word_of(cursor));
+	};
+
+	//Where the pass started in every run, the entries from there up to its
+	//cursor are done with
+	std::vector<size_t> starts(m_runs.size());
+	std::vector<Cursor> heap;
+	for( size_t run = 0; run < m_runs.size(); run++ ){
+		Cursor cursor(run, first.empty() ? 0 : m_runs[run].index->lowerBound(first));
+		starts[run] = cursor.second;
+
+		if( is_visited(cursor) ){
+			heap.push_back(cursor);
+		}
+	}
+	std::make_heap(heap.begin(), heap.end(), comes_after);
+
+	std::vector<Cursor> cursors;
+
+	while( !heap.empty() ){
+		std::string_view word = word_of(heap.front());
+		cursors.clear();
+
+		while( !heap.empty() && word_of(heap.front()) == word ){
+			std::pop_heap(heap.begin(), heap.end(), comes_after);
+			cursors.push_back(heap.back());
+
+			Cursor &cursor = heap.back();
+			if( cursor.second % ReleaseInterval == 0 ){
+				m_runs[cursor.first].index->release(starts[cursor.first], cursor.second);
+			}
+			++cursor.second;
+
+			if( is_visited(cursor) ){
+				std::push_heap(heap.begin(), heap.end(), comes_after);
+			} else{
+				m_runs[cursor.first].index->release(starts[cursor.first], cursor.second - 1);
+				heap.pop_back();
+			}
+		}
+
+		function(word, cursors);
+	}
+}
+//END OF EXTERNAL CLASS DEFINITIONS
@@ -0,0 +1,804 @@
+#include "ConcordanceServer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include "WordSanitizer.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CONCORDANCE_HAS_UNIX_SOCKETS 1
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static constexpr size_t DefaultMaxThreadCount = 4;
+static constexpr size_t ReceiveBlockSize = 1 << 16;
+
+//A connection whose responses pile up past this is not read from until
+//its client takes them
+static constexpr size_t MaxPendingOutput = 1 << 22;
+
+//INTERNAL CLASS DECLARATIONS
+//==========================================================================|
+//							ConcordanceServer::Impl							|
+//==========================================================================|
+class ConcordanceServer::Impl
+{
+public:
+	Impl(const Concordance &concordance, TextEncoding encoding, size_t thread_count);
+	~Impl();
+
+	bool listen(const std::string &socket_path);
+	void stop();
+	std::optional<std::string> answer(std::string_view request) const;
+
+private:
+	struct Connection
+	{
+		int socket;
+		std::string input;
+		std::string output;
+	};
+
+	//Connections handed to a thread which it has yet to take, with the
+	//pipe waking it up to take them
+	struct Inbox
+	{
+		std::mutex mutex;
+		std::vector<int> sockets;
+		int wake_pipe[2] = {-1, -1};
+	};
+
+	void serve(size_t worker);
+	void acceptConnections(std::vector<Connection> &connections);
+	void handOver(int socket, std::vector<Connection> &connections);
+	void takeHandedOver(size_t worker, std::vector<Connection> &connections);
+	bool answerInto(std::string_view request, std::string &response) const;
+	bool receive(Connection &connection) const;
+	bool answerRequests(Connection &connection) const;
+	bool transmit(Connection &connection) const;
+
+private:
+	const Concordance &m_concordance;
+	TextEncoding m_encoding;
+	size_t m_thread_count;
+	std::string m_socket_path;
+	int m_listener = -1;
+	int m_stop_pipe[2] = {-1, -1};
+	std::vector<std::thread> m_workers;
+	std::vector< std::unique_ptr<Inbox> > m_inboxes;
+
+	//Only touched by the accepting thread
+	size_t m_next_worker = 0;
+};
+//END OF INTERNAL CLASS DECLARATIONS
+
+
+//INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+namespace
+{
+
+template <typename Plain>
+static void appendPlain(std::string &bytes, const Plain &plain)
+{
+	bytes.append(reinterpret_cast<const char *>(&plain), sizeof(plain));
+}
+
+//==========================================================================|
+//								FrameReader									|
+//==========================================================================|
+// @brief: Reads the fields of a request or a response one after the		|
+//		   other. Reading past the end invalidates the reader and yields	|
+//		   zeroes, so a truncated frame is only checked for once, at the	|
+//		   end																|
+//==========================================================================|
+class FrameReader
+{
+public:
+	FrameReader(std::string_view bytes) : m_bytes(bytes) {}
+
+	template <typename Plain>
+	Plain read()
+	{
+		Plain plain{};
+		std::string_view bytes = readBytes(sizeof(plain));
+
+		if( bytes.size() ){
+			std::memcpy(&plain, bytes.data(), bytes.size());
+		}
+		return plain;
+	}
+
+	std::string_view readBytes(size_t size)
+	{
+		if( size > m_bytes.size() - m_position ){
+			m_valid = false;
+			return std::string_view();
+		}
+
+		std::string_view bytes = m_bytes.substr(m_position, size);
+		m_position += size;
+		return bytes;
+	}
+
+	bool isValid() const { return m_valid; }
+	bool atEnd() const { return m_position == m_bytes.size(); }
+	size_t remaining() const { return m_bytes.size() - m_position; }
+
+private:
+	std::string_view m_bytes;
+	size_t m_position = 0;
+	bool m_valid = true;
+};
+
+//A word of an Exists result is sent without any sentences
+static void appendWord(std::string &response, std::string_view word, const Occurrences *occurrences)
+{
+	std::string gaps = occurrences ? occurrences->encodeGaps() : std::string();
+
+	appendPlain(response, static_cast<uint32_t>(word.size()));
+	response.append(word);
+	appendPlain(response, static_cast<uint64_t>(occurrences ? occurrences->back() : 0));
+	appendPlain(response, static_cast<uint32_t>(gaps.size()));
+	response.append(gaps);
+}
+
+static constexpr size_t MinWordSize = sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint32_t);
+
+//The count is checked against the bytes left before anything is allocated
+static std::optional<QueryResult> readResult(FrameReader &reader)
+{
+	uint32_t count = reader.read<uint32_t>();
+	if( !reader.isValid() || count > reader.remaining() / MinWordSize ){
+		return std::nullopt;
+	}
+
+	QueryResult result(count);
+
+	for( auto &[word, occurrences] : result ){
+		word = reader.readBytes(reader.read<uint32_t>());
+		Sentence last = reader.read<uint64_t>();
+		std::string_view gaps = reader.readBytes(reader.read<uint32_t>());
+
+		if( !reader.isValid() ){
+			return std::nullopt;
+		}
+
+		occurrences = Occurrences::makeFromGaps(gaps, last);
+	}
+
+	return result;
+}
+
+#ifdef CONCORDANCE_HAS_UNIX_SOCKETS
+static void closePipe(int (&pipe)[2])
+{
+	for( int &end : pipe ){
+		if( end >= 0 ){
+			::close(end);
+			end = -1;
+		}
+	}
+}
+
+static bool makeNonBlocking(int descriptor)
+{
+	int flags = ::fcntl(descriptor, F_GETFL, 0);
+	return flags >= 0 && ::fcntl(descriptor, F_SETFL, flags | O_NONBLOCK) == 0 &&
+		   ::fcntl(descriptor, F_SETFD, FD_CLOEXEC) == 0;
+}
+
+static bool makeSocketAddress(const std::string &socket_path, sockaddr_un &address)
+{
+	address = sockaddr_un{};
+	address.sun_family = AF_UNIX;
+
+	if( socket_path.empty() || socket_path.size() >= sizeof(address.sun_path) ){
+		return false;
+	}
+
+	std::copy(socket_path.begin(), socket_path.end(), address.sun_path);
+	return true;
+}
+
+//Only a socket is ever replaced, never a file given by mistake
+static void removeStaleSocket(const std::string &socket_path)
+{
+	struct stat status;
+	if( ::lstat(socket_path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode) ){
+		::unlink(socket_path.c_str());
+	}
+}
+
+static bool sendFully(int socket, std::string_view bytes)
+{
+	while( bytes.size() ){
+		ssize_t sent = ::send(socket, bytes.data(), bytes.size(), MSG_NOSIGNAL);
+
+		if( sent < 0 && errno == EINTR ){
+			continue;
+		} else if( sent <= 0 ){
+			return false;
+		}
+
+		bytes.remove_prefix(sent);
+	}
+
+	return true;
+}
+
+static bool receiveFully(int socket, char *buffer, size_t size)
+{
+	while( size ){
+		ssize_t received = ::recv(socket, buffer, size, 0);
+
+		if( received < 0 && errno == EINTR ){
+			continue;
+		} else if( received <= 0 ){
+			return false;
+		}
+
+		buffer += received;
+		size -= received;
+	}
+
+	return true;
+}
+#endif
+
+}
+//END OF INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+
+
+//INTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//							ConcordanceServer::Impl							|
+//==========================================================================|
+ConcordanceServer::Impl::Impl(const Concordance &concordance, TextEncoding encoding, size_t thread_count)
+	: m_concordance(concordance), m_encoding(encoding), m_thread_count(thread_count)
+{
+	if( m_thread_count == 0 ){
+		m_thread_count = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, DefaultMaxThreadCount);
+	}
+}
+
+ConcordanceServer::Impl::~Impl()
+{
+	stop();
+}
+
+bool ConcordanceServer::Impl::listen(const std::string &socket_path)
+{
+#ifdef CONCORDANCE_HAS_UNIX_SOCKETS
+	sockaddr_un address;
+	if( m_listener >= 0 || !makeSocketAddress(socket_path, address) ){
+		return false;
+	}
+
+	removeStaleSocket(socket_path);
+	int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+	//Accepting never blocks, so the first thread takes every connection
+	//waiting and goes back to polling
+	if( listener < 0 || !makeNonBlocking(listener) || ::bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+		::listen(listener, SOMAXCONN) != 0 || ::pipe(m_stop_pipe) != 0 ){
+		if( listener >= 0 ){
+			::close(listener);
+		}
+		return false;
+	}
+
+	for( size_t thread = 0; thread < m_thread_count; thread++ ){
+		auto inbox = std::make_unique<Inbox>();
+
+		if( ::pipe(inbox->wake_pipe) != 0 || !makeNonBlocking(inbox->wake_pipe[0]) || !makeNonBlocking(inbox->wake_pipe[1]) ){
+			closePipe(inbox->wake_pipe);
+			for( std::unique_ptr<Inbox> &created : m_inboxes ){
+				closePipe(created->wake_pipe);
+			}
+			m_inboxes.clear();
+			closePipe(m_stop_pipe);
+			::close(listener);
+			return false;
+		}
+
+		m_inboxes.push_back(std::move(inbox));
+	}
+
+	m_listener = listener;
+	m_socket_path = socket_path;
+
+	for( size_t thread = 0; thread < m_thread_count; thread++ ){
+		m_workers.emplace_back(&Impl::serve, this, thread);
+	}
+
+	return true;
+#else
+	(void)socket_path;
+	return false;
+#endif
+}
+
+//The stop pipe is never read from, so it wakes every thread for good
+void ConcordanceServer::Impl::stop()
+{
+#ifdef CONCORDANCE_HAS_UNIX_SOCKETS
+	if( m_listener < 0 ){
+		return;
+	}
+
+	char wake = 0;
+	while( ::write(m_stop_pipe[1], &wake, 1) < 0 && errno == EINTR ){
+	}
+
+	for( std::thread &worker : m_workers ){
+		worker.join();
+	}
+	m_workers.clear();
+
+	//Connections handed over to a thread which stopped first
+	for( std::unique_ptr<Inbox> &inbox : m_inboxes ){
+		for( int socket : inbox->sockets ){
+			::close(socket);
+		}
+		closePipe(inbox->wake_pipe);
+	}
+	m_inboxes.clear();
+
+	::close(m_listener);
+	closePipe(m_stop_pipe);
+	::unlink(m_socket_path.c_str());
+	m_listener = -1;
+#endif
+}
+
+std::optional<std::string> ConcordanceServer::Impl::answer(std::string_view request) const
+{
+	std::string response;
+
+	if( !answerInto(request, response) || response.size() > MaxResponseSize ){
+		return std::nullopt;
+	}
+
+	return response;
+}
+
+//Prefix results are counted while they are appended, their count is
+//written in front of them once they are all in. A response which outgrows
+//MaxResponseSize is never sent, so nothing more is appended to it. False
+//when the request is malformed
+bool ConcordanceServer::Impl::answerInto(std::string_view request, std::string &response) const
+{
+	FrameReader reader(request);
+	Word word;
+
+	while( !reader.atEnd() ){
+		QueryKind kind = static_cast<QueryKind>(reader.read<uint8_t>());
+		std::string_view text = reader.readBytes(reader.read<uint32_t>());
+
+		if( !reader.isValid() ){
+			return false;
+		}
+
+		WordSanitizer::sanitize(text, word, m_encoding);
+
+		switch( kind ){
+		case QueryKind::Lookup:
+			if( std::optional<Occurrences> occurrences = m_concordance.lookup(word) ){
+				appendPlain(response, uint32_t(1));
+				appendWord(response, word, &*occurrences);
+			} else{
+				appendPlain(response, uint32_t(0));
+			}
+			break;
+		case QueryKind::Prefix:{
+			size_t count_offset = response.size();
+			uint32_t count = 0;
+			appendPlain(response, count);
+
+			m_concordance.forEachWithPrefix(word, [&response, &count](WordIndex, const Word &match, const Occurrences &occurrences){
+				if( response.size() <= MaxResponseSize ){
+					appendWord(response, match, &occurrences);
+					++count;
+				}
+			});
+
+			std::memcpy(response.data() + count_offset, &count, sizeof(count));
+			break;
+		}
+		case QueryKind::Exists:
+			if( m_concordance.exists(word) ){
+				appendPlain(response, uint32_t(1));
+				appendWord(response, word, nullptr);
+			} else{
+				appendPlain(response, uint32_t(0));
+			}
+			break;
+		default:
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//Polls the stop pipe, the wake pipe of this thread, the connections of
+//this thread and, for the first thread only, the listening socket. The
+//listener comes last so that it is only polled once. Connections taken in
+//a round are polled from the next one on
+void ConcordanceServer::Impl::serve(size_t worker)
+{
+#ifdef CONCORDANCE_HAS_UNIX_SOCKETS
+	std::vector<Connection> connections;
+	std::vector<pollfd> polled;
+
+	while( true ){
+		polled.assign({pollfd{m_stop_pipe[0], POLLIN, 0}, pollfd{m_inboxes[worker]->wake_pipe[0], POLLIN, 0}});
+
+		for( const Connection &connection : connections ){
+			short events = connection.output.size() < MaxPendingOutput ? POLLIN : 0;
+			polled.push_back(pollfd{connection.socket, static_cast<short>(events | (connection.output.empty() ? 0 : POLLOUT)), 0});
+		}
+
+		if( worker == 0 ){
+			polled.push_back(pollfd{m_listener, POLLIN, 0});
+		}
+
+		if( ::poll(polled.data(), polled.size(), -1) < 0 ){
+			if( errno == EINTR ){
+				continue;
+			}
+			break;
+		}
+
+		if( polled[0].revents ){
+			break;
+		}
+
+		for( size_t connection = 0; connection < connections.size(); connection++ ){
+			Connection &current = connections[connection];
+			short events = polled[connection + 2].revents;
+			bool is_open = true;
+
+			if( events & (POLLIN | POLLHUP | POLLERR) ){
+				is_open = receive(current);
+			}
+
+			if( is_open && current.output.size() ){
+				is_open = transmit(current);
+			}
+
+			if( !is_open ){
+				::close(current.socket);
+				current.socket = -1;
+			}
+		}
+
+		bool accepts = worker == 0 && (polled.back().revents & POLLIN);
+		std::erase_if(connections, [](const Connection &connection){ return connection.socket < 0; });
+
+		if( polled[1].revents & POLLIN ){
+			takeHandedOver(worker, connections);
+		}
+
+		if( accepts ){
+			acceptConnections(connections);
+		}
+	}
+
+	for( const Connection &connection : connections ){
+		::close(connection.socket);
+	}
+#else
+	(void)worker;
+#endif
+}
+
+void ConcordanceServer::Impl::acceptConnections(std::vector<Connection> &connections)
+{
+#ifdef CONCORDANCE_HAS_UNIX_SOCKETS
+	while( true ){
+		int socket = ::accept(m_listener, nullptr, nullptr);
+
+		if( socket < 0 && errno == EINTR ){
+			continue;
+		} else if( socket < 0 ){
+			return;
+		}
+
+		if( !makeNonBlocking(socket) ){
+			::close(socket);
+			continue;
+		}
+
+		handOver(socket, connections);
+	}
+#else
+	(void)connections;
+#endif
+}
+
+//Threads take connections in turn. Those of the accepting thread are kept
+//right away, the others are woken up to take theirs. A full wake pipe
+//already wakes its thread
+void ConcordanceServer::Impl::handOver(int socket, std::vector<Connection> &connections)
+{
+	size_t worker = m_next_worker++ % m_inboxes.size();
+
+	if( worker == 0 ){
+		connections.push_back(Connection{socket, std::string(), std::string()});
+		return;
+	}
+
+	Inbox &inbox = *m_inboxes[worker];
+	{
+		std::lock_guard<std::mutex> lock(inbox.mutex);
+		inbox.sockets.push_back(socket);
+	}
+
+#ifdef CONCORDANCE_HAS_UNIX_SOCKETS
+	char wake = 0;
+	while( ::write(inbox.wake_pipe[1], &wake, 1) < 0 && errno == EINTR ){
+	}
+#endif
+}
+
+void ConcordanceServer::Impl::takeHandedOver(size_t worker, std::vector<Connection> &connections)
+{
+	Inbox &inbox = *m_inboxes[worker];
+
+#ifdef CONCORDANCE_HAS_UNIX_SOCKETS
+	char wakes[64];
+	while( ::read(inbox.wake_pipe[0], wakes, sizeof(wakes)) > 0 ){
+	}
+#endif
+
+	std::lock_guard<std::mutex> lock(inbox.mutex);
+	for( int socket : inbox.sockets ){
+		connections.push_back(Connection{socket, std::string(), std::string()});
+	}
+	inbox.sockets.clear();
+}
+
+//Reads whatever the client sent and answers every complete request in it,
+//until the socket runs dry or responses pile up. False once the client
+//is gone or sent something malformed
+bool ConcordanceServer::Impl::receive(Connection &connection) const
+{
+#ifdef CONCORDANCE_HAS_UNIX_SOCKETS
+	char block[ReceiveBlockSize];
+
+	while( connection.output.size() < MaxPendingOutput ){
+		ssize_t received = ::recv(connection.socket, block, sizeof(block), 0);
+
+		if( received < 0 && errno == EINTR ){
+			continue;
+		} else if( received < 0 ){
+			return errno == EAGAIN || errno == EWOULDBLOCK;
+		} else if( received == 0 ){
+			return false;
+		}
+
+		connection.input.append(block, received);
+
+		if( !answerRequests(connection) ){
+			return false;
+		}
+	}
+
+	return true;
+#else
+	(void)connection;
+	return false;
+#endif
+}
+
+bool ConcordanceServer::Impl::answerRequests(Connection &connection) const
+{
+	FrameReader reader(connection.input);
+	size_t consumed = 0;
+
+	while( connection.input.size() - consumed >= sizeof(uint32_t) ){
+		uint32_t request_size = reader.read<uint32_t>();
+
+		if( request_size > MaxRequestSize ){
+			return false;
+		} else if( connection.input.size() - consumed - sizeof(uint32_t) < request_size ){
+			break;
+		}
+
+		std::string response;
+		if( !answerInto(reader.readBytes(request_size), response) ){
+			return false;
+		}
+
+		if( response.size() > MaxResponseSize ){
+			appendPlain(connection.output, FailedResponse);
+		} else{
+			appendPlain(connection.output, static_cast<uint32_t>(response.size()));
+			connection.output.append(response);
+		}
+		consumed += sizeof(uint32_t) + request_size;
+	}
+
+	connection.input.erase(0, consumed);
+	return true;
+}
+
+bool ConcordanceServer::Impl::transmit(Connection &connection) const
+{
+#ifdef CONCORDANCE_HAS_UNIX_SOCKETS
+	size_t sent_size = 0;
+
+	while( sent_size < connection.output.size() ){
+		ssize_t sent = ::send(connection.socket, connection.output.data() + sent_size, connection.output.size() - sent_size, MSG_NOSIGNAL);
+
+		if( sent < 0 && errno == EINTR ){
+			continue;
+		} else if( sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) ){
+			break;
+		} else if( sent <= 0 ){
+			return false;
+		}
+
+		sent_size += sent;
+	}
+
+	connection.output.erase(0, sent_size);
+	return true;
+#else
+	(void)connection;
+	return false;
+#endif
+}
+//END OF INTERNAL CLASS DEFINITIONS
+
+
+//EXTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//							  ConcordanceServer								|
+//==========================================================================|
+ConcordanceServer::ConcordanceServer(const Concordance &concordance, TextEncoding encoding, size_t thread_count)
+	: m_impl(std::make_unique<Impl>(concordance, encoding, thread_count))
+{
+}
+
+ConcordanceServer::~ConcordanceServer()
+{
+}
+
+bool ConcordanceServer::listen(const std::string &socket_path)
+{
+	return m_impl->listen(socket_path);
+}
+
+void ConcordanceServer::stop()
+{
+	m_impl->stop();
+}
+
+std::optional<std::string> ConcordanceServer::answer(std::string_view request) const
+{
+	return m_impl->answer(request);
+}
+
+//==========================================================================|
+//							  ConcordanceClient								|
+//==========================================================================|
+ConcordanceClient ConcordanceClient::makeConnected(const std::string &socket_path)
+{
+	ConcordanceClient client;
+
+#ifdef CONCORDANCE_HAS_UNIX_SOCKETS
+	sockaddr_un address;
+	if( !makeSocketAddress(socket_path, address) ){
+		return client;
+	}
+
+	client.m_socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if( client.m_socket >= 0 && ::connect(client.m_socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ){
+		client.close();
+	}
+#else
+	(void)socket_path;
+#endif
+
+	return client;
+}
+
+ConcordanceClient::~ConcordanceClient()
+{
+	close();
+}
+
+ConcordanceClient::ConcordanceClient(ConcordanceClient &&other) noexcept : m_socket(std::exchange(other.m_socket, -1))
+{
+}
+
+ConcordanceClient &ConcordanceClient::operator=(ConcordanceClient &&other) noexcept
+{
+	if( this != &other ){
+		close();
+		m_socket = std::exchange(other.m_socket, -1);
+	}
+
+	return *this;
+}
+
+bool ConcordanceClient::isConnected() const
+{
+	return m_socket >= 0;
+}
+
+std::optional< std::vector<QueryResult> > ConcordanceClient::ask(const std::vector<Query> &queries)
+{
+#ifdef CONCORDANCE_HAS_UNIX_SOCKETS
+	std::string request;
+	appendPlain(request, uint32_t(0));
+
+	for( const Query &query : queries ){
+		appendPlain(request, static_cast<uint8_t>(query.kind));
+		appendPlain(request, static_cast<uint32_t>(query.word.size()));
+		request.append(query.word);
+	}
+
+	uint32_t request_size = static_cast<uint32_t>(request.size() - sizeof(uint32_t));
+	std::memcpy(request.data(), &request_size, sizeof(request_size));
+
+	uint32_t response_size = 0;
+	std::string response;
+
+	if( isConnected() && sendFully(m_socket, request) &&
+		receiveFully(m_socket, reinterpret_cast<char *>(&response_size), sizeof(response_size)) ){
+		if( response_size == ConcordanceServer::FailedResponse ){
+			return std::nullopt;
+		}
+
+		response.resize(response_size);
+
+		if( receiveFully(m_socket, response.data(), response.size()) ){
+			FrameReader reader(response);
+			std::vector<QueryResult> results;
+
+			for( size_t query = 0; query < queries.size(); query++ ){
+				std::optional<QueryResult> result = readResult(reader);
+				if( !result ){
+					break;
+				}
+				results.push_back(std::move(*result));
+			}
+
+			if( results.size() == queries.size() && reader.atEnd() ){
+				return results;
+			}
+		}
+	}
+#else
+	(void)queries;
+#endif
+
+	close();
+	return std::nullopt;
+}
+
+void ConcordanceClient::close()
+{
+#ifdef CONCORDANCE_HAS_UNIX_SOCKETS
+	if( m_socket >= 0 ){
+		::close(m_socket);
+	}
+#endif
+	m_socket = -1;
+}
+//END OF EXTERNAL CLASS DEFINITIONS
@@ -0,0 +1,164 @@
+#include "ConcurrentConcordance.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "WordSanitizer.hpp"
+#include "WordTable.hpp"
+#include "WordValidator.hpp"
+
+//INTERNAL CLASS DECLARATIONS
+//==========================================================================|
+//						ConcurrentConcordance::Impl							|
+//==========================================================================|
+class ConcurrentConcordance::Impl
+{
+public:
+	Impl(TextEncoding encoding, size_t shard_count);
+
+	void add(std::string_view word, Sentence sentence);
+	size_t size() const;
+	Concordance toConcordance();
+
+private:
+	//Aligned to a cache line, so locking a shard does not slow down the
+	//threads working on its neighbours
+	struct alignas(64) Shard
+	{
+		mutable std::mutex mutex;
+		WordTable words;
+		std::vector<bool> is_unsorted;
+	};
+
+	Shard &findShard(std::string_view word);
+
+private:
+	TextEncoding m_encoding;
+	std::vector<Shard> m_shards;
+};
+//END OF INTERNAL CLASS DECLARATIONS
+
+
+//INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+namespace
+{
+
+static void sortOccurrences(Occurrences &occurrences)
+{
+	std::vector<Sentence> sentences = occurrences.get();
+	std::sort(sentences.begin(), sentences.end());
+
+	occurrences = Occurrences();
+	for( Sentence sentence : sentences ){
+		occurrences << sentence;
+	}
+}
+
+}
+//END OF INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+
+
+//INTERNAL CLASS DEFINITIONS
+ConcurrentConcordance::Impl::Impl(TextEncoding encoding, size_t shard_count)
+	: m_encoding(encoding), m_shards(std::max<size_t>(shard_count, 1))
+{
+}
+
+void ConcurrentConcordance::Impl::add(std::string_view word, Sentence sentence)
+{
+	if( !WordValidator::isValid(word, m_encoding) ){
+		return;
+	}
+
+	thread_local Word sanitized;
+	WordSanitizer::sanitize(word, sanitized, m_encoding);
+
+	Shard &shard = findShard(sanitized);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+
+	WordId id = shard.words.insert(sanitized);
+	Occurrences &occurrences = shard.words.occurrences(id);
+
+	//Words whose sentences arrive out of order are sorted once, at the end
+	if( !occurrences.empty() && sentence < occurrences.back() ){
+		shard.is_unsorted.resize(std::max<size_t>(shard.is_unsorted.size(), id + 1));
+		shard.is_unsorted[id] = true;
+	}
+
+	occurrences << sentence;
+}
+
+size_t ConcurrentConcordance::Impl::size() const
+{
+	size_t size = 0;
+
+	for( const Shard &shard : m_shards ){
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		size += shard.words.size();
+	}
+
+	return size;
+}
+
+Concordance ConcurrentConcordance::Impl::toConcordance()
+{
+	Concordance concordance = Concordance::makeEmpty();
+
+	for( Shard &shard : m_shards ){
+		std::lock_guard<std::mutex> lock(shard.mutex);
+
+		for( WordId id = 0; id < shard.words.size(); id++ ){
+			Occurrences &occurrences = shard.words.occurrences(id);
+
+			if( id < shard.is_unsorted.size() && shard.is_unsorted[id] ){
+				sortOccurrences(occurrences);
+			}
+			concordance.addOccurrences(shard.words.word(id), std::move(occurrences));
+		}
+
+		shard.words = WordTable();
+		shard.is_unsorted.clear();
+	}
+
+	return concordance;
+}
+
+ConcurrentConcordance::Impl::Shard &ConcurrentConcordance::Impl::findShard(std::string_view word)
+{
+	//The high bits pick the shard, the tables inside use the low ones
+	size_t hash = std::hash<std::string_view>()(word);
+	return m_shards[(hash >> 40) % m_shards.size()];
+}
+//END OF INTERNAL CLASS DEFINITIONS
+
+
+//EXTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//							ConcurrentConcordance							|
+//==========================================================================|
+ConcurrentConcordance::ConcurrentConcordance(TextEncoding encoding, size_t shard_count)
+{
+	m_impl = std::make_unique<Impl>(encoding, shard_count);
+}
+
+ConcurrentConcordance::~ConcurrentConcordance()
+{
+}
+
+void ConcurrentConcordance::add(std::string_view word, Sentence sentence)
+{
+	m_impl->add(word, sentence);
+}
+
+size_t ConcurrentConcordance::size() const
+{
+	return m_impl->size();
+}
+
+Concordance ConcurrentConcordance::toConcordance()
+{
+	return m_impl->toConcordance();
+}
+//END OF EXTERNAL CLASS DEFINITIONS
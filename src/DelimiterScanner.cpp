@@ -0,0 +1,277 @@
+#include "DelimiterScanner.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#include "CharacterClasses.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define CONCORDANCE_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(CONCORDANCE_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define CONCORDANCE_HAS_AVX2 1
+#include <immintrin.h>
+#define CONCORDANCE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+//INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+namespace
+{
+
+enum class Search
+{
+	Whitespace,
+	NonWhitespace,
+	NonAlphanumeric,
+	NonAscii,
+};
+
+using ScanFunction = const char *(*)(const char *, const char *);
+
+struct KernelFunctions
+{
+	ScanFunction find_whitespace;
+	ScanFunction find_non_whitespace;
+	ScanFunction find_non_alphanumeric;
+	ScanFunction find_non_ascii;
+};
+
+//SCALAR KERNEL
+template <Search search>
+static bool matches(char c)
+{
+	if constexpr( search == Search::Whitespace ){
+		return hasCharacterClass(c, Whitespace);
+	} else if constexpr( search == Search::NonWhitespace ){
+		return !hasCharacterClass(c, Whitespace);
+	} else if constexpr( search == Search::NonAlphanumeric ){
+		return !hasCharacterClass(c, Alphanumeric);
+	} else{
+		return static_cast<unsigned char>(c) >= 0x80;
+	}
+}
+
+template <Search search>
+static const char *scanScalar(const char *begin, const char *end)
+{
+	return std::find_if(begin, end, matches<search>);
+}
+//END OF SCALAR KERNEL
+
+#ifdef CONCORDANCE_HAS_SSE2
+//SSE2 KERNEL
+static inline __m128i whitespaceBytes(__m128i bytes)
+{
+	__m128i space = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '));
+	__m128i newline = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n'));
+	__m128i tab = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t'));
+	return _mm_or_si128(space, _mm_or_si128(newline, tab));
+}
+
+//Comparisons are signed, so bytes outside ASCII are negative and never
+//fall inside a range. Setting bit 0x20 folds uppercase letters onto
+//lowercase ones, while no other byte is folded into 'a'-'z'
+static inline __m128i alphanumericBytes(__m128i bytes)
+{
+	__m128i folded = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+	__m128i letter = _mm_and_si128(_mm_cmpgt_epi8(folded, _mm_set1_epi8('a' - 1)),
+								   _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), folded));
+	__m128i digit = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('0' - 1)),
+								  _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), bytes));
+	return _mm_or_si128(letter, digit);
+}
+
+template <Search search>
+static inline uint32_t matchMaskSSE2(__m128i bytes)
+{
+	if constexpr( search == Search::Whitespace ){
+		return static_cast<uint32_t>(_mm_movemask_epi8(whitespaceBytes(bytes)));
+	} else if constexpr( search == Search::NonWhitespace ){
+		return ~static_cast<uint32_t>(_mm_movemask_epi8(whitespaceBytes(bytes))) & 0xFFFF;
+	} else if constexpr( search == Search::NonAlphanumeric ){
+		return ~static_cast<uint32_t>(_mm_movemask_epi8(alphanumericBytes(bytes))) & 0xFFFF;
+	} else{
+		//The sign bit of a byte is what makes it non ASCII
+		return static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+	}
+}
+
+template <Search search>
+static const char *scanSSE2(const char *begin, const char *end)
+{
+	while( end - begin >= 16 ){
+		__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+		uint32_t mask = matchMaskSSE2<search>(bytes);
+
+		if( mask ){
+			return begin + std::countr_zero(mask);
+		}
+		begin += 16;
+	}
+
+	return scanScalar<search>(begin, end);
+}
+//END OF SSE2 KERNEL
+#endif
+
+#ifdef CONCORDANCE_HAS_AVX2
+//AVX2 KERNEL
+CONCORDANCE_TARGET_AVX2 static inline __m256i whitespaceBytes(__m256i bytes)
+{
+	__m256i space = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' '));
+	__m256i newline = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n'));
+	__m256i tab = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\t'));
+	return _mm256_or_si256(space, _mm256_or_si256(newline, tab));
+}
+
+CONCORDANCE_TARGET_AVX2 static inline __m256i alphanumericBytes(__m256i bytes)
+{
+	__m256i folded = _mm256_or_si256(bytes, _mm256_set1_epi8(0x20));
+	__m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(folded, _mm256_set1_epi8('a' - 1)),
+									  _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), folded));
+	__m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('0' - 1)),
+									 _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), bytes));
+	return _mm256_or_si256(letter, digit);
+}
+
+template <Search search>
+CONCORDANCE_TARGET_AVX2 static inline uint32_t matchMaskAVX2(__m256i bytes)
+{
+	if constexpr( search == Search::Whitespace ){
+		return static_cast<uint32_t>(_mm256_movemask_epi8(whitespaceBytes(bytes)));
+	} else if constexpr( search == Search::NonWhitespace ){
+		return ~static_cast<uint32_t>(_mm256_movemask_epi8(whitespaceBytes(bytes)));
+	} else if constexpr( search == Search::NonAlphanumeric ){
+		return ~static_cast<uint32_t>(_mm256_movemask_epi8(alphanumericBytes(bytes)));
+	} else{
+		return static_cast<uint32_t>(_mm256_movemask_epi8(bytes));
+	}
+}
+
+template <Search search>
+CONCORDANCE_TARGET_AVX2 static const char *scanAVX2(const char *begin, const char *end)
+{
+	while( end - begin >= 32 ){
+		__m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+		uint32_t mask = matchMaskAVX2<search>(bytes);
+
+		if( mask ){
+			return begin + std::countr_zero(mask);
+		}
+		begin += 32;
+	}
+
+	return scanSSE2<search>(begin, end);
+}
+//END OF AVX2 KERNEL
+#endif
+
+static KernelFunctions getKernelFunctions(DelimiterScanner::Kernel kernel)
+{
+	if( !DelimiterScanner::isSupported(kernel) ){
+		kernel = DelimiterScanner::Kernel::Scalar;
+	}
+
+	switch( kernel ){
+#ifdef CONCORDANCE_HAS_AVX2
+	case DelimiterScanner::Kernel::AVX2:
+		return { scanAVX2<Search::Whitespace>, scanAVX2<Search::NonWhitespace>, scanAVX2<Search::NonAlphanumeric>, scanAVX2<Search::NonAscii> };
+#endif
+#ifdef CONCORDANCE_HAS_SSE2
+	case DelimiterScanner::Kernel::SSE2:
+		return { scanSSE2<Search::Whitespace>, scanSSE2<Search::NonWhitespace>, scanSSE2<Search::NonAlphanumeric>, scanSSE2<Search::NonAscii> };
+#endif
+	default:
+		return { scanScalar<Search::Whitespace>, scanScalar<Search::NonWhitespace>, scanScalar<Search::NonAlphanumeric>, scanScalar<Search::NonAscii> };
+	}
+}
+
+static const KernelFunctions &getBestKernelFunctions()
+{
+	static const KernelFunctions best = getKernelFunctions(DelimiterScanner::bestKernel());
+	return best;
+}
+
+}//ANONYMOUS NAMESPACE
+//END OF INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+
+
+
+//EXTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//							  DelimiterScanner								|
+//==========================================================================|
+DelimiterScanner::Kernel DelimiterScanner::bestKernel()
+{
+	if( isSupported(Kernel::AVX2) ){
+		return Kernel::AVX2;
+	} else if( isSupported(Kernel::SSE2) ){
+		return Kernel::SSE2;
+	} else{
+		return Kernel::Scalar;
+	}
+}
+
+bool DelimiterScanner::isSupported(Kernel kernel)
+{
+	switch( kernel ){
+	case Kernel::AVX2:
+#ifdef CONCORDANCE_HAS_AVX2
+		return __builtin_cpu_supports("avx2");
+#else
+		return false;
+#endif
+	case Kernel::SSE2:
+#ifdef CONCORDANCE_HAS_SSE2
+		return true;
+#else
+		return false;
+#endif
+	default:
+		return true;
+	}
+}
+
+const char *DelimiterScanner::findWhitespace(const char *begin, const char *end)
+{
+	return getBestKernelFunctions().find_whitespace(begin, end);
+}
+
+const char *DelimiterScanner::findNonWhitespace(const char *begin, const char *end)
+{
+	return getBestKernelFunctions().find_non_whitespace(begin, end);
+}
+
+const char *DelimiterScanner::findNonAlphanumeric(const char *begin, const char *end)
+{
+	return getBestKernelFunctions().find_non_alphanumeric(begin, end);
+}
+
+const char *DelimiterScanner::findNonAscii(const char *begin, const char *end)
+{
+	return getBestKernelFunctions().find_non_ascii(begin, end);
+}
+
+const char *DelimiterScanner::findWhitespace(const char *begin, const char *end, Kernel kernel)
+{
+	return getKernelFunctions(kernel).find_whitespace(begin, end);
+}
+
+const char *DelimiterScanner::findNonWhitespace(const char *begin, const char *end, Kernel kernel)
+{
+	return getKernelFunctions(kernel).find_non_whitespace(begin, end);
+}
+
+const char *DelimiterScanner::findNonAlphanumeric(const char *begin, const char *end, Kernel kernel)
+{
+	return getKernelFunctions(kernel).find_non_alphanumeric(begin, end);
+}
+
+const char *DelimiterScanner::findNonAscii(const char *begin, const char *end, Kernel kernel)
+{
+	return getKernelFunctions(kernel).find_non_ascii(begin, end);
+}
+//END OF EXTERNAL CLASS DEFINITIONS
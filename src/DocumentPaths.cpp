@@ -0,0 +1,79 @@
+#include "DocumentPaths.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <glob.h>
+
+//INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+namespace
+{
+
+static void appendDirectory(const std::filesystem::path &directory, std::vector<std::string> &documents)
+{
+	std::vector<std::string> found;
+	std::error_code error;
+
+	auto options = std::filesystem::directory_options::skip_permission_denied;
+	for( std::filesystem::recursive_directory_iterator entry(directory, options, error), end; !error && entry != end; entry.increment(error) ){
+		if( entry->is_regular_file(error) ){
+			found.push_back(entry->path().string());
+		}
+	}
+
+	std::sort(found.begin(), found.end());
+	documents.insert(documents.end(), found.begin(), found.end());
+}
+
+static void appendPath(const std::string &path, std::vector<std::string> &documents)
+{
+	std::error_code error;
+
+	if( std::filesystem::is_directory(path, error) ){
+		appendDirectory(path, documents);
+	} else{
+		documents.push_back(path);
+	}
+}
+
+//glob sorts its matches, a pattern without any is dropped
+static void appendMatches(const std::string &pattern, std::vector<std::string> &documents)
+{
+	glob_t matches{};
+
+	if( glob(pattern.c_str(), 0, nullptr, &matches) == 0 ){
+		for( size_t match = 0; match < matches.gl_pathc; match++ ){
+			appendPath(matches.gl_pathv[match], documents);
+		}
+	}
+
+	globfree(&matches);
+}
+
+}
+//END OF INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+
+
+//EXTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//								DocumentPaths								|
+//==========================================================================|
+std::vector<std::string> DocumentPaths::expand(const std::vector<std::string> &paths)
+{
+	std::vector<std::string> documents;
+
+	for( const std::string &path : paths ){
+		if( isPattern(path) ){
+			appendMatches(path, documents);
+		} else{
+			appendPath(path, documents);
+		}
+	}
+
+	return documents;
+}
+
+bool DocumentPaths::isPattern(std::string_view path)
+{
+	return path.find_first_of("*?[") != std::string_view::npos;
+}
+//END OF EXTERNAL CLASS DEFINITIONS
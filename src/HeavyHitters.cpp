@@ -0,0 +1,165 @@
+#include "HeavyHitters.hpp"
+
+#include <algorithm>
+
+//EXTERNAL FUNCTION DEFINITIONS
+bool ranksBefore(const WordCount &first, const WordCount &second)
+{
+	return first.count > second.count || (first.count == second.count && first.word < second.word);
+}
+//END OF EXTERNAL FUNCTION DEFINITIONS
+
+
+//EXTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//								HeavyHitters								|
+//==========================================================================|
+HeavyHitters::HeavyHitters(size_t capacity) : m_capacity(std::max<size_t>(capacity, 1))
+{
+	m_counters.reserve(m_capacity);
+}
+
+size_t HeavyHitters::capacity() const
+{
+	return m_capacity;
+}
+
+size_t HeavyHitters::size() const
+{
+	return m_counters.size();
+}
+
+//A counted word only grows, so it can only sink in the min heap
+void HeavyHitters::add(std::string_view word, size_t count)
+{
+	auto found = m_counter_of_word.find(word);
+
+	if( found != m_counter_of_word.end() ){
+		m_counters[found->second].count += count;
+		siftDown(m_heap_positions[found->second]);
+		return;
+	}
+
+	if( m_counters.size() < m_capacity ){
+		insert(word, count, 0);
+		return;
+	}
+
+	uint32_t replaced = m_heap.front();
+	WordCount &counter = m_counters[replaced];
+	m_counter_of_word.erase(counter.word);
+
+	counter.word.assign(word);
+	counter.error = counter.count;
+	counter.count += count;
+
+	m_counter_of_word.emplace(counter.word, replaced);
+	siftDown(0);
+}
+
+//A word counted by one summary only may still have occurred up to the
+//minimum count of the other one, if that one is full. It is charged that
+//much as both count and error, then the most counted words are kept
+void HeavyHitters::merge(const HeavyHitters &other)
+{
+	size_t minimum = minimumCount();
+	size_t other_minimum = other.minimumCount();
+	std::vector<WordCount> merged;
+
+	for( const WordCount &counter : m_counters ){
+		auto found = other.m_counter_of_word.find(counter.word);
+		const WordCount *other_counter = found != other.m_counter_of_word.end() ? &other.m_counters[found->second] : nullptr;
+
+		merged.push_back(WordCount{counter.word, counter.count + (other_counter ? other_counter->count : other_minimum),
+								   counter.error + (other_counter ? other_counter->error : other_minimum)});
+	}
+
+	for( const WordCount &other_counter : other.m_counters ){
+		if( !m_counter_of_word.contains(other_counter.word) ){
+			merged.push_back(WordCount{other_counter.word, other_counter.count + minimum, other_counter.error + minimum});
+		}
+	}
+
+	size_t kept = std::min(merged.size(), m_capacity);
+	std::partial_sort(merged.begin(), merged.begin() + kept, merged.end(), ranksBefore);
+	merged.resize(kept);
+
+	m_counters.clear();
+	m_heap.clear();
+	m_heap_positions.clear();
+	m_counter_of_word.clear();
+
+	for( const WordCount &counter : merged ){
+		insert(counter.word, counter.count, counter.error);
+	}
+}
+
+std::vector<WordCount> HeavyHitters::top(size_t k) const
+{
+	std::vector<WordCount> ranked = m_counters;
+	size_t kept = std::min(ranked.size(), k);
+
+	std::partial_sort(ranked.begin(), ranked.begin() + kept, ranked.end(), ranksBefore);
+	ranked.resize(kept);
+	return ranked;
+}
+
+//Until the summary is full every word is counted exactly
+size_t HeavyHitters::minimumCount() const
+{
+	return m_counters.size() < m_capacity ? 0 : m_counters[m_heap.front()].count;
+}
+
+void HeavyHitters::insert(std::string_view word, size_t count, size_t error)
+{
+	uint32_t counter = static_cast<uint32_t>(m_counters.size());
+
+	m_counters.push_back(WordCount{Word(word), count, error});
+	m_heap.push_back(counter);
+	m_heap_positions.push_back(static_cast<uint32_t>(m_heap.size() - 1));
+	m_counter_of_word.emplace(m_counters.back().word, counter);
+
+	siftUp(m_heap.size() - 1);
+}
+
+void HeavyHitters::siftUp(size_t position)
+{
+	while( position > 0 ){
+		size_t parent = (position - 1) / 2;
+
+		if( m_counters[m_heap[parent]].count <= m_counters[m_heap[position]].count ){
+			return;
+		}
+
+		swapPositions(parent, position);
+		position = parent;
+	}
+}
+
+void HeavyHitters::siftDown(size_t position)
+{
+	while( true ){
+		size_t smallest = position;
+
+		for( size_t child = 2 * position + 1; child <= 2 * position + 2 && child < m_heap.size(); child++ ){
+			if( m_counters[m_heap[child]].count < m_counters[m_heap[smallest]].count ){
+				smallest = child;
+			}
+		}
+
+		if( smallest == position ){
+			return;
+		}
+
+		swapPositions(smallest, position);
+		position = smallest;
+	}
+}
+
+void HeavyHitters::swapPositions(size_t first, size_t second)
+{
+	std::swap(m_heap[first], m_heap[second]);
+	m_heap_positions[m_heap[first]] = static_cast<uint32_t>(first);
+	m_heap_positions[m_heap[second]] = static_cast<uint32_t>(second);
+}
+//END OF EXTERNAL CLASS DEFINITIONS
@@ -0,0 +1,165 @@
+#include "MemoryMappedFile.hpp"
+
+#include <cstdint>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CONCORDANCE_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+namespace
+{
+
+#ifdef CONCORDANCE_HAS_MMAP
+//==========================================================================|
+//								FileDescriptor								|
+//==========================================================================|
+// @brief: Closes the wrapped descriptor when going out of scope. The		|
+//		   mapping outlives the descriptor, so it is only needed while		|
+//		   setting the mapping up											|
+//==========================================================================|
+class FileDescriptor
+{
+public:
+	FileDescriptor(int descriptor) : m_descriptor(descriptor) {}
+	~FileDescriptor()
+	{
+		if( m_descriptor >= 0 ){
+			::close(m_descriptor);
+		}
+	}
+
+	int get() const { return m_descriptor; }
+
+private:
+	int m_descriptor;
+};
+
+static void adviseAccess(void *address, size_t size, MappedAccess access)
+{
+#if defined(MADV_SEQUENTIAL) && defined(MADV_RANDOM)
+	::madvise(address, size, access == MappedAccess::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+#endif
+}
+
+static void releasePages(const char *begin, const char *end)
+{
+#ifdef MADV_DONTNEED
+	uintptr_t page_size = static_cast<uintptr_t>(::sysconf(_SC_PAGESIZE));
+	uintptr_t first_page = (reinterpret_cast<uintptr_t>(begin) + page_size - 1) / page_size * page_size;
+	uintptr_t end_page = reinterpret_cast<uintptr_t>(end) / page_size * page_size;
+
+	if( first_page < end_page ){
+		::madvise(reinterpret_cast<void *>(first_page), end_page - first_page, MADV_DONTNEED);
+	}
+#endif
+}
+#endif
+
+}//ANONYMOUS NAMESPACE
+//END OF INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+
+
+
+//EXTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//							  MemoryMappedFile								|
+//==========================================================================|
+MemoryMappedFile::~MemoryMappedFile()
+{
+	unmap();
+}
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile &&other) noexcept
+{
+	*this = std::move(other);
+}
+
+MemoryMappedFile &MemoryMappedFile::operator=(MemoryMappedFile &&other) noexcept
+{
+	if( this == &other ){
+		return *this;
+	}
+
+	unmap();
+	m_data = std::exchange(other.m_data, nullptr);
+	m_size = std::exchange(other.m_size, 0);
+	m_mapped = std::exchange(other.m_mapped, false);
+	return *this;
+}
+
+MemoryMappedFile MemoryMappedFile::makeFromFile(const std::string &filepath, MappedAccess access)
+{
+	MemoryMappedFile mapped_file;
+
+#ifdef CONCORDANCE_HAS_MMAP
+	FileDescriptor descriptor(::open(filepath.c_str(), O_RDONLY));
+	if( descriptor.get() < 0 ){
+		return mapped_file;
+	}
+
+	struct stat file_status;
+	if( ::fstat(descriptor.get(), &file_status) != 0 || !S_ISREG(file_status.st_mode) ){
+		return mapped_file;
+	}
+
+	size_t size = static_cast<size_t>(file_status.st_size);
+
+	//mmap refuses zero sized mappings, but an empty regular file is still
+	//a perfectly valid (empty) document
+	if( size == 0 ){
+		mapped_file.m_mapped = true;
+		return mapped_file;
+	}
+
+	void *address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor.get(), 0);
+	if( address == MAP_FAILED ){
+		return mapped_file;
+	}
+
+	adviseAccess(address, size, access);
+
+	mapped_file.m_data = static_cast<const char *>(address);
+	mapped_file.m_size = size;
+	mapped_file.m_mapped = true;
+#endif
+
+	return mapped_file;
+}
+
+bool MemoryMappedFile::isMapped() const
+{
+	return m_mapped;
+}
+
+std::string_view MemoryMappedFile::view() const
+{
+	return std::string_view(m_data, m_size);
+}
+
+void MemoryMappedFile::release(std::string_view bytes) const
+{
+#ifdef CONCORDANCE_HAS_MMAP
+	if( m_data && bytes.data() >= m_data && bytes.data() + bytes.size() <= m_data + m_size ){
+		releasePages(bytes.data(), bytes.data() + bytes.size());
+	}
+#endif
+}
+
+void MemoryMappedFile::unmap()
+{
+#ifdef CONCORDANCE_HAS_MMAP
+	if( m_data ){
+		::munmap(const_cast<char *>(m_data), m_size);
+	}
+#endif
+	m_data = nullptr;
+	m_size = 0;
+	m_mapped = false;
+}
+//END OF EXTERNAL CLASS DEFINITIONS
@@ -0,0 +1,474 @@
+#include "Occurrences.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+static constexpr unsigned char VarintPayloadMask = 0x7F;
+static constexpr unsigned char VarintContinuation = 0x80;
+
+static constexpr unsigned BlockBits = 16;
+static constexpr size_t BlockSize = size_t(1) << BlockBits;
+static constexpr size_t BitmapSize = BlockSize / 8;
+
+//Gaps are only sealed into containers once they take this many bytes, so
+//rarely found words never pay for a container
+static constexpr size_t SealThreshold = 1 << 10;
+
+//INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+namespace
+{
+
+static void appendVarint(std::string &encoded, size_t value)
+{
+	while( value > VarintPayloadMask ){
+		encoded.push_back(static_cast<char>((value & VarintPayloadMask) | VarintContinuation));
+		value >>= 7;
+	}
+
+	encoded.push_back(static_cast<char>(value));
+}
+
+static bool endsVarint(char byte)
+{
+	return !(static_cast<unsigned char>(byte) & VarintContinuation);
+}
+
+//Decodes the varint at position and moves position past it
+static size_t readVarint(const std::string &encoded, size_t &position)
+{
+	size_t value = 0;
+	unsigned shift = 0;
+
+	for( ; !endsVarint(encoded[position]); ++position, shift += 7 ){
+		value |= static_cast<size_t>(static_cast<unsigned char>(encoded[position]) & VarintPayloadMask) << shift;
+	}
+	value |= static_cast<size_t>(static_cast<unsigned char>(encoded[position++])) << shift;
+
+	return value;
+}
+
+static Sentence blockOf(Sentence sentence)
+{
+	return sentence >> BlockBits;
+}
+
+//Returns the first set bit of bitmap at or after bit, or BlockSize
+static size_t findSetBit(const std::string &bitmap, size_t bit)
+{
+	for( size_t byte = bit / 8; byte < BitmapSize; byte++ ){
+		unsigned char bits = static_cast<unsigned char>(bitmap[byte]);
+
+		if( byte == bit / 8 ){
+			bits &= static_cast<unsigned char>(0xFF << (bit % 8));
+		}
+
+		if( bits ){
+			return byte * 8 + std::countr_zero(bits);
+		}
+	}
+
+	return BlockSize;
+}
+
+//==========================================================================|
+//								DenseEncoding								|
+//==========================================================================|
+// @brief: The bitmap and run encodings of sorted sentences of one block,	|
+//		   as offsets from the start of the block. Runs are varint pairs of	|
+//		   the gap from the end of the previous run and the length minus	|
+//		   one. Repeats are the gap from the previous repeated offset, as a	|
+//		   varint shifted left by one. Its low bit tells that more than one	|
+//		   extra occurrence follows, their number being the next varint		|
+//==========================================================================|
+struct DenseEncoding
+{
+	std::string runs;
+	std::string repeats;
+	size_t bitmapSize() const { return BitmapSize + repeats.size(); }
+	size_t runsSize() const { return runs.size() + repeats.size(); }
+};
+
+static DenseEncoding encodeDense(const std::vector<Sentence> &sentences, size_t first, Sentence block_base)
+{
+	DenseEncoding encoding;
+	size_t previous_repeat = 0;
+	size_t run_start = 0;
+	size_t run_end = 0;
+	size_t previous_run_end = 0;
+
+	for( size_t i = first; i < sentences.size(); ){
+		size_t offset = sentences[i] - block_base;
+		size_t count = 0;
+
+		for( ; i < sentences.size() && sentences[i] - block_base == offset; i++ ){
+			++count;
+		}
+
+		if( count > 1 ){
+			appendVarint(encoding.repeats, (offset - previous_repeat) << 1 | (count > 2));
+			if( count > 2 ){
+				appendVarint(encoding.repeats, count - 1);
+			}
+			previous_repeat = offset;
+		}
+
+		if( run_end != 0 && offset == run_end ){
+			++run_end;
+			continue;
+		}
+
+		if( run_end != 0 ){
+			appendVarint(encoding.runs, run_start - previous_run_end);
+			appendVarint(encoding.runs, run_end - run_start - 1);
+			previous_run_end = run_end;
+		}
+		run_start = offset;
+		run_end = offset + 1;
+	}
+
+	appendVarint(encoding.runs, run_start - previous_run_end);
+	appendVarint(encoding.runs, run_end - run_start - 1);
+	return encoding;
+}
+
+static std::string makeBitmap(const std::vector<Sentence> &sentences, size_t first, Sentence block_base)
+{
+	std::string bitmap(BitmapSize, '\0');
+
+	for( size_t i = first; i < sentences.size(); i++ ){
+		size_t offset = sentences[i] - block_base;
+		bitmap[offset / 8] = static_cast<char>(bitmap[offset / 8] | (1 << (offset % 8)));
+	}
+
+	return bitmap;
+}
+
+}
+//END OF INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+
+
+//EXTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//							Occurrences::Iterator							|
+//==========================================================================|
+//Points at the first sentence from container on. The container after the
+//open gaps is the end
+Occurrences::Iterator::Iterator(const Occurrences *occurrences, size_t container)
+	: m_occurrences(occurrences)
+{
+	enterContainer(container);
+
+	if( container <= m_occurrences->m_sealed.size() ){
+		++*this;
+	}
+}
+
+Occurrences::Iterator &Occurrences::Iterator::operator++()
+{
+	while( m_container <= m_occurrences->m_sealed.size() && !advanceInContainer() ){
+		enterContainer(m_container + 1);
+	}
+
+	return *this;
+}
+
+Occurrences::Iterator Occurrences::Iterator::operator++(int)
+{
+	Iterator previous = *this;
+	++*this;
+	return previous;
+}
+
+bool Occurrences::Iterator::operator==(const Iterator &other) const
+{
+	return m_container == other.m_container && m_position == other.m_position && m_run_left == other.m_run_left &&
+		   m_repeat_position == other.m_repeat_position && m_repeats_left == other.m_repeats_left;
+}
+
+void Occurrences::Iterator::enterContainer(size_t container)
+{
+	const std::vector<Container> &sealed = m_occurrences->m_sealed;
+
+	m_container = container;
+	m_position = 0;
+	m_run_left = 0;
+	m_repeat_position = 0;
+	m_repeat_offset = 0;
+	m_repeats_left = 0;
+
+	//Gaps continue from the last sentence of the container before them
+	if( container <= sealed.size() ){
+		m_sentence = container == 0 ? 0 : sealed[container - 1].last;
+	}
+}
+
+//Moves to the next sentence of the current container, if there is one
+bool Occurrences::Iterator::advanceInContainer()
+{
+	const std::vector<Container> &sealed = m_occurrences->m_sealed;
+	const std::string &data = m_occurrences->containerData(m_container);
+	ContainerKind kind = m_container < sealed.size() ? sealed[m_container].kind : ContainerKind::Gaps;
+
+	if( kind == ContainerKind::Gaps ){
+		if( m_position == data.size() ){
+			return false;
+		}
+
+		m_sentence += readVarint(data, m_position);
+		return true;
+	}
+
+	if( takeRepeat() ){
+		return true;
+	}
+
+	Sentence block_base = sealed[m_container].block_base;
+
+	if( kind == ContainerKind::Bitmap ){
+		m_position = findSetBit(data, m_position);
+		if( m_position == BlockSize ){
+			return false;
+		}
+
+		m_sentence = block_base + m_position++;
+		loadRepeatCount(m_sentence - block_base);
+		return true;
+	}
+
+	if( m_run_left == 0 ){
+		if( m_position == data.size() ){
+			return false;
+		}
+
+		size_t previous_run_end = m_position == 0 ? 0 : m_sentence - block_base + 1;
+		size_t run_start = previous_run_end + readVarint(data, m_position);
+		m_run_left = readVarint(data, m_position) + 1;
+		m_sentence = block_base + run_start - 1;
+	}
+
+	++m_sentence;
+	--m_run_left;
+	loadRepeatCount(m_sentence - block_base);
+	return true;
+}
+
+bool Occurrences::Iterator::takeRepeat()
+{
+	if( m_repeats_left == 0 ){
+		return false;
+	}
+
+	--m_repeats_left;
+	return true;
+}
+
+//Repeats are sorted by offset, so only the next one can be at offset
+void Occurrences::Iterator::loadRepeatCount(size_t offset)
+{
+	const std::string &repeats = m_occurrences->m_sealed[m_container].repeats;
+
+	if( m_repeat_position == repeats.size() ){
+		return;
+	}
+
+	size_t position = m_repeat_position;
+	size_t flagged_gap = readVarint(repeats, position);
+	size_t repeat_offset = m_repeat_offset + (flagged_gap >> 1);
+
+	if( repeat_offset == offset ){
+		m_repeats_left = flagged_gap & 1 ? readVarint(repeats, position) : 1;
+		m_repeat_offset = repeat_offset;
+		m_repeat_position = position;
+	}
+}
+
+//==========================================================================|
+//								Occurrences									|
+//==========================================================================|
+//A list moved from is left empty
+Occurrences::Occurrences(Occurrences &&other) noexcept
+	: m_gaps(std::move(other.m_gaps)), m_last(std::exchange(other.m_last, 0)), m_sealed(std::move(other.m_sealed)),
+	  m_size(std::exchange(other.m_size, 0))
+{
+	other.m_gaps.clear();
+	other.m_sealed.clear();
+}
+
+Occurrences &Occurrences::operator=(Occurrences &&other) noexcept
+{
+	if( this != &other ){
+		m_gaps = std::move(other.m_gaps);
+		m_last = std::exchange(other.m_last, 0);
+		m_sealed = std::move(other.m_sealed);
+		m_size = std::exchange(other.m_size, 0);
+		other.m_gaps.clear();
+		other.m_sealed.clear();
+	}
+
+	return *this;
+}
+
+Occurrences::Iterator Occurrences::begin() const
+{
+	return Iterator(this, 0);
+}
+
+Occurrences::Iterator Occurrences::end() const
+{
+	return Iterator(this, m_sealed.size() + 1);
+}
+
+size_t Occurrences::size() const
+{
+	return m_size;
+}
+
+bool Occurrences::empty() const
+{
+	return m_gaps.empty() && m_sealed.empty();
+}
+
+Sentence Occurrences::back() const
+{
+	return m_last;
+}
+
+std::vector<Sentence> Occurrences::get() const
+{
+	return std::vector<Sentence>(begin(), end());
+}
+
+Occurrences &Occurrences::operator<<(Sentence sentence)
+{
+	//The gaps of the latest block stay open, its sentences may still grow
+	if( m_gaps.size() >= SealThreshold && blockOf(sentence) != blockOf(m_last) ){
+		seal();
+	}
+
+	appendVarint(m_gaps, sentence - m_last);
+	m_last = sentence;
+	++m_size;
+	return *this;
+}
+
+//A list without containers is appended as bytes. Only its first gap changes,
+//it is measured from the last sentence of this list rather than from 0
+void Occurrences::append(const Occurrences &other, Sentence offset)
+{
+	if( !other.m_sealed.empty() ){
+		for( Sentence sentence : other ){
+			*this << sentence + offset;
+		}
+		return;
+	}
+
+	if( other.m_gaps.empty() ){
+		return;
+	}
+
+	size_t position = 0;
+	*this << readVarint(other.m_gaps, position) + offset;
+	m_gaps.append(other.m_gaps, position);
+	m_last = other.m_last + offset;
+	m_size += other.m_size - 1;
+}
+
+//Lists without containers have a unique encoding and compare as bytes
+bool Occurrences::operator==(const Occurrences &other) const
+{
+	if( m_sealed.empty() && other.m_sealed.empty() ){
+		return m_gaps == other.m_gaps;
+	}
+
+	return m_last == other.m_last && std::equal(begin(), end(), other.begin(), other.end());
+}
+
+size_t Occurrences::encodedSize() const
+{
+	size_t size = m_gaps.size();
+
+	for( const Container &container : m_sealed ){
+		size += container.data.size() + container.repeats.size();
+	}
+
+	return size;
+}
+
+std::string Occurrences::encodeGaps() const
+{
+	if( m_sealed.empty() ){
+		return m_gaps;
+	}
+
+	std::string gaps;
+	Sentence previous = 0;
+
+	for( Sentence sentence : *this ){
+		appendVarint(gaps, sentence - previous);
+		previous = sentence;
+	}
+
+	return gaps;
+}
+
+//Every varint has exactly one byte without the continuation bit
+Occurrences Occurrences::makeFromGaps(std::string_view gaps, Sentence last)
+{
+	Occurrences occurrences;
+	occurrences.m_gaps.assign(gaps);
+	occurrences.m_last = last;
+	occurrences.m_size = std::count_if(gaps.begin(), gaps.end(), endsVarint);
+	return occurrences;
+}
+
+//Moves the open gaps into containers. The sorted sentences at the end which
+//share the block of the last one are stored in the smallest container,
+//whatever comes before them stays as gaps
+void Occurrences::seal()
+{
+	std::vector<Sentence> sentences;
+	std::vector<size_t> gap_starts;
+	Sentence sentence = m_sealed.empty() ? 0 : m_sealed.back().last;
+
+	for( size_t position = 0; position < m_gaps.size(); ){
+		gap_starts.push_back(position);
+		sentence += readVarint(m_gaps, position);
+		sentences.push_back(sentence);
+	}
+
+	size_t first = sentences.size() - 1;
+	while( first > 0 && blockOf(sentences[first - 1]) == blockOf(m_last) && sentences[first - 1] <= sentences[first] ){
+		--first;
+	}
+
+	Sentence block_base = blockOf(m_last) << BlockBits;
+	DenseEncoding dense = encodeDense(sentences, first, block_base);
+	size_t gaps_size = m_gaps.size() - gap_starts[first];
+
+	if( gaps_size <= std::min(dense.bitmapSize(), dense.runsSize()) ){
+		m_sealed.push_back(Container{ContainerKind::Gaps, 0, m_last, sentences.size(), std::move(m_gaps), std::string()});
+		m_gaps = std::string();
+		return;
+	}
+
+	if( first > 0 ){
+		m_sealed.push_back(Container{ContainerKind::Gaps, 0, sentences[first - 1], first, m_gaps.substr(0, gap_starts[first]), std::string()});
+	}
+
+	bool use_bitmap = dense.bitmapSize() < dense.runsSize();
+	Container block{ContainerKind::Runs, block_base, m_last, sentences.size() - first, std::move(dense.runs), std::move(dense.repeats)};
+	if( use_bitmap ){
+		block.kind = ContainerKind::Bitmap;
+		block.data = makeBitmap(sentences, first, block_base);
+	}
+
+	m_sealed.push_back(std::move(block));
+	m_gaps = std::string();
+}
+
+const std::string &Occurrences::containerData(size_t container) const
+{
+	return container < m_sealed.size() ? m_sealed[container].data : m_gaps;
+}
+//END OF EXTERNAL CLASS DEFINITIONS
@@ -85,15 +85,11 @@ std::string makePrintable(const Occurrences &occurrences)
 {
 	std::string printable = "{";
 
-	const std::vector<Sentence> &sentences = occurrences.get();
-	printable += std::to_string(sentences.size());
+	printable += std::to_string(occurrences.size());
 	printable += ":";
 
-	auto to_string = [](Sentence sentence){
-		return std::to_string(sentence) + ",";
-	};
-
-	for( Sentence sentence : sentences ){
+	//Sentences are decoded one at a time, straight from their gaps
+	for( Sentence sentence : occurrences ){
 		printable += std::to_string(sentence) + ",";
 	}
 
@@ -0,0 +1,317 @@
+#include "RadixTrie.hpp"
+
+#include <algorithm>
+#include <bit>
+
+static constexpr uint32_t Root = 0;
+static constexpr uint32_t MinChildrenCapacity = 2;
+
+//INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+namespace
+{
+
+static unsigned char byteOf(char character)
+{
+	return static_cast<unsigned char>(character);
+}
+
+//A slice of capacity children holds their first bytes, packed four to a
+//word, followed by their nodes, so both usually share a cache line
+static uint32_t byteWords(uint32_t capacity)
+{
+	return (capacity + 3) / 4;
+}
+
+static size_t commonPrefixSize(std::string_view first, std::string_view second)
+{
+	size_t size = std::min(first.size(), second.size());
+	return std::mismatch(first.begin(), first.begin() + size, second.begin()).first - first.begin();
+}
+
+//The smallest string greater than every string starting with prefix, none
+//when the prefix is made of 0xFF bytes only
+static std::optional<std::string> prefixSuccessor(std::string_view prefix)
+{
+	std::string successor(prefix);
+
+	while( !successor.empty() && byteOf(successor.back()) == 0xFF ){
+		successor.pop_back();
+	}
+
+	if( successor.empty() ){
+		return std::nullopt;
+	}
+
+	successor.back() = static_cast<char>(byteOf(successor.back()) + 1);
+	return successor;
+}
+
+}
+//END OF INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+
+
+//EXTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//								 RadixTrie									|
+//==========================================================================|
+RadixTrie::RadixTrie() : m_nodes(1)
+{
+}
+
+size_t RadixTrie::size() const
+{
+	return m_postings.size();
+}
+
+bool RadixTrie::empty() const
+{
+	return m_postings.empty();
+}
+
+Occurrences &RadixTrie::findOrInsert(std::string_view word)
+{
+	return m_postings[insert(word)];
+}
+
+const Occurrences *RadixTrie::find(std::string_view word) const
+{
+	uint32_t node = findNode(word);
+
+	if( node == NoNode || m_nodes[node].word == WordInterner::NoWord ){
+		return nullptr;
+	}
+
+	return &m_postings[m_nodes[node].word];
+}
+
+//Follows the labels along word. A label that only partly matches is split
+//where they differ, whatever is left of word hangs below as a new leaf
+WordId RadixTrie::insert(std::string_view word)
+{
+	uint32_t node = Root;
+	size_t position = 0;
+
+	while( position < word.size() ){
+		uint32_t child = findChild(node, word[position]);
+
+		if( child == NoNode ){
+			child = addNode(word.substr(position));
+			linkChild(node, child);
+			return assignWord(child);
+		}
+
+		//The first byte already matched when the child was found
+		size_t common = 1 + commonPrefixSize(label(child).substr(1), word.substr(position + 1));
+		if( common < m_nodes[child].label_size ){
+			split(child, common);
+		}
+
+		position += common;
+		node = child;
+	}
+
+	return assignWord(node);
+}
+
+Occurrences &RadixTrie::occurrences(WordId id)
+{
+	return m_postings[id];
+}
+
+const Occurrences &RadixTrie::occurrences(WordId id) const
+{
+	return m_postings[id];
+}
+
+void RadixTrie::forEachWord(const WordVisitor &visit) const
+{
+	walk(std::string_view(), std::nullopt, visit);
+}
+
+void RadixTrie::forEachWithPrefix(std::string_view prefix, const WordVisitor &visit) const
+{
+	std::optional<std::string> successor = prefixSuccessor(prefix);
+	walk(prefix, successor ? std::optional<std::string_view>(*successor) : std::nullopt, visit);
+}
+
+void RadixTrie::forEachInRange(std::string_view first, std::string_view last, const WordVisitor &visit) const
+{
+	if( first < last ){
+		walk(first, last, visit);
+	}
+}
+
+std::string_view RadixTrie::label(uint32_t node) const
+{
+	return std::string_view(m_labels).substr(m_nodes[node].label_offset, m_nodes[node].label_size);
+}
+
+uint32_t RadixTrie::findChild(uint32_t node, char first_byte) const
+{
+	const Node &parent = m_nodes[node];
+	const uint32_t *slice = m_children.data() + parent.children_offset;
+	const unsigned char *bytes = reinterpret_cast<const unsigned char *>(slice);
+
+	for( uint32_t child = 0; child < parent.children_count && bytes[child] <= byteOf(first_byte); child++ ){
+		if( bytes[child] == byteOf(first_byte) ){
+			return slice[byteWords(parent.children_capacity) + child];
+		}
+	}
+
+	return NoNode;
+}
+
+//The node whose key is word, or NoNode
+uint32_t RadixTrie::findNode(std::string_view word) const
+{
+	uint32_t node = Root;
+	size_t position = 0;
+
+	while( position < word.size() ){
+		node = findChild(node, word[position]);
+
+		if( node == NoNode || !word.substr(position).starts_with(label(node)) ){
+			return NoNode;
+		}
+		position += m_nodes[node].label_size;
+	}
+
+	return node;
+}
+
+uint32_t RadixTrie::addNode(std::string_view label)
+{
+	Node node;
+	node.label_offset = m_labels.size();
+	node.label_size = static_cast<uint32_t>(label.size());
+
+	m_labels.append(label);
+	m_nodes.push_back(node);
+	return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+//Children stay sorted by the first byte of their labels. A full slice is
+//moved to one twice as large and left for another node to reuse
+void RadixTrie::linkChild(uint32_t parent, uint32_t child)
+{
+	Node &node = m_nodes[parent];
+
+	if( node.children_count == node.children_capacity ){
+		uint32_t capacity = std::max(MinChildrenCapacity, node.children_capacity * 2);
+		uint32_t offset = allocateChildren(capacity);
+		uint32_t *slice = m_children.data() + node.children_offset;
+		uint32_t *moved = m_children.data() + offset;
+
+		std::copy_n(reinterpret_cast<unsigned char *>(slice), node.children_count, reinterpret_cast<unsigned char *>(moved));
+		std::copy_n(slice + byteWords(node.children_capacity), node.children_count, moved + byteWords(capacity));
+
+		if( node.children_capacity ){
+			m_free_children[std::countr_zero(node.children_capacity)].push_back(node.children_offset);
+		}
+		node.children_offset = offset;
+		node.children_capacity = capacity;
+	}
+
+	unsigned char *bytes = reinterpret_cast<unsigned char *>(m_children.data() + node.children_offset);
+	uint32_t *nodes = m_children.data() + node.children_offset + byteWords(node.children_capacity);
+	unsigned char first_byte = byteOf(label(child).front());
+	size_t position = std::lower_bound(bytes, bytes + node.children_count, first_byte) - bytes;
+
+	std::copy_backward(bytes + position, bytes + node.children_count, bytes + node.children_count + 1);
+	std::copy_backward(nodes + position, nodes + node.children_count, nodes + node.children_count + 1);
+	bytes[position] = first_byte;
+	nodes[position] = child;
+	++node.children_count;
+}
+
+//Slices are taken from the free ones of the same capacity first, which are
+//all powers of two
+uint32_t RadixTrie::allocateChildren(uint32_t capacity)
+{
+	std::vector<uint32_t> &free_slices = m_free_children[std::countr_zero(capacity)];
+
+	if( !free_slices.empty() ){
+		uint32_t offset = free_slices.back();
+		free_slices.pop_back();
+		return offset;
+	}
+
+	uint32_t offset = static_cast<uint32_t>(m_children.size());
+	m_children.resize(offset + byteWords(capacity) + capacity);
+	return offset;
+}
+
+//The node keeps the first label_size bytes of its label and its place among
+//its siblings, whose first byte does not change. The rest of the label, its
+//word and its children move to a new node, which becomes its only child
+void RadixTrie::split(uint32_t node, size_t label_size)
+{
+	Node tail = m_nodes[node];
+	tail.label_offset += label_size;
+	tail.label_size -= static_cast<uint32_t>(label_size);
+	m_nodes.push_back(tail);
+
+	Node &head = m_nodes[node];
+	head.label_size = static_cast<uint32_t>(label_size);
+	head.word = WordInterner::NoWord;
+	head.children_count = 0;
+	head.children_capacity = 0;
+	linkChild(node, static_cast<uint32_t>(m_nodes.size() - 1));
+}
+
+WordId RadixTrie::assignWord(uint32_t node)
+{
+	if( m_nodes[node].word == WordInterner::NoWord ){
+		m_nodes[node].word = static_cast<WordId>(m_postings.size());
+		m_postings.emplace_back();
+	}
+
+	return m_nodes[node].word;
+}
+
+//Depth first walk in alphabetical order over the words from first up to,
+//and excluding, last. Subtrees whose key sorts before first without being
+//a prefix of it are skipped whole, and the walk stops at the first key
+//past last, since everything after it sorts after last too
+void RadixTrie::walk(std::string_view first, std::optional<std::string_view> last, const WordVisitor &visit) const
+{
+	std::string key;
+
+	if( m_nodes[Root].word != WordInterner::NoWord && first.empty() && (!last || !last->empty()) ){
+		visit(key, m_nodes[Root].word);
+	}
+
+	//Every node on the path to the current one, along with its next child
+	std::vector< std::pair<uint32_t, uint32_t> > path = {{Root, 0}};
+
+	while( !path.empty() ){
+		auto &[parent, next_child] = path.back();
+
+		if( next_child == m_nodes[parent].children_count ){
+			key.resize(key.size() - m_nodes[parent].label_size);
+			path.pop_back();
+			continue;
+		}
+
+		const Node &parent_node = m_nodes[parent];
+		uint32_t node = m_children[parent_node.children_offset + byteWords(parent_node.children_capacity) + next_child++];
+		key.append(label(node));
+
+		if( last && key >= *last ){
+			return;
+		}
+
+		int order = key.compare(0, key.size(), first.substr(0, key.size()));
+		if( order < 0 ){
+			key.resize(key.size() - m_nodes[node].label_size);
+			continue;
+		}
+
+		if( m_nodes[node].word != WordInterner::NoWord && (order > 0 || key.size() >= first.size()) ){
+			visit(key, m_nodes[node].word);
+		}
+
+		path.emplace_back(node, 0);
+	}
+}
+//END OF EXTERNAL CLASS DEFINITIONS
@@ -1,9 +1,14 @@
 #include "TextDocumentTraveller.hpp"
-#include <deque>
 #include <vector>
-#include <fstream>
+#include <algorithm>
 
-static const size_t BufferedChunksSize = 20;
+#include "CharacterClasses.hpp"
+#include "DelimiterScanner.hpp"
+#include "TokenRing.hpp"
+#include "WordBoundaryAutomaton.hpp"
+
+static const size_t ReadBlockSize = 1 << 20;
+static const size_t ParseBufferCapacity = 1024;
 
 //INTERNAL CLASS DECLARATIONS
 //==========================================================================|
@@ -12,20 +17,34 @@ static const size_t BufferedChunksSize = 20;
 class TextDocumentTraveller::Impl
 {
 public:
-	Impl(){}
-	~Impl();
+	Impl(TextEncoding encoding) : m_encoding(encoding), m_parse_buffer(ParseBufferCapacity) {}
 
-	void openFile(const std::string &filepath);
+	void open(std::unique_ptr<ByteSource> source, SourceDecoding decoding);
 
 	bool hasNext();
-	DocumentElement getNext();
+	Token getNextToken();
+	size_t next(std::span<Token> out);
+	Generator<Token> elements();
 
 private:
 	void fillBuffer();
+	void takeNextChunk();
+	Token splitUnsplitChunk();
+	bool loadMoreBytes();
+	bool readBlock(size_t read_offset);
 
 private:
-	std::ifstream m_file_stream;
-	std::deque<DocumentElement> m_parse_buffer;
+	TextEncoding m_encoding;
+	std::unique_ptr<ByteSource> m_source;
+	bool m_source_exhausted = false;
+	std::vector<char> m_block;
+	size_t m_block_size = 0;
+	size_t m_block_split_size = 0;
+	std::string_view m_unread_bytes;
+	std::string_view m_unsplit_chunk;
+	bool m_unsplit_chunk_is_ascii = true;
+	const char *m_next_non_ascii = nullptr;
+	TokenRing m_parse_buffer;
 };
 //END OF INTERNAL CLASS DECLARATIONS`
 
@@ -34,363 +53,292 @@ private:
 namespace
 {
 
-//INTERNAL AUX CLASS DECLARATIONS
-//==========================================================================|
-//								EndCalculator								|
-//==========================================================================|
-// @brief: Calculates the end of a DocumentElement of a chunk.				|
-//		   A document chunk can contain more than one DocumentElements,like:|
-//		   'well,no' --> 3 document elements: 'well' - ',' - 'no'			|
-//		   The EndCalculator returns the end iterator of the DocumentElement|
-//		   under consideration												|
-//==========================================================================|
-
-class ElementEndCalculator
-{
-public:
-	ElementEndCalculator(const std::string::const_iterator &start, const std::string &document_chunk);
-	virtual ~ElementEndCalculator() {}
-
-	std::string::const_iterator calcEndOfDocumentElement();
-
-protected:
-	const std::string::const_iterator &getStart() const;
-	const std::string &getDocumentChunk() const;
-	
-	enum class CharacterHandling
-	{
-		Consume,
-		MarkAsEnd,
-	};
-	virtual CharacterHandling checkCharacter(const std::string::const_iterator &current) = 0;
-
-private:
-	std::string::const_iterator m_element_start;
-	const std::string &m_document_chunk;
-};
-
-//==========================================================================|
-//							SymbolEndCalculator								|
-//==========================================================================|
-// @brief: SymbolEndCalculator - Concrete class which calculates the end of |
-//		   a Symbol.														|
-//		   A symbol always consists of a single character					|
-//==========================================================================|
-
-class SymbolEndCalculator : public ElementEndCalculator
+//INTERNAL AUX FUNCTIONS
+static bool isWhitespace(char c)
 {
-public:
-	SymbolEndCalculator(const std::string::const_iterator &start, const std::string &document_chunk);
-private:
-	CharacterHandling checkCharacter(const std::string::const_iterator &current);
-};
-
+	return hasCharacterClass(c, Whitespace);
+}
 
 //==========================================================================|
-//							WordEndCalculator								|
+//								  Character									|
 //==========================================================================|
-// @brief: WordEndCalculator - Concrete class which calculates the end      |
-//		   of a word. A word does not necessarily ends on the end of the 	|
-//		   chunk, or on  a word terminating character.						|
-//		   Special handling needs to be done for abbreviations or words with| 
-//		   special characters												|
+// @brief: Classes and size in bytes of the character at some position of	|
+//		   a chunk. Under Ascii every byte is a character, under Utf8 a		|
+//		   character is a whole code point									|
 //==========================================================================|
-
-class WordEndCalculator : public ElementEndCalculator
+struct Character
 {
-public:
-	WordEndCalculator(const std::string::const_iterator &start, const std::string &document_chunk);
-
-private:
-	CharacterHandling checkCharacter(const std::string::const_iterator &current);
-
-	enum class WordType
-	{
-		EnglishWord,
-		Abbreviation,
-		SpecialCharacters,
-	};
-	
-	void updateWordType(const std::string::const_iterator &current);
-	
-private:
-	WordType m_type = WordType::EnglishWord;
+	unsigned char character_class;
+	size_t size;
 };
-//END OF INTERNAL AUX CLASS DECLARATIONS
-
-
 
-//INTERNAL AUX FUNCTIONS
-std::deque<DocumentElement> &operator<<(std::deque<DocumentElement> &collection, DocumentElement &&element)
+template <TextEncoding encoding>
+static Character readCharacter(std::string_view chunk, size_t position)
 {
-	collection.push_back( std::move(element) );
-	return collection;
-}
+	char c = chunk[position];
 
-std::deque<DocumentElement> &operator<<(std::deque<DocumentElement> &collection, std::deque<DocumentElement> &&other)
-{
-	std::move(other.begin(), other.end(), std::back_inserter(collection));
-	return collection;
-}
+	if constexpr( encoding == TextEncoding::Utf8 ){
+		if( static_cast<unsigned char>(c) >= 0x80 ){
+			char32_t code_point;
+			size_t size = Utf8::decode(chunk.substr(position), code_point);
+			return { Utf8::classify(code_point), size };
+		}
+	}
 
-static bool isWhitespace(char c)
-{
-	return c == ' ' || c == '\n' || c == '\t';
+	return { classify(c), 1 };
 }
 
-static bool isSymbol(char c)
+static const char *findLastWhitespace(const char *begin, const char *end)
 {
-	return !std::isalnum(static_cast<unsigned char>(c));
-}
+	for( const char *current = end; current != begin; --current ){
+		if( isWhitespace(*(current - 1)) ){
+			return current - 1;
+		}
+	}
 
-static bool isDot(char c)
-{
-	return c == '.';
+	return end;
 }
 
-static bool isWordTerminatingCharacter(char c)
+static std::string_view getNextChunk(std::string_view &unread_bytes)
 {
-	return c == '.'  ||
-		   c == '!'  ||
-		   c == '?'  ||
-		   c == ','  ||
-		   c == '('  ||
-		   c == ')'  ||
-		   c == '['  ||
-		   c == ']'  ||
-		   c == '{'  ||
-		   c == '}'  ||
-		   c == ';'  ||
-		   c == ':'  ||
-		   c == '"'  ||
-		   c == '<'  ||
-		   c == '>';
-}
+	const char *unread_end = unread_bytes.data() + unread_bytes.size();
 
-static bool canTerminateAbbreviation(const std::string::const_iterator &current)
-{
-	if( isDot(*current) ){
-		std::string::const_iterator previous = current - 1;
-		return isDot(*previous);
+	const char *chunk_begin = DelimiterScanner::findNonWhitespace(unread_bytes.data(), unread_end);
+	const char *chunk_end = DelimiterScanner::findWhitespace(chunk_begin, unread_end);
 
-	} else {
-		return isWordTerminatingCharacter(*current);
-	}
+	unread_bytes.remove_prefix(chunk_end - unread_bytes.data());
+	return std::string_view(chunk_begin, chunk_end - chunk_begin);
 }
 
-static std::string getNextChunk(std::ifstream &stream)
-{
-	std::string chunk;
+//==========================================================================|
+//								findEndOfWord								|
+//==========================================================================|
+// @brief: Calculates the end of a word inside a chunk. A chunk can contain	|
+//		   more than one DocumentElements, like:							|
+//		   'well,no' --> 3 document elements: 'well' - ',' - 'no'			|
+//		   A word does not necessarily end on the end of the chunk, or on	|
+//		   a word terminating character. The chunk is fed to the			|
+//		   WordBoundaryAutomaton until one of its transitions ends the word	|
+//==========================================================================|
+template <TextEncoding encoding>
+static size_t findEndOfWord(std::string_view chunk, size_t start)
+{
+	using namespace WordBoundaryAutomaton;
+
+	State state = InitialState;
+	const char *chunk_end = chunk.data() + chunk.size();
+
+	for( size_t current = start; current < chunk.size(); ){
+		//ASCII alphanumeric bytes neither change the word type nor end a
+		//word, so whole runs of them are skipped in one step. A pending
+		//dot needs the case of the letter after it, which is read below
+		if( !isDotPending(state) ){
+			size_t run_end = DelimiterScanner::findNonAlphanumeric(chunk.data() + current, chunk_end) - chunk.data();
+			if( run_end != current ){
+				state = step(state, OtherAlphanumeric).next_state;
+				current = run_end;
+			}
 
-	char c;
-	while( stream.get(c) ){
-		if( isWhitespace(c) ){
-			if( chunk.size() ){
+			if( current == chunk.size() ){
 				break;
 			}
-
-		} else{
-			chunk.push_back(c);
 		}
-	}
 
-	return chunk;
-}
+		Character character = readCharacter<encoding>(chunk, current);
+		Transition transition = step(state, toInput(character.character_class));
 
-static bool nextLetterIsLowercase(std::string::const_iterator current, const std::string &chunk)
-{
-	std::string::const_iterator next = current != chunk.end() ? current + 1 : chunk.end();
+		switch( transition.action ){
+		case Action::EndBeforeCurrent:
+			return current;
+		case Action::EndBeforePendingDot:
+			return current - 1;
+		default:
+			break;
+		}
 
-	if( next != chunk.end() && std::isalpha(static_cast<unsigned char>(*next)) ){
-		return std::islower(*next);
+		state = transition.next_state;
+		current += character.size;
 	}
 
-	return false;
+	return step(state, EndOfChunk).action == Action::EndBeforePendingDot ? chunk.size() - 1 : chunk.size();
 }
 
-namespace EndCalculatorFactory
+template <TextEncoding encoding>
+static Token splitNextToken(std::string_view &chunk)
 {
+	Character first = readCharacter<encoding>(chunk, 0);
 
-	std::unique_ptr<ElementEndCalculator> getCalculator(std::string::const_iterator start,
-		const std::string &document_chunk)
-	{
-		std::unique_ptr<ElementEndCalculator> calculator;
+	//A symbol always consists of a single character
+	Token::Kind kind = first.character_class & Alphanumeric ? Token::Kind::Word : Token::Kind::Symbol;
+	size_t end = kind == Token::Kind::Symbol ? first.size : findEndOfWord<encoding>(chunk, 0);
 
-		if( isSymbol(*start) ){
-			calculator = std::make_unique<SymbolEndCalculator>(start, document_chunk);
-		} else{
-			calculator = std::make_unique<WordEndCalculator>(start, document_chunk);
-		}
+	Token token(kind, chunk.substr(0, end));
+	chunk.remove_prefix(end);
+	return token;
+}
+//END OF INTERNAL AUX FUNCTIONS
 
-		return calculator;
-	}
+} //END OF ANONYMOUS NAMESPACE
+//END OF INTERNAL AUX CLASSES AND FUNCTIONS
 
-}
 
-static std::string::const_iterator findEndOfElement(std::string::const_iterator current,
-	const std::string &chunk)
+//INTERNAL CLASS DEFINITIONS
+void TextDocumentTraveller::Impl::open(std::unique_ptr<ByteSource> source, SourceDecoding decoding)
 {
-	std::unique_ptr<ElementEndCalculator> calculator = EndCalculatorFactory::getCalculator(current, chunk);
-	return calculator->calcEndOfDocumentElement();
+	//Compressed documents are decoded on the fly, on a thread of their own
+	m_source = decoding == SourceDecoding::Detect ? ByteSource::makeDecompressing(std::move(source)) : std::move(source);
+
+	//Documents already in memory are split in place, without any copy
+	if( std::optional<std::string_view> view = m_source->contiguousView() ){
+		m_unread_bytes = *view;
+		m_source_exhausted = true;
+	}
 }
 
-static DocumentElement evaluate(const std::string::const_iterator &begin,
-	const std::string::const_iterator &end)
+bool TextDocumentTraveller::Impl::hasNext()
 {
-	if( std::distance(begin, end) == 1 && isSymbol(*begin) ){
-		return Symbol(*begin);
-	} else{
-		return Word(begin, end);
+	if( m_parse_buffer.empty() ){
+		fillBuffer();
 	}
+
+	return m_parse_buffer.size();
 }
 
-static std::deque<DocumentElement> splitChunkIntoDocumentElements(const std::string &chunk)
+Token TextDocumentTraveller::Impl::getNextToken()
 {
-	std::deque<DocumentElement> parsed_elements;
-
-	std::string::const_iterator start = chunk.begin();
-	std::string::const_iterator end = findEndOfElement(start, chunk);
+	Token next;
 
-	while( end != chunk.end() ){
-		parsed_elements << evaluate(start, end);
-		start = end;
-		end = findEndOfElement(start, chunk);
+	if( m_parse_buffer.empty() ){
+		fillBuffer();
 	}
 
-	if( start != chunk.end() ){
-		parsed_elements << evaluate(start, end);
+	if( m_parse_buffer.size() ){
+		next = m_parse_buffer.pop();
 	}
 
-	return parsed_elements;
+	return next;
 }
-//END OF INTERNAL AUX FUNCTIONS
 
-
-//INTERNAL AUX CLASS DEFINITIONS
-ElementEndCalculator::ElementEndCalculator(const std::string::const_iterator &start,
-							 const std::string &document_chunk) : m_element_start(start), 
-																  m_document_chunk(document_chunk)
+size_t TextDocumentTraveller::Impl::next(std::span<Token> out)
 {
+	fillBuffer();
+	return m_parse_buffer.popInto(out);
 }
 
-SymbolEndCalculator::SymbolEndCalculator(const std::string::const_iterator &start,
-										 const std::string &document_chunk) : ElementEndCalculator(start, document_chunk)
+void TextDocumentTraveller::Impl::fillBuffer()
 {
-}
+	while( !m_parse_buffer.full() ){
+		if( m_unsplit_chunk.empty() ){
+			takeNextChunk();
+		}
 
-ElementEndCalculator::CharacterHandling SymbolEndCalculator::checkCharacter(const std::string::const_iterator &current)
-{
-	return current == getStart() + 1 ? CharacterHandling::MarkAsEnd : CharacterHandling::Consume;
-}
+		if( m_unsplit_chunk.size() ){
+			m_parse_buffer.push(splitUnsplitChunk());
 
-WordEndCalculator::WordEndCalculator(const std::string::const_iterator &start,
-									 const std::string &document_chunk) : ElementEndCalculator(start, document_chunk)
-{
+		//Buffered tokens view the current bytes, so these can only be
+		//replaced once every token has been handed out
+		} else if( !m_parse_buffer.empty() || !loadMoreBytes() ){
+			break;
+		}
+	}
 }
 
-ElementEndCalculator::CharacterHandling WordEndCalculator::checkCharacter(const std::string::const_iterator &current)
+Generator<Token> TextDocumentTraveller::Impl::elements()
 {
-	updateWordType(current);
+	//Tokens already buffered by the pull interface come first
+	while( m_parse_buffer.size() ){
+		co_yield m_parse_buffer.pop();
+	}
 
-	switch( m_type ){
-	case WordType::EnglishWord:
-		return isWordTerminatingCharacter(*current) ? CharacterHandling::MarkAsEnd : CharacterHandling::Consume;
-	case WordType::Abbreviation:
-		return canTerminateAbbreviation(current) ? CharacterHandling::MarkAsEnd : CharacterHandling::Consume;
+	//A yielded token is used before the coroutine resumes, so the bytes can
+	//be replaced as soon as the chunk is split, without any buffering
+	while( true ){
+		if( m_unsplit_chunk.empty() ){
+			takeNextChunk();
+		}
 
-	default:
-		return CharacterHandling::Consume;
+		if( m_unsplit_chunk.size() ){
+			co_yield splitUnsplitChunk();
+		} else if( !loadMoreBytes() ){
+			co_return;
+		}
 	}
 }
 
-void WordEndCalculator::updateWordType(const std::string::const_iterator &current)
+Token TextDocumentTraveller::Impl::splitUnsplitChunk()
 {
-	if( isSymbol(*current) && !isWordTerminatingCharacter(*current) ){
-		m_type = WordType::SpecialCharacters;
-	} else if( isDot(*current) && nextLetterIsLowercase(current, getDocumentChunk()) ){
-		m_type = WordType::Abbreviation;
+	//Pure ASCII chunks are split the same under both encodings
+	if( m_unsplit_chunk_is_ascii ){
+		return splitNextToken<TextEncoding::Ascii>(m_unsplit_chunk);
+	} else{
+		return splitNextToken<TextEncoding::Utf8>(m_unsplit_chunk);
 	}
 }
 
-std::string::const_iterator ElementEndCalculator::calcEndOfDocumentElement()
+void TextDocumentTraveller::Impl::takeNextChunk()
 {
-	auto current = getStart();
-	std::string::const_iterator end = getDocumentChunk().end();
+	m_unsplit_chunk = getNextChunk(m_unread_bytes);
 
-	while( current != end && checkCharacter(current) == CharacterHandling::Consume ){
-		++current;
+	if( m_encoding == TextEncoding::Ascii ){
+		return;
 	}
 
-	return current;
-}
+	//The next non ASCII byte is searched once for a whole run of ASCII
+	//chunks, only chunks reaching it take the decoding path
+	const char *chunk_end = m_unsplit_chunk.data() + m_unsplit_chunk.size();
 
-const std::string::const_iterator &ElementEndCalculator::getStart() const
-{
-	return m_element_start;
-}
-const std::string &ElementEndCalculator::getDocumentChunk() const
-{
-	return m_document_chunk;
-}
-//END OFINTERNAL AUX CLASS DEFINITIONS
-
-} //END OF ANONYMOUS NAMESPACE
-//END OF INTERNAL AUX CLASSES AND FUNCTIONS
-
-
-//INTERNAL CLASS DEFINITIONS
-TextDocumentTraveller::Impl::~Impl()
-{
-	if( m_file_stream.is_open() ){
-		m_file_stream.close();
+	if( !m_next_non_ascii || m_next_non_ascii < m_unsplit_chunk.data() ){
+		m_next_non_ascii = DelimiterScanner::findNonAscii(m_unsplit_chunk.data(), m_unread_bytes.data() + m_unread_bytes.size());
 	}
-}
 
-void TextDocumentTraveller::Impl::openFile(const std::string &filepath)
-{
-	m_file_stream.open(filepath);
+	m_unsplit_chunk_is_ascii = m_next_non_ascii >= chunk_end;
 }
 
-bool TextDocumentTraveller::Impl::hasNext()
+bool TextDocumentTraveller::Impl::loadMoreBytes()
 {
-	if( m_parse_buffer.empty() ){
-		fillBuffer();
+	if( m_source_exhausted ){
+		return false;
 	}
 
-	return m_parse_buffer.size();
-}
+	//A chunk may continue in the next block, so the bytes after the last
+	//whitespace of the previous block are moved in front of the new ones
+	size_t carried_size = m_block_size - m_block_split_size;
+	m_next_non_ascii = nullptr;
+	std::copy_n(m_block.begin() + m_block_split_size, carried_size, m_block.begin());
+	m_block_size = carried_size;
 
-DocumentElement TextDocumentTraveller::Impl::getNext()
-{
-	DocumentElement next;
+	//The carried bytes hold no whitespace, so only new bytes are searched
+	size_t searched_size = carried_size;
 
-	if( m_parse_buffer.empty() ){
-		fillBuffer();
-	}
+	while( readBlock(m_block_size) ){
+		const char *block_begin = m_block.data();
+		const char *last_whitespace = findLastWhitespace(block_begin + searched_size, block_begin + m_block_size);
 
-	if( m_parse_buffer.size() ){
-		next = m_parse_buffer.front();
-		m_parse_buffer.pop_front();
+		if( last_whitespace != block_begin + m_block_size ){
+			m_block_split_size = last_whitespace - block_begin + 1;
+			m_unread_bytes = std::string_view(block_begin, m_block_split_size);
+			return true;
+		}
+
+		searched_size = m_block_size;
 	}
 
-	return next;
+	//End of document: whatever is left is complete
+	m_source_exhausted = true;
+	m_block_split_size = m_block_size;
+	m_unread_bytes = std::string_view(m_block.data(), m_block_size);
+	return m_block_size;
 }
 
-void TextDocumentTraveller::Impl::fillBuffer()
+bool TextDocumentTraveller::Impl::readBlock(size_t read_offset)
 {
-	if( !m_file_stream.is_open() ){
-		return;
+	if( m_block.size() < read_offset + ReadBlockSize ){
+		m_block.resize(read_offset + ReadBlockSize);
 	}
 
-	for( size_t i = 0; i < BufferedChunksSize; i++ ){
-		std::string chunk = getNextChunk(m_file_stream);
-
-		if( chunk.size() ){
-			m_parse_buffer << splitChunkIntoDocumentElements(chunk);
-		} else {
-			break;
-		}
-	}
+	size_t read_size = m_source->read(m_block.data() + read_offset, ReadBlockSize);
+	m_block_size = read_offset + read_size;
+	return read_size;
 }
 //END OF INTERNAL CLASS DEFINITIONS`
 
@@ -409,13 +357,59 @@ char Symbol::get() const
 	return m_value;
 }
 
+//==========================================================================|
+//								  Token										|
+//==========================================================================|
+Token::Token(Kind kind, std::string_view text) : m_text(text), m_kind(kind)
+{
+}
+
+Token::Kind Token::kind() const
+{
+	return m_kind;
+}
+
+bool Token::isWord() const
+{
+	return m_kind == Kind::Word;
+}
+
+bool Token::isSymbol() const
+{
+	return m_kind == Kind::Symbol;
+}
+
+std::string_view Token::text() const
+{
+	return m_text;
+}
+
+Symbol Token::symbol() const
+{
+	return m_text.size() ? Symbol(m_text.front()) : Symbol();
+}
+
+DocumentElement Token::materialize() const
+{
+	if( isSymbol() ){
+		return symbol();
+	} else{
+		return Word(m_text);
+	}
+}
+
 //==========================================================================|
 //							DocumentTraveller								|
 //==========================================================================|
-TextDocumentTraveller::TextDocumentTraveller(const std::string &filepath)
+TextDocumentTraveller::TextDocumentTraveller(const std::string &filepath, ReadMode mode, TextEncoding encoding)
+	: TextDocumentTraveller(ByteSource::makeFromFile(filepath, mode), encoding)
 {
-	m_impl = std::make_unique<Impl>();
-	m_impl->openFile(filepath);
+}
+
+TextDocumentTraveller::TextDocumentTraveller(std::unique_ptr<ByteSource> source, TextEncoding encoding, SourceDecoding decoding)
+{
+	m_impl = std::make_unique<Impl>(encoding);
+	m_impl->open(std::move(source), decoding);
 }
 
 TextDocumentTraveller::~TextDocumentTraveller()
@@ -429,17 +423,36 @@ bool TextDocumentTraveller::hasNext()
 
 DocumentElement TextDocumentTraveller::getNext()
 {
-	return m_impl->getNext();
+	return m_impl->getNextToken().materialize();
+}
+
+Token TextDocumentTraveller::getNextToken()
+{
+	return m_impl->getNextToken();
+}
+
+size_t TextDocumentTraveller::next(std::span<Token> out)
+{
+	return m_impl->next(out);
+}
+
+Generator<Token> TextDocumentTraveller::elements()
+{
+	return m_impl->elements();
 }
 //END OF EXTERNAL CLASS DEFINITIONS
 
 //EXTERNAL FUNCTION DEFINITIONS
 bool changesSentence(const Symbol &symbol)
 {
-	return symbol.get() == '.' ||
-		   symbol.get() == '!' ||
-		   symbol.get() == '?' ||
-		   symbol.get() == ';';
+	return hasCharacterClass(symbol.get(), SentenceTerminating);
+}
+
+bool changesSentence(const Token &token)
+{
+	char32_t code_point;
+	Utf8::decode(token.text(), code_point);
+	return token.isSymbol() && (Utf8::classify(code_point) & SentenceTerminating);
 }
 //END OF EXTERNAL FUNCTION DEFINITIONS
 
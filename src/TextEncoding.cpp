@@ -0,0 +1,241 @@
+#include "TextEncoding.hpp"
+
+#include <array>
+
+#include "CharacterClasses.hpp"
+#include "DelimiterScanner.hpp"
+
+//INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+namespace
+{
+
+constexpr char32_t TableSize = 0x500;
+constexpr unsigned char Letter = Alphanumeric | Alphabetic;
+
+struct CodePointProperties
+{
+	unsigned char character_class = 0;
+	char16_t lowercase = 0;
+};
+
+using CodePointTable = std::array<CodePointProperties, TableSize>;
+
+//TABLE CONSTRUCTION
+constexpr void setLowercase(CodePointTable &table, char32_t first, char32_t last)
+{
+	for( char32_t code_point = first; code_point <= last; code_point++ ){
+		table[code_point].character_class = Letter | Lowercase;
+	}
+}
+
+constexpr void setUppercase(CodePointTable &table, char32_t first, char32_t last, char32_t lowercase_offset)
+{
+	for( char32_t code_point = first; code_point <= last; code_point++ ){
+		table[code_point].character_class = Letter | Uppercase;
+		table[code_point].lowercase = static_cast<char16_t>(code_point + lowercase_offset);
+	}
+}
+
+constexpr void setCaseless(CodePointTable &table, char32_t first, char32_t last, unsigned char character_class)
+{
+	for( char32_t code_point = first; code_point <= last; code_point++ ){
+		table[code_point].character_class = character_class;
+	}
+}
+
+//Blocks where an uppercase letter is directly followed by its lowercase one
+constexpr void setCasePairs(CodePointTable &table, char32_t first, char32_t last)
+{
+	for( char32_t code_point = first; code_point < last; code_point += 2 ){
+		setUppercase(table, code_point, code_point, 1);
+		setLowercase(table, code_point + 1, code_point + 1);
+	}
+}
+
+constexpr CodePointTable makeCodePointTable()
+{
+	CodePointTable table = {};
+
+	for( char32_t code_point = 0; code_point < 0x80; code_point++ ){
+		char c = static_cast<char>(code_point);
+		table[code_point].character_class = classify(c);
+		table[code_point].lowercase = hasCharacterClass(c, Uppercase) ? static_cast<char16_t>(code_point + 0x20) : 0;
+	}
+
+	//Latin-1 Supplement
+	setCaseless(table, 0xAA, 0xAA, Letter);
+	setLowercase(table, 0xB5, 0xB5);
+	setCaseless(table, 0xBA, 0xBA, Letter);
+	setUppercase(table, 0xC0, 0xD6, 0x20);
+	setUppercase(table, 0xD8, 0xDE, 0x20);
+	setLowercase(table, 0xDF, 0xF6);
+	setLowercase(table, 0xF8, 0xFF);
+	for( char32_t quote : {0xA1, 0xAB, 0xBB, 0xBF} ){
+		table[quote].character_class = WordTerminating;
+	}
+
+	//Latin Extended-A
+	setCasePairs(table, 0x100, 0x12F);
+	setUppercase(table, 0x130, 0x130, 'i' - 0x130);
+	setLowercase(table, 0x131, 0x131);
+	setCasePairs(table, 0x132, 0x137);
+	setLowercase(table, 0x138, 0x138);
+	setCasePairs(table, 0x139, 0x148);
+	setLowercase(table, 0x149, 0x149);
+	setCasePairs(table, 0x14A, 0x177);
+	setUppercase(table, 0x178, 0x178, 0xFF - 0x178);
+	setCasePairs(table, 0x179, 0x17E);
+	setLowercase(table, 0x17F, 0x17F);
+
+	//Latin Extended-B and IPA Extensions, the combining marks of
+	//decomposed accents belong to the word they follow
+	setCaseless(table, 0x180, 0x2AF, Letter);
+	setCaseless(table, 0x300, 0x36F, Alphanumeric);
+
+	//Greek, its question mark ends a sentence like ';' does
+	setCasePairs(table, 0x370, 0x373);
+	setCasePairs(table, 0x376, 0x377);
+	setLowercase(table, 0x37B, 0x37D);
+	table[0x37E].character_class = WordTerminating | SentenceTerminating;
+	table[0x387].character_class = WordTerminating;
+	setUppercase(table, 0x386, 0x386, 0x3AC - 0x386);
+	setUppercase(table, 0x388, 0x38A, 0x3AD - 0x388);
+	setUppercase(table, 0x38C, 0x38C, 0x3CC - 0x38C);
+	setUppercase(table, 0x38E, 0x38F, 0x3CD - 0x38E);
+	setLowercase(table, 0x390, 0x390);
+	setUppercase(table, 0x391, 0x3A1, 0x20);
+	setUppercase(table, 0x3A3, 0x3AB, 0x20);
+	setLowercase(table, 0x3AC, 0x3CE);
+	setCaseless(table, 0x3CF, 0x3D7, Letter);
+	setCasePairs(table, 0x3D8, 0x3EF);
+	setCaseless(table, 0x3F0, 0x3FF, Letter);
+
+	//Cyrillic
+	setUppercase(table, 0x400, 0x40F, 0x50);
+	setUppercase(table, 0x410, 0x42F, 0x20);
+	setLowercase(table, 0x430, 0x45F);
+	setCasePairs(table, 0x460, 0x481);
+	setCaseless(table, 0x483, 0x489, Alphanumeric);
+	setCasePairs(table, 0x48A, 0x4BF);
+	setUppercase(table, 0x4C0, 0x4C0, 0x4CF - 0x4C0);
+	setCasePairs(table, 0x4C1, 0x4CE);
+	setLowercase(table, 0x4CF, 0x4CF);
+	setCasePairs(table, 0x4D0, 0x4FF);
+
+	return table;
+}
+//END OF TABLE CONSTRUCTION
+
+constexpr CodePointTable CodePointPropertiesTable = makeCodePointTable();
+
+static bool isContinuationByte(unsigned char byte)
+{
+	return (byte & 0xC0) == 0x80;
+}
+}//ANONYMOUS NAMESPACE
+//END OF INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+
+
+
+//EXTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//									Utf8									|
+//==========================================================================|
+size_t Utf8::decode(std::string_view text, char32_t &code_point)
+{
+	code_point = ReplacementCharacter;
+
+	if( text.empty() ){
+		return 0;
+	}
+
+	unsigned char lead = static_cast<unsigned char>(text[0]);
+
+	if( lead < 0x80 ){
+		code_point = lead;
+		return 1;
+	}
+
+	size_t size = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 0;
+	if( size == 0 || lead > 0xF4 || text.size() < size ){
+		return 1;
+	}
+
+	char32_t decoded = lead & (0x7F >> size);
+	for( size_t i = 1; i < size; i++ ){
+		unsigned char byte = static_cast<unsigned char>(text[i]);
+
+		if( !isContinuationByte(byte) ){
+			return 1;
+		}
+		decoded = (decoded << 6) | (byte & 0x3F);
+	}
+
+	//Overlong forms, surrogates and values past the last plane are malformed
+	static constexpr char32_t SmallestOfSize[] = {0, 0, 0x80, 0x800, 0x10000};
+	if( decoded < SmallestOfSize[size] || (decoded >= 0xD800 && decoded <= 0xDFFF) || decoded > 0x10FFFF ){
+		return 1;
+	}
+
+	code_point = decoded;
+	return size;
+}
+
+void Utf8::encode(char32_t code_point, std::string &encoded)
+{
+	if( code_point < 0x80 ){
+		encoded.push_back(static_cast<char>(code_point));
+	} else if( code_point < 0x800 ){
+		encoded.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+		encoded.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+	} else if( code_point < 0x10000 ){
+		encoded.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+		encoded.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+		encoded.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+	} else{
+		encoded.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+		encoded.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+		encoded.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+		encoded.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+	}
+}
+
+unsigned char Utf8::classify(char32_t code_point)
+{
+	if( code_point < TableSize ){
+		return CodePointPropertiesTable[code_point].character_class;
+	}
+
+	switch( code_point ){
+	case 0x201C: //Double quotation marks
+	case 0x201D:
+		return WordTerminating;
+	case 0x2026: //Horizontal ellipsis
+		return WordTerminating | SentenceTerminating;
+	default:
+		return 0;
+	}
+}
+
+char32_t Utf8::toLowercase(char32_t code_point)
+{
+	if( code_point < TableSize && CodePointPropertiesTable[code_point].lowercase ){
+		return CodePointPropertiesTable[code_point].lowercase;
+	}
+
+	return code_point;
+}
+
+bool Utf8::isAscii(std::string_view text)
+{
+	const char *end = text.data() + text.size();
+	return DelimiterScanner::findNonAscii(text.data(), end) == end;
+}
+
+bool Utf8::startsWithUppercase(std::string_view text)
+{
+	char32_t code_point;
+	decode(text, code_point);
+	return classify(code_point) & Uppercase;
+}
+//END OF EXTERNAL CLASS DEFINITIONS
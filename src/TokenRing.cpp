@@ -0,0 +1,65 @@
+#include "TokenRing.hpp"
+
+#include <algorithm>
+
+//EXTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//								 TokenRing									|
+//==========================================================================|
+TokenRing::TokenRing(size_t capacity) : m_tokens(capacity)
+{
+}
+
+size_t TokenRing::capacity() const
+{
+	return m_tokens.size();
+}
+
+size_t TokenRing::size() const
+{
+	return m_size;
+}
+
+bool TokenRing::empty() const
+{
+	return m_size == 0;
+}
+
+bool TokenRing::full() const
+{
+	return m_size == m_tokens.size();
+}
+
+void TokenRing::push(const Token &token)
+{
+	m_tokens[wrap(m_head + m_size)] = token;
+	++m_size;
+}
+
+Token TokenRing::pop()
+{
+	Token front = m_tokens[m_head];
+	m_head = wrap(m_head + 1);
+	--m_size;
+	return front;
+}
+
+size_t TokenRing::popInto(std::span<Token> out)
+{
+	size_t count = std::min(out.size(), m_size);
+
+	//The popped range wraps at most once, so it is copied in two runs
+	size_t first_run = std::min(count, m_tokens.size() - m_head);
+	std::copy_n(m_tokens.begin() + m_head, first_run, out.begin());
+	std::copy_n(m_tokens.begin(), count - first_run, out.begin() + first_run);
+
+	m_head = wrap(m_head + count);
+	m_size -= count;
+	return count;
+}
+
+size_t TokenRing::wrap(size_t position) const
+{
+	return position < m_tokens.size() ? position : position - m_tokens.size();
+}
+//END OF EXTERNAL CLASS DEFINITIONS
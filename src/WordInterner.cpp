@@ -0,0 +1,213 @@
+#include "WordInterner.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+static constexpr size_t InitialSlotCount = 1 << 10;
+static constexpr size_t ArenaBlockSize = 1 << 16;
+static constexpr size_t ParallelSortThreshold = 1 << 16;
+
+//INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+namespace
+{
+
+static size_t hashWord(std::string_view word)
+{
+	return std::hash<std::string_view>()(word);
+}
+
+//The slot index comes from the low bits, the tag from the high ones
+static uint32_t makeHashTag(size_t hash)
+{
+	return static_cast<uint32_t>(hash >> 32);
+}
+
+//Sorts slice_count slices on threads of their own, then merges neighbouring
+//slices until a single sorted run is left
+template <typename Compare>
+static void sortInParallel(std::vector<WordId> &ids, size_t slice_count, Compare comes_before)
+{
+	std::vector<size_t> bounds;
+	for( size_t slice = 0; slice <= slice_count; slice++ ){
+		bounds.push_back(ids.size() / slice_count * slice);
+	}
+	bounds.back() = ids.size();
+
+	std::vector<std::thread> workers;
+	for( size_t slice = 1; slice < slice_count; slice++ ){
+		workers.emplace_back([&ids, &bounds, slice, comes_before](){
+			std::sort(ids.begin() + bounds[slice], ids.begin() + bounds[slice + 1], comes_before);
+		});
+	}
+	std::sort(ids.begin(), ids.begin() + bounds[1], comes_before);
+
+	for( std::thread &worker : workers ){
+		worker.join();
+	}
+
+	for( size_t width = 1; width < slice_count; width *= 2 ){
+		for( size_t slice = 0; slice + width < slice_count; slice += 2 * width ){
+			size_t last = std::min(slice + 2 * width, slice_count);
+			std::inplace_merge(ids.begin() + bounds[slice], ids.begin() + bounds[slice + width],
+							   ids.begin() + bounds[last], comes_before);
+		}
+	}
+}
+
+}
+//END OF INTERNAL AUXILIARY CLASSES AND FUNCTIONS
+
+
+//EXTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//								WordInterner								|
+//==========================================================================|
+WordInterner::WordInterner() : m_slots(InitialSlotCount)
+{
+}
+
+//The words of the copy are packed into an arena of its own. Interning them
+//in id order gives every word the id it had
+WordInterner::WordInterner(const WordInterner &other) : WordInterner()
+{
+	m_words.reserve(other.m_words.size());
+
+	for( std::string_view word : other.m_words ){
+		intern(word);
+	}
+}
+
+WordInterner &WordInterner::operator=(const WordInterner &other)
+{
+	if( this != &other ){
+		*this = WordInterner(other);
+	}
+
+	return *this;
+}
+
+size_t WordInterner::size() const
+{
+	return m_words.size();
+}
+
+bool WordInterner::empty() const
+{
+	return m_words.empty();
+}
+
+WordId WordInterner::intern(std::string_view word)
+{
+	size_t hash = hashWord(word);
+	size_t slot = findSlot(word, hash);
+
+	if( m_slots[slot].id != NoWord ){
+		return m_slots[slot].id;
+	}
+
+	WordId id = static_cast<WordId>(m_words.size());
+	m_words.push_back(store(word));
+	m_slots[slot] = Slot{makeHashTag(hash), id};
+
+	//Kept at most half full, so probe sequences stay short
+	if( m_words.size() * 2 > m_slots.size() ){
+		grow();
+	}
+
+	return id;
+}
+
+WordId WordInterner::find(std::string_view word) const
+{
+	return m_slots[findSlot(word, hashWord(word))].id;
+}
+
+std::string_view WordInterner::word(WordId id) const
+{
+	return m_words[id];
+}
+
+std::vector<WordId> WordInterner::sortedIds() const
+{
+	std::vector<WordId> ids(m_words.size());
+	for( WordId id = 0; id < ids.size(); id++ ){
+		ids[id] = id;
+	}
+
+	auto comes_before = [this](WordId first, WordId second){
+		return m_words[first] < m_words[second];
+	};
+
+	size_t slice_count = std::min<size_t>(std::thread::hardware_concurrency(), ids.size() / ParallelSortThreshold);
+
+	if( slice_count > 1 ){
+		sortInParallel(ids, slice_count, comes_before);
+	} else{
+		std::sort(ids.begin(), ids.end(), comes_before);
+	}
+
+	return ids;
+}
+
+//Linear probing from the slot the hash points at. Returns the slot of the
+//word, or the empty slot where it would be inserted
+size_t WordInterner::findSlot(std::string_view word, size_t hash) const
+{
+	size_t mask = m_slots.size() - 1;
+	uint32_t hash_tag = makeHashTag(hash);
+
+	for( size_t slot = hash & mask; ; slot = (slot + 1) & mask ){
+		const Slot &candidate = m_slots[slot];
+
+		if( candidate.id == NoWord ){
+			return slot;
+		} else if( candidate.hash_tag == hash_tag && m_words[candidate.id] == word ){
+			return slot;
+		}
+	}
+}
+
+//Bump allocation from the current block. Words longer than a block get a
+//block of their own size
+std::string_view WordInterner::store(std::string_view word)
+{
+	if( word.empty() ){
+		return std::string_view();
+	}
+
+	if( word.size() > m_block_remaining ){
+		size_t block_size = std::max(ArenaBlockSize, word.size());
+		m_blocks.push_back(std::make_unique_for_overwrite<char[]>(block_size));
+		m_block_free = m_blocks.back().get();
+		m_block_remaining = block_size;
+	}
+
+	char *stored = m_block_free;
+	std::memcpy(stored, word.data(), word.size());
+	m_block_free += word.size();
+	m_block_remaining -= word.size();
+
+	return std::string_view(stored, word.size());
+}
+
+void WordInterner::grow()
+{
+	std::vector<Slot> slots(m_slots.size() * 2);
+	size_t mask = slots.size() - 1;
+
+	for( WordId id = 0; id < m_words.size(); id++ ){
+		size_t hash = hashWord(m_words[id]);
+		size_t slot = hash & mask;
+
+		while( slots[slot].id != NoWord ){
+			slot = (slot + 1) & mask;
+		}
+
+		slots[slot] = Slot{makeHashTag(hash), id};
+	}
+
+	m_slots = std::move(slots);
+}
+//END OF EXTERNAL CLASS DEFINITIONS
@@ -15,6 +15,25 @@ static void toLowercase(Word &word)
 	std::transform(word.begin(), word.end(), word.begin(), convert_to_lowercase);
 }
 
+static void toLowercaseUtf8(std::string_view word, Word &lowercase)
+{
+	lowercase.clear();
+
+	while( word.size() ){
+		char32_t code_point;
+		size_t size = Utf8::decode(word, code_point);
+
+		//Malformed bytes are kept as they are
+		if( code_point == Utf8::ReplacementCharacter && size == 1 ){
+			lowercase.push_back(word.front());
+		} else{
+			Utf8::encode(Utf8::toLowercase(code_point), lowercase);
+		}
+
+		word.remove_prefix(size);
+	}
+}
+
 static bool isAlphanumeric(char c)
 {
 	return std::isalnum(static_cast<unsigned char>(c));
@@ -30,12 +49,23 @@ static bool isAlphanumeric(char c)
 //==========================================================================|
 //								WordSanitizer								|
 //==========================================================================|
-Word WordSanitizer::sanitize(const Word &word)
+Word WordSanitizer::sanitize(std::string_view word, TextEncoding encoding)
 {
-	Word sanitized = word;
-	toLowercase(sanitized);
+	Word sanitized;
+	sanitize(word, sanitized, encoding);
 	return sanitized;
 }
+
+void WordSanitizer::sanitize(std::string_view word, Word &sanitized, TextEncoding encoding)
+{
+	if( encoding == TextEncoding::Utf8 && !Utf8::isAscii(word) ){
+		toLowercaseUtf8(word, sanitized);
+		return;
+	}
+
+	sanitized.assign(word);
+	toLowercase(sanitized);
+}
 //END OF INTERNAL CLASS DEFINITIONS
 
 
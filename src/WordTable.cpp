@@ -0,0 +1,58 @@
+#include "WordTable.hpp"
+
+//EXTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//								 WordTable									|
+//==========================================================================|
+size_t WordTable::size() const
+{
+	return m_words.size();
+}
+
+bool WordTable::empty() const
+{
+	return m_words.empty();
+}
+
+Occurrences &WordTable::findOrInsert(std::string_view word)
+{
+	return m_postings[insert(word)];
+}
+
+const Occurrences *WordTable::find(std::string_view word) const
+{
+	WordId id = m_words.find(word);
+	return id != WordInterner::NoWord ? &m_postings[id] : nullptr;
+}
+
+WordId WordTable::insert(std::string_view word)
+{
+	WordId id = m_words.intern(word);
+
+	if( id == m_postings.size() ){
+		m_postings.emplace_back();
+	}
+
+	return id;
+}
+
+std::string_view WordTable::word(WordId id) const
+{
+	return m_words.word(id);
+}
+
+Occurrences &WordTable::occurrences(WordId id)
+{
+	return m_postings[id];
+}
+
+const Occurrences &WordTable::occurrences(WordId id) const
+{
+	return m_postings[id];
+}
+
+std::vector<WordId> WordTable::sortedIds() const
+{
+	return m_words.sortedIds();
+}
+//END OF EXTERNAL CLASS DEFINITIONS
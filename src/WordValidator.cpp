@@ -2,13 +2,41 @@
 
 #include <algorithm>
 
+#include "CharacterClasses.hpp"
+
 //INTERNAL AUXILIARY CLASSES AND FUNCTIONS
 static bool shouldBeIgnoredInValidations(char c)
 {
 	return c == '.' || c == '\'';
 }
 
-static bool containsIllegalSymbols(const Word &word)
+static bool shouldBeIgnoredInValidations(char32_t code_point)
+{
+	//The typographic apostrophe of "don’t" counts as an apostrophe
+	return code_point == '.' || code_point == '\'' || code_point == 0x2019;
+}
+
+//Same checks as below, over code points instead of bytes
+static bool isValidUtf8(std::string_view word)
+{
+	bool contains_letter = false;
+
+	while( word.size() ){
+		char32_t code_point;
+		word.remove_prefix(Utf8::decode(word, code_point));
+
+		unsigned char character_class = Utf8::classify(code_point);
+		if( !(character_class & Alphanumeric) && !shouldBeIgnoredInValidations(code_point) ){
+			return false;
+		}
+
+		contains_letter = contains_letter || (character_class & Alphabetic);
+	}
+
+	return contains_letter;
+}
+
+static bool containsIllegalSymbols(std::string_view word)
 {
 	auto is_illegal = [](char c){
 		return !std::isalnum(static_cast<unsigned char>(c)) && !shouldBeIgnoredInValidations(c);
@@ -17,7 +45,7 @@ static bool containsIllegalSymbols(const Word &word)
 	return std::any_of(word.begin(), word.end(), is_illegal);
 }
 
-static bool areAlphabeticalCharactersMissing(const Word &word)
+static bool areAlphabeticalCharactersMissing(std::string_view word)
 {
 	auto is_alphabetical = [](char c){
 		return std::isalpha(static_cast<unsigned char>(c));
@@ -30,12 +58,16 @@ static bool areAlphabeticalCharactersMissing(const Word &word)
 
 
 //EXTERNAL CLASS DEFINITIONS
-bool WordValidator::isValid(const Word &word)
+bool WordValidator::isValid(std::string_view word, TextEncoding encoding)
 {
 	if( word.empty() ){
 		return false;
 	}
 
+	if( encoding == TextEncoding::Utf8 && !Utf8::isAscii(word) ){
+		return isValidUtf8(word);
+	}
+
 	if( containsIllegalSymbols(word) ){
 		return false;
 	}
@@ -0,0 +1,206 @@
+#include "WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+//INTERNAL CLASS DECLARATIONS
+//==========================================================================|
+//							WorkStealingPool::Impl							|
+//==========================================================================|
+class WorkStealingPool::Impl
+{
+public:
+	Impl(size_t thread_count);
+	~Impl();
+
+	size_t threadCount() const;
+	void run(size_t task_count, const Task &task);
+
+private:
+	//Aligned so the locks of neighbouring queues never share a cache line
+	struct alignas(64) Queue
+	{
+		std::mutex mutex;
+		std::deque<size_t> tasks;
+	};
+
+	void work(size_t thread);
+	void runTasks(size_t thread);
+	std::optional<size_t> nextTask(size_t thread);
+	std::optional<size_t> popOwn(size_t thread);
+	std::optional<size_t> steal(size_t thread);
+
+private:
+	std::vector<Queue> m_queues;
+	std::vector<std::thread> m_workers;
+
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	const Task *m_task = nullptr;
+	size_t m_generation = 0;
+	bool m_stopping = false;
+	std::atomic<size_t> m_pending = 0;
+};
+//END OF INTERNAL CLASS DECLARATIONS
+
+
+//INTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//							WorkStealingPool::Impl							|
+//==========================================================================|
+//Queue 0 belongs to the thread calling run, the others to the workers
+WorkStealingPool::Impl::Impl(size_t thread_count) : m_queues(std::max<size_t>(thread_count, 1))
+{
+	for( size_t thread = 1; thread < m_queues.size(); thread++ ){
+		m_workers.emplace_back(&Impl::work, this, thread);
+	}
+}
+
+WorkStealingPool::Impl::~Impl()
+{
+	{
+		std::lock_guard lock(m_mutex);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+
+	for( std::thread &worker : m_workers ){
+		worker.join();
+	}
+}
+
+size_t WorkStealingPool::Impl::threadCount() const
+{
+	return m_queues.size();
+}
+
+void WorkStealingPool::Impl::run(size_t task_count, const Task &task)
+{
+	if( task_count == 0 ){
+		return;
+	}
+
+	{
+		std::lock_guard lock(m_mutex);
+		m_task = &task;
+		m_pending = task_count;
+
+		for( size_t thread = 0; thread < m_queues.size(); thread++ ){
+			std::lock_guard queue_lock(m_queues[thread].mutex);
+			for( size_t next = task_count * thread / m_queues.size(); next < task_count * (thread + 1) / m_queues.size(); next++ ){
+				m_queues[thread].tasks.push_back(next);
+			}
+		}
+
+		++m_generation;
+	}
+	m_wake.notify_all();
+
+	runTasks(0);
+
+	std::unique_lock lock(m_mutex);
+	m_done.wait(lock, [this](){ return m_pending == 0; });
+	m_task = nullptr;
+}
+
+void WorkStealingPool::Impl::work(size_t thread)
+{
+	size_t seen_generation = 0;
+
+	while( true ){
+		{
+			std::unique_lock lock(m_mutex);
+			m_wake.wait(lock, [this, seen_generation](){ return m_stopping || m_generation != seen_generation; });
+
+			if( m_stopping ){
+				return;
+			}
+			seen_generation = m_generation;
+		}
+
+		runTasks(thread);
+	}
+}
+
+//Tasks are only handed out while run waits for them, so m_task stays valid
+void WorkStealingPool::Impl::runTasks(size_t thread)
+{
+	while( std::optional<size_t> task = nextTask(thread) ){
+		(*m_task)(*task);
+
+		if( --m_pending == 0 ){
+			std::lock_guard lock(m_mutex);
+			m_done.notify_all();
+		}
+	}
+}
+
+std::optional<size_t> WorkStealingPool::Impl::nextTask(size_t thread)
+{
+	std::optional<size_t> task = popOwn(thread);
+	return task ? task : steal(thread);
+}
+
+std::optional<size_t> WorkStealingPool::Impl::popOwn(size_t thread)
+{
+	Queue &queue = m_queues[thread];
+	std::lock_guard lock(queue.mutex);
+
+	if( queue.tasks.empty() ){
+		return std::nullopt;
+	}
+
+	size_t task = queue.tasks.front();
+	queue.tasks.pop_front();
+	return task;
+}
+
+//Victims are visited starting from the next thread, so thieves spread out
+std::optional<size_t> WorkStealingPool::Impl::steal(size_t thread)
+{
+	for( size_t step = 1; step < m_queues.size(); step++ ){
+		Queue &victim = m_queues[(thread + step) % m_queues.size()];
+		std::lock_guard lock(victim.mutex);
+
+		if( !victim.tasks.empty() ){
+			size_t task = victim.tasks.back();
+			victim.tasks.pop_back();
+			return task;
+		}
+	}
+
+	return std::nullopt;
+}
+//END OF INTERNAL CLASS DEFINITIONS
+
+
+//EXTERNAL CLASS DEFINITIONS
+//==========================================================================|
+//							  WorkStealingPool								|
+//==========================================================================|
+WorkStealingPool::WorkStealingPool(size_t thread_count)
+{
+	m_impl = std::make_unique<Impl>(thread_count ? thread_count : std::thread::hardware_concurrency());
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+}
+
+size_t WorkStealingPool::threadCount() const
+{
+	return m_impl->threadCount();
+}
+
+void WorkStealingPool::run(size_t task_count, const Task &task)
+{
+	m_impl->run(task_count, task);
+}
+//END OF EXTERNAL CLASS DEFINITIONS
@@ -0,0 +1,90 @@
+#ifndef BYTESOURCE_HPP
+#define BYTESOURCE_HPP
+
+//Include Headers
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+//==========================================================================|
+//								  ReadMode									|
+//==========================================================================|
+// @brief: Selects how the document bytes are read. MemoryMapped walks the	|
+//		   mapped file directly and falls back to Stream for anything		|
+//		   that is not a regular file (pipes, devices etc)					|
+//==========================================================================|
+enum class ReadMode
+{
+	Stream,
+	MemoryMapped,
+};
+
+//==========================================================================|
+//								Compression									|
+//==========================================================================|
+// @brief: Compression formats recognised by their magic bytes. Decoding	|
+//		   depends on the libraries (zlib, libzstd) found at configure time	|
+//==========================================================================|
+enum class Compression
+{
+	None,
+	Gzip,
+	Zstd,
+};
+
+//==========================================================================|
+//							  ReadAheadOptions								|
+//==========================================================================|
+// @brief: Knobs of the read-ahead stage. block_size is the size of each	|
+//		   read issued to the wrapped source and queue_depth how many		|
+//		   blocks may be loaded ahead of the reader							|
+//==========================================================================|
+struct ReadAheadOptions
+{
+	size_t block_size = 1 << 20;
+	size_t queue_depth = 2;
+};
+
+//==========================================================================|
+//								 ByteSource									|
+//==========================================================================|
+// @brief: Origin of the bytes of a text document. Readers pull large		|
+//		   blocks through read() until it returns 0. Sources which already	|
+//		   hold the whole document in memory (mapped files, strings) also	|
+//		   expose it as a contiguous view, so it can be tokenized in place	|
+//==========================================================================|
+class ByteSource
+{
+public:
+	virtual ~ByteSource() {}
+
+	virtual size_t read(char *buffer, size_t capacity) = 0;
+	virtual std::optional<std::string_view> contiguousView() const;
+
+	//Hands back bytes of the contiguous view a reader is done with. A
+	//mapped file drops their pages, which are read again if touched, any
+	//other source keeps them
+	virtual void release(std::string_view bytes) const;
+
+	static std::unique_ptr<ByteSource> makeFromFile(const std::string &filepath, ReadMode mode = ReadMode::MemoryMapped);
+	static std::unique_ptr<ByteSource> makeFromStdin();
+	static std::unique_ptr<ByteSource> makeFromPipe(const std::string &command);
+	static std::unique_ptr<ByteSource> makeFromMemory(std::string text);
+	static std::unique_ptr<ByteSource> makeFromView(std::string_view text);
+
+	//Wraps source so that a background thread keeps the next blocks loaded
+	//while the current one is consumed. Sources with a contiguous view are
+	//already in memory and are returned unwrapped
+	static std::unique_ptr<ByteSource> makeReadAhead(std::unique_ptr<ByteSource> source,
+		const ReadAheadOptions &options = ReadAheadOptions());
+
+	//Detects compressed input by its magic bytes and returns a source of the
+	//decoded bytes. Decoding runs on a read-ahead thread, so it overlaps with
+	//the consumer. Uncompressed input, or input whose format is not
+	//supported by this build, is returned unchanged
+	static std::unique_ptr<ByteSource> makeDecompressing(std::unique_ptr<ByteSource> source);
+	static bool isSupported(Compression compression);
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef CHARACTERCLASSES_HPP
+#define CHARACTERCLASSES_HPP
+
+//Include Headers
+#include <array>
+
+//==========================================================================|
+//							  CharacterClass								|
+//==========================================================================|
+// @brief: Bit flags describing the role of a byte during tokenization.	|
+//		   Alphanumeric, Alphabetic and Lowercase follow the "C" locale of	|
+//		   std::isalnum, std::isalpha and std::islower, so bytes outside	|
+//		   ASCII carry no flag at all									|
+//==========================================================================|
+enum CharacterClass : unsigned char
+{
+	Whitespace			= 1 << 0,
+	Alphanumeric		= 1 << 1,
+	Alphabetic			= 1 << 2,
+	Lowercase			= 1 << 3,
+	Uppercase			= 1 << 4,
+	Dot					= 1 << 5,
+	WordTerminating		= 1 << 6,
+	SentenceTerminating	= 1 << 7,
+};
+
+//==========================================================================|
+//							CharacterClassTable								|
+//==========================================================================|
+// @brief: 256 entry lookup table, built at compile time, which replaces	|
+//		   the comparison chains of the tokenizer with one load per byte	|
+//==========================================================================|
+constexpr std::array<unsigned char, 256> makeCharacterClassTable()
+{
+	std::array<unsigned char, 256> table = {};
+
+	for( int c = '0'; c <= '9'; c++ ){
+		table[c] |= Alphanumeric;
+	}
+
+	for( int c = 'a'; c <= 'z'; c++ ){
+		table[c] |= Alphanumeric | Alphabetic | Lowercase;
+	}
+
+	for( int c = 'A'; c <= 'Z'; c++ ){
+		table[c] |= Alphanumeric | Alphabetic | Uppercase;
+	}
+
+	for( unsigned char c : {' ', '\n', '\t'} ){
+		table[c] |= Whitespace;
+	}
+
+	for( unsigned char c : {'.', '!', '?', ',', '(', ')', '[', ']', '{', '}', ';', ':', '"', '<', '>'} ){
+		table[c] |= WordTerminating;
+	}
+
+	for( unsigned char c : {'.', '!', '?', ';'} ){
+		table[c] |= SentenceTerminating;
+	}
+
+	table[static_cast<unsigned char>('.')] |= Dot;
+	return table;
+}
+
+inline constexpr std::array<unsigned char, 256> CharacterClassTable = makeCharacterClassTable();
+
+constexpr unsigned char classify(char c)
+{
+	return CharacterClassTable[static_cast<unsigned char>(c)];
+}
+
+constexpr bool hasCharacterClass(char c, unsigned char character_classes)
+{
+	return classify(c) & character_classes;
+}
+
+#endif
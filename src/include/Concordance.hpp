@@ -3,9 +3,19 @@
 
 //Include Headers
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <functional>
+#include <optional>
+
+#include "HeavyHitters.hpp"
+#include "MemoryMappedFile.hpp"
+#include "Occurrences.hpp"
+#include "TextEncoding.hpp"
+
+//Forward Declarations
+class ByteSource;
 
 //Typedefs
 using Sentence = size_t;
@@ -13,20 +23,48 @@ using Word = std::string;
 using WordIndex = size_t;
 
 //==========================================================================|
-//								Occurrences									|
+//							 ConcordanceEngine								|
 //==========================================================================|
-// @brief: Object which holds the sentences of a found word					|
+// @brief: Selects how the words of a concordance are stored while it is	|
+//		   built. Hash keeps them in a WordTable and sorts them once, when	|
+//		   they are iterated. OrderedMap keeps them sorted in a std::map	|
+//		   all along. RadixTrie keeps them sorted in a RadixTrie, which		|
+//		   stores the prefixes words share only once. All of them produce	|
+//		   the same concordance												|
 //==========================================================================|
-
-class Occurrences
+enum class ConcordanceEngine
 {
-public:
-	const std::vector<Sentence> &get() const;
-	Occurrences &operator << (Sentence sentence);
-	bool operator == (const Occurrences &other) const;
+	Hash,
+	OrderedMap,
+	RadixTrie,
+};
 
-private:
-	std::vector<Sentence> m_occurrences;
+//==========================================================================|
+//								ParseOptions								|
+//==========================================================================|
+// @brief: Controls how a document is parsed. Documents already in memory	|
+//		   are split into shard_count whitespace aligned shards, which are	|
+//		   parsed in parallel. A shard_count of 0 uses one shard per		|
+//		   hardware thread. Shards are never smaller than min_shard_size,	|
+//		   so small documents are still parsed by the calling thread.		|
+//		   encoding selects how words are split, validated and lowercased	|
+//		   and engine how the concordance stores them						|
+//																			|
+//		   A max_memory other than 0 bounds the bytes the words being		|
+//		   parsed take, shared among the shards. Past it, they are spilled	|
+//		   as a sorted run to a file in spill_directory, or the temporary	|
+//		   directory when it is empty, and parsing goes on from an empty	|
+//		   concordance. The concordance returned then reads its runs back	|
+//		   through a k-way merge rather than loading them					|
+//==========================================================================|
+struct ParseOptions
+{
+	size_t shard_count = 0;
+	size_t min_shard_size = 1 << 20;
+	TextEncoding encoding = TextEncoding::Ascii;
+	ConcordanceEngine engine = ConcordanceEngine::Hash;
+	size_t max_memory = 0;
+	std::string spill_directory;
 };
 
 //==========================================================================|
@@ -39,9 +77,14 @@ private:
 class Concordance
 {
 public:
-	static Concordance makeEmpty();
+	static Concordance makeEmpty(ConcordanceEngine engine = ConcordanceEngine::Hash);
 	static Concordance makeFromSentences(const std::vector< std::vector<Word> > &sentences);
-	static Concordance makeFromFile(const std::string &filepaths);
+	static Concordance makeFromFile(const std::string &filepaths, const ParseOptions &options = ParseOptions());
+	static Concordance makeFromSource(std::unique_ptr<ByteSource> source, const ParseOptions &options = ParseOptions());
+
+	//Sentences are numbered on from one file to the next, in the order of
+	//filepaths. Files are parsed whole, shard_count of them at a time
+	static Concordance makeFromFiles(const std::vector<std::string> &filepaths, const ParseOptions &options = ParseOptions());
 
 	bool operator == (const Concordance &other) const;
 	bool operator != (const Concordance &other) const;
@@ -57,11 +100,70 @@ public:
 	using IteratorFunc = std::function<void(WordIndex, const Word &, const Occurrences &)>;
 	void forEachWord(const IteratorFunc &run_callback) const;
 
-	void add(const Word&, const Sentence&);
-	bool exists(const Word &) const;
+	//Only the words starting with prefix, or from first up to and
+	//excluding last, indexed from 1 in alphabetical order
+	void forEachWithPrefix(std::string_view prefix, const IteratorFunc &run_callback) const;
+	void forEachInRange(std::string_view first, std::string_view last, const IteratorFunc &run_callback) const;
+
+	void add(std::string_view word, const Sentence &sentence, TextEncoding encoding = TextEncoding::Ascii);
+	bool exists(std::string_view word) const;
+
+	//A copy of the sentences of word, nothing when it is not found. Like
+	//every other const method, it may be called from many threads at once
+	std::optional<Occurrences> lookup(std::string_view word) const;
+
+	//The k words occurring most often, with their exact counts. Ties are
+	//broken alphabetically
+	std::vector<WordCount> topWords(size_t k) const;
+
+	//Estimates the most frequent words of a document without building its
+	//concordance, in memory bounded by capacity whatever the vocabulary
+	static HeavyHitters countFrequentWords(std::unique_ptr<ByteSource> source, size_t capacity = HeavyHitters::DefaultCapacity,
+										   const ParseOptions &options = ParseOptions());
+
+	//The highest sentence holding a word, 0 when there is none
+	Sentence sentenceCount() const;
+
+	//Roughly the bytes the words added or merged in take in memory, which
+	//max_memory is checked against
+	size_t memoryEstimate() const;
+
+	//Adds the words of other, their sentences shifted by offset. Passing
+	//other as an rvalue consumes it and moves its lists instead of copying
+	void merge(const Concordance &other, Sentence offset = 0);
+	void merge(Concordance &&other, Sentence offset = 0);
+
+	//Merges every partial in one pass, partial i shifted by offsets[i].
+	//Partials past the end of offsets are shifted by the sentences of the
+	//partials before them, as if they were consecutive parts of a document.
+	//Partials which are read from files, like opened ones, are only joined
+	static Concordance merge(std::vector<Concordance> &&partials, std::vector<Sentence> offsets = {});
+
+	//save writes a ConcordanceIndex, which open maps back in. An opened
+	//concordance reads straight from the mapped index and only loads its
+	//words into engine when it is modified. A Random index keeps whatever
+	//its queries read in memory, a Sequential one is only read in passes
+	//and releases the pages behind them. Nothing is returned when the
+	//file is not a valid index
+	bool save(const std::string &filepath) const;
+	static std::optional<Concordance> open(const std::string &filepath, ConcordanceEngine engine = ConcordanceEngine::Hash,
+										   MappedAccess access = MappedAccess::Random);
+
+	//Brings the index at index_path up to date with a document which only
+	//grows at its end, parsing just the bytes appended since the index was
+	//written. Bytes after the last whitespace may be a word still being
+	//written, they are left for the next update. A document rewritten
+	//since, or a missing index, is indexed from scratch. Returns the
+	//updated index opened, nothing when the document cannot be read or the
+	//index could not be written
+	static std::optional<Concordance> updateIndex(const std::string &filepath, const std::string &index_path,
+												  const ParseOptions &options = ParseOptions());
 
 private:
-	Concordance();
+	friend class ConcurrentConcordance;
+
+	Concordance(ConcordanceEngine engine);
+	void addOccurrences(std::string_view word, Occurrences &&occurrences);
 
 private:
 	class Impl;
@@ -0,0 +1,146 @@
+#ifndef CONCORDANCEINDEX_HPP
+#define CONCORDANCEINDEX_HPP
+
+//Include Headers
+#include <cstdint>
+#include <cstdio>
+#include <iosfwd>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MemoryMappedFile.hpp"
+#include "Occurrences.hpp"
+#include "TextEncoding.hpp"
+
+//==========================================================================|
+//							  ConcordanceIndex								|
+//==========================================================================|
+// @brief: Binary file holding a concordance, read through a memory			|
+//		   mapping without being deserialized. A fixed header, checked for	|
+//		   its magic, version and byte order, is followed by three blocks:	|
+//		   an offsets table with one fixed size entry per word, sorted		|
+//		   alphabetically, the bytes of the words and the posting lists.	|
+//		   An entry points at its word and its posting list, which are the	|
+//		   gaps Occurrences are encoded in. Finding a word is a binary		|
+//		   search over the table, so opening an index only maps it and		|
+//		   reads its header, however large it is. The table ends with one	|
+//		   extra entry marking where the last posting list ends				|
+//																			|
+//		   An index built from a document which only grows at its end may	|
+//		   also record a Checkpoint, where parsing of the document stopped	|
+//		   and how its sentences stood there, so that a later run parses	|
+//		   only the bytes appended since									|
+//==========================================================================|
+class ConcordanceIndex
+{
+public:
+	static constexpr uint32_t Version = 3;
+	static constexpr size_t NoEntry = SIZE_MAX;
+
+	//The document was parsed up to document_offset, in the given encoding,
+	//and its next word belongs to sentence, or the one after it when it
+	//starts with a capital and changes_sentence is set. boundary_hash
+	//fingerprints the bytes right before the offset, telling a document
+	//which only grew from one which was rewritten
+	struct Checkpoint
+	{
+		uint64_t document_offset = 0;
+		uint64_t boundary_hash = 0;
+		Sentence sentence = 1;
+		bool changes_sentence = false;
+		TextEncoding encoding = TextEncoding::Ascii;
+	};
+
+	//Collects the words, which must come in alphabetical order, and lays
+	//the index out in memory until it is written. A block outgrowing
+	//buffer_size is moved on to a temporary file, so a writer holds about
+	//three buffers at most, however large the index
+	class Writer
+	{
+	public:
+		static constexpr size_t DefaultBufferSize = 1 << 21;
+
+		Writer(size_t buffer_size = DefaultBufferSize);
+		Writer(const Writer &other) = delete;
+		Writer &operator=(const Writer &other) = delete;
+
+		void add(std::string_view word, const Occurrences &occurrences);
+		//The index is written next to filepath and renamed over it, so an
+		//index may be written over the file it is mapped from
+		bool write(const std::string &filepath, Sentence sentence_count,
+				   const std::optional<Checkpoint> &checkpoint = std::nullopt) const;
+
+	private:
+		struct Block
+		{
+			std::string bytes;
+			std::unique_ptr<FILE, int (*)(FILE *)> spilled{nullptr, std::fclose};
+			uint64_t spilled_size = 0;
+
+			uint64_t size() const;
+		};
+
+		void spillIfFull(Block &block);
+		bool copyBlock(const Block &block, std::ostream &out) const;
+
+	private:
+		Block m_entries;
+		Block m_words;
+		Block m_postings;
+		size_t m_word_count = 0;
+		size_t m_buffer_size;
+		bool m_failed = false;
+	};
+
+	//Invalid when the file cannot be mapped or is not an index of this
+	//version. Indexes are mostly searched, passes over every word are
+	//better served by Sequential. Only a Sequential index is read once,
+	//so only its pages are ever released
+	static ConcordanceIndex makeFromFile(const std::string &filepath, MappedAccess access = MappedAccess::Random);
+
+	bool isValid() const;
+	size_t size() const;
+	Sentence sentenceCount() const;
+	const std::optional<Checkpoint> &checkpoint() const;
+
+	size_t find(std::string_view word) const;
+	size_t lowerBound(std::string_view word) const;
+
+	std::string_view word(size_t entry) const;
+	size_t occurrenceCount(size_t entry) const;
+	Occurrences occurrences(size_t entry) const;
+
+	//Releases the pages of the mapping only read for the entries from
+	//first up to last, behind a pass which is done with them. Does nothing
+	//unless the index is read Sequential, the pages of a Random one are
+	//kept for the lookups to come
+	void release(size_t first, size_t last) const;
+
+private:
+	struct Entry
+	{
+		uint64_t word_offset;
+		uint64_t postings_offset;
+		uint64_t last;
+		uint64_t word_size;
+		uint64_t occurrence_count;
+	};
+
+	Entry readEntry(size_t entry) const;
+
+private:
+	MemoryMappedFile m_file;
+	MappedAccess m_access = MappedAccess::Random;
+	std::string_view m_entries;
+	std::string_view m_words;
+	std::string_view m_postings;
+	size_t m_size = 0;
+	Sentence m_sentence_count = 0;
+	std::optional<Checkpoint> m_checkpoint;
+	bool m_valid = false;
+};
+
+#endif
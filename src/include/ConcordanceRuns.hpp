@@ -0,0 +1,73 @@
+#ifndef CONCORDANCERUNS_HPP
+#define CONCORDANCERUNS_HPP
+
+//Include Headers
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "ConcordanceIndex.hpp"
+
+//==========================================================================|
+//							  ConcordanceRuns								|
+//==========================================================================|
+// @brief: Sorted runs of a concordance read as the one concordance they	|
+//		   add up to. Each run is a ConcordanceIndex whose sentences are	|
+//		   shifted by the offset of the run, and runs come in the order of	|
+//		   their sentences, so the lists a word has in several runs are		|
+//		   joined run after run. Words are visited through a k-way merge	|
+//		   which only holds the current entry of every run. Runs mapped		|
+//		   Sequential, like the ones spilled under a memory budget, have	|
+//		   their pages released behind every pass, so a pass over them		|
+//		   takes little memory whatever their size. A single run is simply	|
+//		   an index															|
+//==========================================================================|
+class ConcordanceRuns
+{
+public:
+	struct Run
+	{
+		std::shared_ptr<const ConcordanceIndex> index;
+		Sentence offset = 0;
+	};
+
+	using WordVisitor = std::function<void(std::string_view, Occurrences &)>;
+	using CountVisitor = std::function<void(std::string_view, size_t)>;
+	using WordBound = std::function<bool(std::string_view)>;
+
+	//Counts the distinct words with a pass over the words of the runs,
+	//unless there is a single one
+	ConcordanceRuns(std::vector<Run> runs);
+
+	size_t size() const;
+	Sentence sentenceCount() const;
+	const std::vector<Run> &runs() const;
+
+	bool exists(std::string_view word) const;
+	std::optional<Occurrences> lookup(std::string_view word) const;
+
+	//The words from first on in alphabetical order, for as long as they
+	//are within bound. Every list is joined into a temporary, which the
+	//visitor may consume
+	void forEachWord(std::string_view first, const WordBound &within, const WordVisitor &visit) const;
+
+	//Every word with its number of occurrences, without decoding any list
+	void forEachCount(const CountVisitor &visit) const;
+
+private:
+	//The entries a word has in the runs, as (run, entry) pairs
+	using Cursor = std::pair<size_t, size_t>;
+
+	template <typename Function>
+	void forEachMerged(std::string_view first, const WordBound &within, Function &&function) const;
+
+private:
+	std::vector<Run> m_runs;
+	size_t m_size = 0;
+	Sentence m_sentence_count = 0;
+};
+
+#endif
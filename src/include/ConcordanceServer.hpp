@@ -0,0 +1,125 @@
+#ifndef CONCORDANCESERVER_HPP
+#define CONCORDANCESERVER_HPP
+
+//Include Headers
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Concordance.hpp"
+
+//==========================================================================|
+//								  Query										|
+//==========================================================================|
+// @brief: One question asked to a ConcordanceServer. Lookup asks for the	|
+//		   sentences of a word, Prefix for those of every word starting		|
+//		   with it and Exists only whether a word is found. Words are		|
+//		   lowercased by the server, like the words they are matched with	|
+//==========================================================================|
+enum class QueryKind : uint8_t
+{
+	Lookup = 1,
+	Prefix = 2,
+	Exists = 3,
+};
+
+struct Query
+{
+	QueryKind kind = QueryKind::Lookup;
+	std::string word;
+};
+
+//The words answering a query in alphabetical order. An Exists query is
+//answered with the word alone, without its sentences
+using QueryResult = std::vector< std::pair<Word, Occurrences> >;
+
+//==========================================================================|
+//							  ConcordanceServer								|
+//==========================================================================|
+// @brief: Answers queries over a concordance which stays loaded, through	|
+//		   a Unix domain socket. A request is a batch of queries and its	|
+//		   response holds one result per query, in the same order. Both		|
+//		   are framed by their size in bytes, as a 32 bit integer:			|
+//																			|
+//		   request:  size, then per query kind (8 bits), word size (32		|
+//					 bits) and the word										|
+//		   response: size, then per query the number of words (32 bits)		|
+//					 and per word its size (32 bits), the word, its last	|
+//					 sentence (64 bits), the size of its gaps (32 bits)		|
+//					 and the gaps, encoded like Occurrences encodes them	|
+//																			|
+//		   Integers are in the byte order of the machine. A response which	|
+//		   would be larger than MaxResponseSize, like the one of a Prefix	|
+//		   query matching most words, is replaced by a size of				|
+//		   FailedResponse alone and the connection stays open. A few		|
+//		   threads serve every client: the first one accepts connections	|
+//		   and hands them out to the threads in turn, each of which polls	|
+//		   the connections it was handed, so a thread answers many clients	|
+//		   and clients never wait for a thread of their own. A malformed	|
+//		   request closes its connection									|
+//==========================================================================|
+class ConcordanceServer
+{
+public:
+	static constexpr size_t MaxRequestSize = 1 << 20;
+	static constexpr size_t MaxResponseSize = 1 << 22;
+	static constexpr uint32_t FailedResponse = UINT32_MAX;
+
+	//The concordance is shared by the threads, which only read it, and
+	//has to outlive the server. A thread_count of 0 uses one thread per
+	//hardware thread, up to 4
+	ConcordanceServer(const Concordance &concordance, TextEncoding encoding = TextEncoding::Ascii, size_t thread_count = 0);
+	~ConcordanceServer();
+	ConcordanceServer(const ConcordanceServer &other) = delete;
+	ConcordanceServer &operator=(const ConcordanceServer &other) = delete;
+
+	//Binds the socket, replacing a file left at socket_path, and starts
+	//serving. False when the socket cannot be set up
+	bool listen(const std::string &socket_path);
+
+	//Stops every thread and removes the socket file
+	void stop();
+
+	//Answers a request without its size, nothing when it is malformed or
+	//its response would be larger than MaxResponseSize
+	std::optional<std::string> answer(std::string_view request) const;
+
+private:
+	class Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+//==========================================================================|
+//							  ConcordanceClient								|
+//==========================================================================|
+// @brief: Connection to a ConcordanceServer. ask sends a batch of queries	|
+//		   in one request and waits for their results						|
+//==========================================================================|
+class ConcordanceClient
+{
+public:
+	//Invalid when nothing listens at socket_path
+	static ConcordanceClient makeConnected(const std::string &socket_path);
+
+	~ConcordanceClient();
+	ConcordanceClient(ConcordanceClient &&other) noexcept;
+	ConcordanceClient &operator=(ConcordanceClient &&other) noexcept;
+
+	bool isConnected() const;
+
+	//Nothing when the connection fails, after which it is closed, or when
+	//the server could not send the results, after which it stays open
+	std::optional< std::vector<QueryResult> > ask(const std::vector<Query> &queries);
+
+private:
+	ConcordanceClient() {}
+	void close();
+
+private:
+	int m_socket = -1;
+};
+
+#endif
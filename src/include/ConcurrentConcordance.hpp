@@ -0,0 +1,42 @@
+#ifndef CONCURRENTCONCORDANCE_HPP
+#define CONCURRENTCONCORDANCE_HPP
+
+//Include Headers
+#include <memory>
+#include <string_view>
+
+#include "Concordance.hpp"
+#include "TextEncoding.hpp"
+
+//==========================================================================|
+//							ConcurrentConcordance							|
+//==========================================================================|
+// @brief: Concordance that many threads can add words to at the same		|
+//		   time. Words are hashed to shards, each one locked on its own,	|
+//		   so threads adding different words rarely wait for each other.	|
+//		   Validation and sanitizing happen before any lock is taken.		|
+//		   Sentences may arrive in any order, the occurrences of a word		|
+//		   are sorted when toConcordance moves them into an ordinary		|
+//		   Concordance, which also empties this one							|
+//==========================================================================|
+class ConcurrentConcordance
+{
+public:
+	static constexpr size_t DefaultShardCount = 64;
+
+	ConcurrentConcordance(TextEncoding encoding = TextEncoding::Ascii, size_t shard_count = DefaultShardCount);
+	~ConcurrentConcordance();
+	ConcurrentConcordance(const ConcurrentConcordance &other) = delete;
+	ConcurrentConcordance &operator=(const ConcurrentConcordance &other) = delete;
+
+	void add(std::string_view word, Sentence sentence);
+	size_t size() const;
+
+	Concordance toConcordance();
+
+private:
+	class Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef DELIMITERSCANNER_HPP
+#define DELIMITERSCANNER_HPP
+
+//==========================================================================|
+//							  DelimiterScanner								|
+//==========================================================================|
+// @brief: Finds the bytes that matter to the tokenizer (whitespace and		|
+//		   anything that is not alphanumeric or ASCII) 16 or 32 bytes at a	|
+//		   time.															|
+//		   The widest kernel supported by the running CPU is picked once,	|
+//		   the Scalar kernel is always available and gives identical		|
+//		   results. All functions return end when nothing is found			|
+//==========================================================================|
+class DelimiterScanner
+{
+public:
+	enum class Kernel
+	{
+		Scalar,
+		SSE2,
+		AVX2,
+	};
+
+	static Kernel bestKernel();
+	static bool isSupported(Kernel kernel);
+
+	static const char *findWhitespace(const char *begin, const char *end);
+	static const char *findNonWhitespace(const char *begin, const char *end);
+	static const char *findNonAlphanumeric(const char *begin, const char *end);
+	static const char *findNonAscii(const char *begin, const char *end);
+
+	static const char *findWhitespace(const char *begin, const char *end, Kernel kernel);
+	static const char *findNonWhitespace(const char *begin, const char *end, Kernel kernel);
+	static const char *findNonAlphanumeric(const char *begin, const char *end, Kernel kernel);
+	static const char *findNonAscii(const char *begin, const char *end, Kernel kernel);
+};
+
+#endif
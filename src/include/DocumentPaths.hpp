@@ -0,0 +1,26 @@
+#ifndef DOCUMENTPATHS_HPP
+#define DOCUMENTPATHS_HPP
+
+//Include Headers
+#include <string>
+#include <string_view>
+#include <vector>
+
+//==========================================================================|
+//								DocumentPaths								|
+//==========================================================================|
+// @brief: Turns the paths given by the user into the documents they refer	|
+//		   to. A directory stands for every regular file below it and a		|
+//		   path with any of the wildcards * ? [ for every path it matches,	|
+//		   both in alphabetical order. Any other path, standard input		|
+//		   included, is kept as it is. The order of the given paths is		|
+//		   kept																|
+//==========================================================================|
+class DocumentPaths
+{
+public:
+	static std::vector<std::string> expand(const std::vector<std::string> &paths);
+	static bool isPattern(std::string_view path);
+};
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef GENERATOR_HPP
+#define GENERATOR_HPP
+
+//Include Headers
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+//==========================================================================|
+//								  Generator									|
+//==========================================================================|
+// @brief: Lazy sequence produced by a coroutine which co_yields values of	|
+//		   type T. The coroutine runs until its next co_yield each time		|
+//		   the iterator advances, so only one value exists at a time and	|
+//		   it stays valid until the iterator is advanced again. Meant for	|
+//		   a single pass with range-for										|
+//==========================================================================|
+template <typename T>
+class Generator
+{
+public:
+	struct promise_type
+	{
+		const T *m_value = nullptr;
+		std::exception_ptr m_exception;
+
+		Generator get_return_object()
+		{
+			return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+
+		//The yielded value lives in the coroutine frame, or is a temporary
+		//of the co_yield expression, until the coroutine is resumed
+		std::suspend_always yield_value(const T &value) noexcept
+		{
+			m_value = std::addressof(value);
+			return {};
+		}
+
+		void return_void() {}
+		void unhandled_exception() { m_exception = std::current_exception(); }
+	};
+
+	using Handle = std::coroutine_handle<promise_type>;
+
+	class Iterator
+	{
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+		using value_type = T;
+
+		Iterator() {}
+		explicit Iterator(Handle coroutine) : m_coroutine(coroutine) {}
+
+		const T &operator*() const { return *m_coroutine.promise().m_value; }
+		const T *operator->() const { return m_coroutine.promise().m_value; }
+
+		Iterator &operator++()
+		{
+			resume(m_coroutine);
+			return *this;
+		}
+
+		void operator++(int) { ++*this; }
+
+		bool operator==(std::default_sentinel_t) const { return !m_coroutine || m_coroutine.done(); }
+
+	private:
+		Handle m_coroutine;
+	};
+
+	explicit Generator(Handle coroutine) : m_coroutine(coroutine) {}
+	~Generator();
+	Generator(const Generator &other) = delete;
+	Generator &operator=(const Generator &other) = delete;
+	Generator(Generator &&other) noexcept : m_coroutine(std::exchange(other.m_coroutine, {})) {}
+	Generator &operator=(Generator &&other) noexcept;
+
+	Iterator begin();
+	std::default_sentinel_t end() const { return std::default_sentinel; }
+
+private:
+	static void resume(Handle coroutine);
+
+private:
+	Handle m_coroutine;
+};
+
+template <typename T>
+Generator<T>::~Generator()
+{
+	if( m_coroutine ){
+		m_coroutine.destroy();
+	}
+}
+
+template <typename T>
+Generator<T> &Generator<T>::operator=(Generator &&other) noexcept
+{
+	if( this != &other ){
+		if( m_coroutine ){
+			m_coroutine.destroy();
+		}
+		m_coroutine = std::exchange(other.m_coroutine, {});
+	}
+
+	return *this;
+}
+
+template <typename T>
+typename Generator<T>::Iterator Generator<T>::begin()
+{
+	//The coroutine starts suspended, the first value is produced here
+	if( m_coroutine ){
+		resume(m_coroutine);
+	}
+
+	return Iterator(m_coroutine);
+}
+
+template <typename T>
+void Generator<T>::resume(Handle coroutine)
+{
+	coroutine.resume();
+
+	if( coroutine.promise().m_exception ){
+		std::rethrow_exception(coroutine.promise().m_exception);
+	}
+}
+
+#endif
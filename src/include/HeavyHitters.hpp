@@ -0,0 +1,83 @@
+#ifndef HEAVYHITTERS_HPP
+#define HEAVYHITTERS_HPP
+
+//Include Headers
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+//Typedefs
+using Word = std::string;
+
+//==========================================================================|
+//								 WordCount									|
+//==========================================================================|
+// @brief: How many times a word occurs. An estimated count may be higher	|
+//		   than the true one by up to error, never lower. Exact counts		|
+//		   have no error													|
+//==========================================================================|
+struct WordCount
+{
+	Word word;
+	size_t count = 0;
+	size_t error = 0;
+};
+
+//Higher counts come first, equal counts in alphabetical order
+bool ranksBefore(const WordCount &first, const WordCount &second);
+
+//==========================================================================|
+//								HeavyHitters								|
+//==========================================================================|
+// @brief: Space-Saving summary of a stream of words, which estimates the	|
+//		   most frequent ones in memory bounded by its capacity, however	|
+//		   many distinct words the stream holds. Up to capacity words are	|
+//		   counted, kept in a min heap by count. A word which is not		|
+//		   counted takes over the least counted one and inherits its count	|
+//		   as its error. Any word occurring more than a 1/capacity share	|
+//		   of the stream is guaranteed to be counted, and no count is off	|
+//		   by more than that share. Summaries of separate streams merge		|
+//		   into the summary of their concatenation							|
+//==========================================================================|
+class HeavyHitters
+{
+public:
+	static constexpr size_t DefaultCapacity = 1 << 16;
+
+	HeavyHitters(size_t capacity = DefaultCapacity);
+	HeavyHitters(const HeavyHitters &other) = delete;
+	HeavyHitters &operator=(const HeavyHitters &other) = delete;
+	HeavyHitters(HeavyHitters &&other) = default;
+	HeavyHitters &operator=(HeavyHitters &&other) = default;
+
+	size_t capacity() const;
+	size_t size() const;
+
+	//Added words occurred once more, or count more times
+	void add(std::string_view word, size_t count = 1);
+	void merge(const HeavyHitters &other);
+
+	//The k most counted words, ranked by ranksBefore
+	std::vector<WordCount> top(size_t k) const;
+
+private:
+	size_t minimumCount() const;
+	void insert(std::string_view word, size_t count, size_t error);
+	void siftUp(size_t position);
+	void siftDown(size_t position);
+	void swapPositions(size_t first, size_t second);
+
+private:
+	size_t m_capacity;
+	std::vector<WordCount> m_counters;
+	std::vector<uint32_t> m_heap;
+	std::vector<uint32_t> m_heap_positions;
+
+	//Keys view the words of the counters, which never move: their storage
+	//is reserved up front and taken over whole by moves
+	std::unordered_map<std::string_view, uint32_t> m_counter_of_word;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef MEMORYMAPPEDFILE_HPP
+#define MEMORYMAPPEDFILE_HPP
+
+//Include Headers
+#include <string>
+#include <string_view>
+
+//==========================================================================|
+//								MappedAccess								|
+//==========================================================================|
+// @brief: How a mapping is going to be read, passed on to the kernel.		|
+//		   Sequential reads ahead aggressively, Random reads only the pages	|
+//		   that are touched													|
+//==========================================================================|
+enum class MappedAccess
+{
+	Sequential,
+	Random,
+};
+
+//==========================================================================|
+//							  MemoryMappedFile								|
+//==========================================================================|
+// @brief: Read-only memory mapping of a regular file. The whole file is	|
+//		   exposed as one contiguous view and the kernel is advised that	|
+//		   it will be read sequentially, so read-ahead kicks in early.		|
+//		   Non-regular files (pipes, devices) or platforms without mmap		|
+//		   result in an unmapped object and callers should fall back to		|
+//		   stream reading													|
+//==========================================================================|
+class MemoryMappedFile
+{
+public:
+	MemoryMappedFile(){}
+	~MemoryMappedFile();
+	MemoryMappedFile(const MemoryMappedFile &other) = delete;
+	MemoryMappedFile &operator=(const MemoryMappedFile &other) = delete;
+	MemoryMappedFile(MemoryMappedFile &&other) noexcept;
+	MemoryMappedFile &operator=(MemoryMappedFile &&other) noexcept;
+
+	static MemoryMappedFile makeFromFile(const std::string &filepath, MappedAccess access = MappedAccess::Sequential);
+
+	bool isMapped() const;
+	std::string_view view() const;
+
+	//Hands the pages lying wholly within bytes, a part of the view, back
+	//to the kernel. They are read from the file again when touched, so the
+	//view stays valid: this only lowers the memory a pass over it holds
+	void release(std::string_view bytes) const;
+
+private:
+	void unmap();
+
+private:
+	const char *m_data = nullptr;
+	size_t m_size = 0;
+	bool m_mapped = false;
+};
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef OCCURRENCES_HPP
+#define OCCURRENCES_HPP
+
+//Include Headers
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//Typedefs
+using Sentence = size_t;
+
+//==========================================================================|
+//								Occurrences									|
+//==========================================================================|
+// @brief: Object which holds the sentences of a found word. Sentences are	|
+//		   mostly appended in non decreasing order, so each one is kept as	|
+//		   its gap from the previous one, encoded as a varint of 7 bits		|
+//		   per byte. Most gaps take a single byte, and up to 15 bytes of	|
+//		   them fit in the object itself, without any heap allocation.		|
+//		   Sentences are read back one by one through Iterator. Appending a	|
+//		   smaller sentence still works, its gap wraps around and takes		|
+//		   the full 10 bytes												|
+//																			|
+//		   Like Roaring bitmaps, sentences are grouped in blocks of 65536.	|
+//		   Once enough gaps pile up and a new block starts, the sentences	|
+//		   of the finished block are sealed into the smallest of three		|
+//		   containers: the gaps as they are, a bitmap of the block or a		|
+//		   list of runs of consecutive sentences. Bitmaps and runs keep the	|
+//		   extra occurrences of a sentence in a separate list of repeats.	|
+//		   A word found in most sentences thus costs at most 8 KiB, plus	|
+//		   its repeats, per block. Only its latest block is kept as gaps	|
+//==========================================================================|
+class Occurrences
+{
+public:
+	class Iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using difference_type = std::ptrdiff_t;
+		using value_type = Sentence;
+		using pointer = const Sentence *;
+		using reference = Sentence;
+
+		Iterator() {}
+		Iterator(const Occurrences *occurrences, size_t container);
+
+		Sentence operator*() const { return m_sentence; }
+		Iterator &operator++();
+		Iterator operator++(int);
+
+		bool operator==(const Iterator &other) const;
+
+	private:
+		void enterContainer(size_t container);
+		bool advanceInContainer();
+		bool takeRepeat();
+		void loadRepeatCount(size_t offset);
+
+	private:
+		const Occurrences *m_occurrences = nullptr;
+		size_t m_container = 0;
+		size_t m_position = 0;
+		size_t m_run_left = 0;
+		size_t m_repeat_position = 0;
+		size_t m_repeat_offset = 0;
+		size_t m_repeats_left = 0;
+		Sentence m_sentence = 0;
+	};
+
+	Occurrences() {}
+	Occurrences(const Occurrences &other) = default;
+	Occurrences(Occurrences &&other) noexcept;
+	Occurrences &operator=(const Occurrences &other) = default;
+	Occurrences &operator=(Occurrences &&other) noexcept;
+
+	Iterator begin() const;
+	Iterator end() const;
+
+	//Kept up to date as sentences are added, never counted
+	size_t size() const;
+	bool empty() const;
+	Sentence back() const;
+
+	//Decodes every sentence, prefer iterating for large lists
+	std::vector<Sentence> get() const;
+
+	Occurrences &operator << (Sentence sentence);
+
+	//Appends every sentence of other shifted by offset
+	void append(const Occurrences &other, Sentence offset = 0);
+	bool operator == (const Occurrences &other) const;
+
+	//Bytes taken by the encoded sentences
+	size_t encodedSize() const;
+
+	//Every sentence as a gap from the previous one, the encoding of a list
+	//without containers. makeFromGaps turns it back into a list, given its
+	//last sentence
+	std::string encodeGaps() const;
+	static Occurrences makeFromGaps(std::string_view gaps, Sentence last);
+
+private:
+	enum class ContainerKind : uint8_t
+	{
+		Gaps,
+		Bitmap,
+		Runs,
+	};
+
+	struct Container
+	{
+		ContainerKind kind = ContainerKind::Gaps;
+		Sentence block_base = 0;
+		Sentence last = 0;
+		size_t count = 0;
+		std::string data;
+		std::string repeats;
+	};
+
+	void seal();
+	const std::string &containerData(size_t container) const;
+
+private:
+	std::string m_gaps;
+	Sentence m_last = 0;
+	std::vector<Container> m_sealed;
+	size_t m_size = 0;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef RADIXTRIE_HPP
+#define RADIXTRIE_HPP
+
+//Include Headers
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Occurrences.hpp"
+#include "WordInterner.hpp"
+
+//==========================================================================|
+//								 RadixTrie									|
+//==========================================================================|
+// @brief: Compressed radix trie from words to their Occurrences. Every		|
+//		   node holds the label of the edge leading to it, a run of bytes	|
+//		   stored once in an arena and shared by all the words below it.	|
+//		   Children are kept sorted by their first byte, so walking the		|
+//		   trie depth first hands out the words in alphabetical order with	|
+//		   no sort at all. Prefix and range queries only descend into the	|
+//		   subtrees that can hold a match.									|
+//		   As in an adaptive radix tree, the first bytes of the children of	|
+//		   a node are packed next to each other, ahead of the children, in	|
+//		   a slice of a pool sized to their number. A child is found by		|
+//		   scanning those bytes												|
+//==========================================================================|
+class RadixTrie
+{
+public:
+	using WordVisitor = std::function<void(const std::string &, WordId)>;
+
+	RadixTrie();
+
+	size_t size() const;
+	bool empty() const;
+
+	Occurrences &findOrInsert(std::string_view word);
+	const Occurrences *find(std::string_view word) const;
+
+	//Ids count from 0 in insertion order
+	WordId insert(std::string_view word);
+	Occurrences &occurrences(WordId id);
+	const Occurrences &occurrences(WordId id) const;
+
+	//Words are visited in alphabetical order, ranges include first and
+	//exclude last
+	void forEachWord(const WordVisitor &visit) const;
+	void forEachWithPrefix(std::string_view prefix, const WordVisitor &visit) const;
+	void forEachInRange(std::string_view first, std::string_view last, const WordVisitor &visit) const;
+
+private:
+	static constexpr uint32_t NoNode = UINT32_MAX;
+
+	struct Node
+	{
+		size_t label_offset = 0;
+		uint32_t label_size = 0;
+		WordId word = WordInterner::NoWord;
+		uint32_t children_offset = 0;
+		uint32_t children_count = 0;
+		uint32_t children_capacity = 0;
+	};
+
+	std::string_view label(uint32_t node) const;
+	uint32_t findChild(uint32_t node, char first_byte) const;
+	uint32_t findNode(std::string_view word) const;
+	uint32_t addNode(std::string_view label);
+	void linkChild(uint32_t parent, uint32_t child);
+	uint32_t allocateChildren(uint32_t capacity);
+	void split(uint32_t node, size_t label_size);
+	WordId assignWord(uint32_t node);
+	void walk(std::string_view first, std::optional<std::string_view> last, const WordVisitor &visit) const;
+
+private:
+	std::vector<Node> m_nodes;
+	std::string m_labels;
+	std::vector<uint32_t> m_children;
+	std::array<std::vector<uint32_t>, 9> m_free_children;
+	std::vector<Occurrences> m_postings;
+};
+
+#endif
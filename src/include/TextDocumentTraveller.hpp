@@ -3,14 +3,20 @@
 
 //Include Headers
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <variant>
 
+#include "ByteSource.hpp"
+#include "Generator.hpp"
+#include "TextEncoding.hpp"
+
 //==========================================================================|
 //									Symbol									|
 //==========================================================================|
 // @brief: Object which represents a non alphanumeric character				|
-//		   Intention is to be able to seperate Symbols from Words in a 		|
+//		   Intention is to be able to seperate Symbols from Words in a		|
 //		   variant. This is why an explicit type is needed					|
 //==========================================================================|
 
@@ -37,23 +43,95 @@ using Word = std::string;
 using DocumentElement = std::variant<Word, Symbol>;
 
 
+//==========================================================================|
+//									Token									|
+//==========================================================================|
+// @brief: Non owning counterpart of a DocumentElement. The text points		|
+//		   into the bytes of the document, so a Token stays valid only		|
+//		   until the next call on the traveller which produced it.			|
+//		   Materialize it when the element has to outlive that call. Under	|
+//		   Utf8 a symbol may span several bytes, while its Symbol only		|
+//		   keeps the first one												|
+//==========================================================================|
+class Token
+{
+public:
+	enum class Kind : unsigned char
+	{
+		Word,
+		Symbol,
+	};
+
+	Token(){}
+	Token(Kind kind, std::string_view text);
+
+	Kind kind() const;
+	bool isWord() const;
+	bool isSymbol() const;
+	std::string_view text() const;
+	Symbol symbol() const;
+
+	DocumentElement materialize() const;
+
+private:
+	std::string_view m_text;
+	Kind m_kind = Kind::Word;
+};
+
+//Unlike the Symbol overload, this also recognises sentence terminating
+//symbols outside ASCII, like the Greek question mark
+bool changesSentence(const Token &token);
+
+
+//==========================================================================|
+//								SourceDecoding								|
+//==========================================================================|
+// @brief: Whether the source of a traveller may still be compressed.		|
+//		   Detect looks for the magic bytes of a compressed format, while a	|
+//		   Decoded source already went through makeDecompressing and is		|
+//		   read as it is													|
+//==========================================================================|
+enum class SourceDecoding
+{
+	Detect,
+	Decoded,
+};
+
 //==========================================================================|
 //						   TextDocumentTraveller							|
 //==========================================================================|
 // @brief: Opens a plain text document and travels it in elements. An		|
 //		   element is considered an english word or a symbol. Numbers are	|
-//		   treated as words.												|
+//		   treated as words. The document bytes are pulled from a			|
+//		   ByteSource in large blocks. Gzip and zstd documents are			|
+//		   recognised by their magic bytes and decoded transparently.		|
+//		   Under TextEncoding::Utf8 letters outside ASCII form words too,	|
+//		   runs of pure ASCII chunks are split without any decoding			|
 //==========================================================================|
 class TextDocumentTraveller
 {
 public:
-	TextDocumentTraveller(const std::string &filepath);
+	TextDocumentTraveller(const std::string &filepath, ReadMode mode = ReadMode::MemoryMapped,
+		TextEncoding encoding = TextEncoding::Ascii);
+	TextDocumentTraveller(std::unique_ptr<ByteSource> source, TextEncoding encoding = TextEncoding::Ascii,
+		SourceDecoding decoding = SourceDecoding::Detect);
 	~TextDocumentTraveller();
 	TextDocumentTraveller(const TextDocumentTraveller &other) = delete;
 	TextDocumentTraveller &operator=(const TextDocumentTraveller &other) = delete;
 
 	bool hasNext();
 	DocumentElement getNext();
+	Token getNextToken();
+
+	//Fills out with up to out.size() tokens and returns how many were
+	//written. 0 means the document is exhausted. The tokens stay valid
+	//until the next call on the traveller
+	size_t next(std::span<Token> out);
+
+	//Yields the remaining elements one by one, for range-for loops. Each
+	//token stays valid until the loop advances. The traveller has to
+	//outlive the generator and should not be used while iterating it
+	Generator<Token> elements();
 
 private:
 	class Impl;
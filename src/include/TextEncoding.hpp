@@ -0,0 +1,47 @@
+#ifndef TEXTENCODING_HPP
+#define TEXTENCODING_HPP
+
+//Include Headers
+#include <string>
+#include <string_view>
+
+//==========================================================================|
+//								TextEncoding								|
+//==========================================================================|
+// @brief: Selects how the bytes of a document are interpreted. Ascii		|
+//		   treats every byte outside ASCII as a symbol. Utf8 decodes the	|
+//		   document, so accented, Greek and Cyrillic letters form words		|
+//==========================================================================|
+enum class TextEncoding
+{
+	Ascii,
+	Utf8,
+};
+
+//==========================================================================|
+//									Utf8									|
+//==========================================================================|
+// @brief: Decoding, encoding and character classes of UTF-8 text. Letter	|
+//		   and case classes cover Latin-1, Latin Extended-A, Greek and		|
+//		   Cyrillic, other letters of Latin Extended-B and IPA count as		|
+//		   letters without a case. Anything else outside ASCII is a symbol.	|
+//		   Classes are the CharacterClass flags, ASCII keeps its table		|
+//==========================================================================|
+class Utf8
+{
+public:
+	static constexpr char32_t ReplacementCharacter = 0xFFFD;
+
+	//Decodes the code point text starts with and returns its size in
+	//bytes. Malformed sequences decode to ReplacementCharacter of size 1
+	static size_t decode(std::string_view text, char32_t &code_point);
+	static void encode(char32_t code_point, std::string &encoded);
+
+	static unsigned char classify(char32_t code_point);
+	static char32_t toLowercase(char32_t code_point);
+
+	static bool isAscii(std::string_view text);
+	static bool startsWithUppercase(std::string_view text);
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef TOKENRING_HPP
+#define TOKENRING_HPP
+
+//Include Headers
+#include <span>
+#include <vector>
+
+#include "TextDocumentTraveller.hpp"
+
+//==========================================================================|
+//								 TokenRing									|
+//==========================================================================|
+// @brief: Fixed capacity FIFO of Tokens stored in one contiguous array.	|
+//		   Head and tail wrap around instead of allocating, so the			|
+//		   traveller can keep producing and handing out tokens in blocks	|
+//		   without ever touching the heap after construction				|
+//==========================================================================|
+class TokenRing
+{
+public:
+	TokenRing(size_t capacity);
+
+	size_t capacity() const;
+	size_t size() const;
+	bool empty() const;
+	bool full() const;
+
+	void push(const Token &token);
+	Token pop();
+	size_t popInto(std::span<Token> out);
+
+private:
+	size_t wrap(size_t position) const;
+
+private:
+	std::vector<Token> m_tokens;
+	size_t m_head = 0;
+	size_t m_size = 0;
+};
+
+#endif
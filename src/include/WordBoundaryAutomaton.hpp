@@ -0,0 +1,166 @@
+#ifndef WORDBOUNDARYAUTOMATON_HPP
+#define WORDBOUNDARYAUTOMATON_HPP
+
+//Include Headers
+#include <array>
+#include <cstdint>
+
+#include "CharacterClasses.hpp"
+
+//==========================================================================|
+//							WordBoundaryAutomaton							|
+//==========================================================================|
+// @brief: Deterministic automaton which finds where a word ends inside a	|
+//		   chunk. The word type is tracked while walking the chunk:			|
+//		   - EnglishWord: ends on the first word terminating character		|
+//		   - Abbreviation: entered on a dot followed by a lowercase letter.	|
+//			 Ends on a second consecutive dot or on any other terminator	|
+//		   - SpecialCharacters: entered on a non terminating symbol. It		|
+//			 spans the rest of the chunk, unless an abbreviation dot turns	|
+//			 it into an Abbreviation again									|
+//		   What a dot does depends on the character after it, so a dot		|
+//		   leads to a pending state and is settled by the next input. The	|
+//		   transition table is built at compile time by running these		|
+//		   rules on every state and input, which leaves one lookup per		|
+//		   character to the tokenizer										|
+//==========================================================================|
+namespace WordBoundaryAutomaton
+{
+
+enum class WordType : uint8_t
+{
+	EnglishWord,
+	Abbreviation,
+	SpecialCharacters,
+};
+
+//Characters reduced to what the rules tell apart
+enum Input : uint8_t
+{
+	LowercaseLetter,
+	OtherAlphanumeric,
+	DotInput,
+	OtherTerminator,
+	NonTerminatingSymbol,
+	EndOfChunk,
+	InputCount,
+};
+
+//Where the word ends, relative to the character just read
+enum class Action : uint8_t
+{
+	Continue,
+	EndBeforeCurrent,
+	EndBeforePendingDot,
+	EndAtChunkEnd,
+};
+
+//A state packs the word type, whether the last settled character was a
+//dot and whether a dot is pending
+using State = uint8_t;
+
+constexpr State makeState(WordType type, bool previous_is_dot, bool dot_pending)
+{
+	return static_cast<State>(static_cast<uint8_t>(type) << 2 | static_cast<uint8_t>(previous_is_dot) << 1 | static_cast<uint8_t>(dot_pending));
+}
+
+constexpr WordType getWordType(State state)		{ return static_cast<WordType>(state >> 2); }
+constexpr bool previousIsDot(State state)		{ return state & 2; }
+constexpr bool isDotPending(State state)		{ return state & 1; }
+
+constexpr State InitialState = makeState(WordType::EnglishWord, false, false);
+constexpr size_t StateCount = 12;
+
+struct Transition
+{
+	State next_state = InitialState;
+	Action action = Action::Continue;
+};
+
+constexpr Input toInput(unsigned char character_class)
+{
+	if( character_class & Dot ){
+		return DotInput;
+	} else if( character_class & Alphanumeric ){
+		return (character_class & Alphabetic) && (character_class & Lowercase) ? LowercaseLetter : OtherAlphanumeric;
+	} else if( character_class & WordTerminating ){
+		return OtherTerminator;
+	} else{
+		return NonTerminatingSymbol;
+	}
+}
+
+//TABLE CONSTRUCTION
+//Reads a character that is not a dot, with no dot pending
+constexpr Transition readSettled(WordType type, Input input)
+{
+	if( input == NonTerminatingSymbol ){
+		type = WordType::SpecialCharacters;
+	}
+
+	if( input == OtherTerminator && type != WordType::SpecialCharacters ){
+		return { makeState(type, false, false), Action::EndBeforeCurrent };
+	}
+
+	return { makeState(type, false, false), Action::Continue };
+}
+
+constexpr Transition makeTransition(State state, Input input)
+{
+	WordType type = getWordType(state);
+	bool previous_is_dot = previousIsDot(state);
+
+	if( !isDotPending(state) ){
+		if( input == EndOfChunk ){
+			return { state, Action::EndAtChunkEnd };
+		} else if( input == DotInput ){
+			return { makeState(type, previous_is_dot, true), Action::Continue };
+		}
+		return readSettled(type, input);
+	}
+
+	//Settle the pending dot with the input as its lookahead
+	if( input == LowercaseLetter ){
+		type = WordType::Abbreviation;
+	}
+
+	bool dot_ends_word = type == WordType::EnglishWord || (type == WordType::Abbreviation && previous_is_dot);
+	if( dot_ends_word ){
+		return { state, Action::EndBeforePendingDot };
+	}
+
+	//The dot stays inside the word, the input is read after it
+	if( input == EndOfChunk ){
+		return { makeState(type, true, false), Action::EndAtChunkEnd };
+	} else if( input == DotInput ){
+		return { makeState(type, true, true), Action::Continue };
+	}
+	return readSettled(type, input);
+}
+
+using TransitionTable = std::array<std::array<Transition, InputCount>, StateCount>;
+
+constexpr TransitionTable makeTransitionTable()
+{
+	TransitionTable table = {};
+
+	for( State state = 0; state < StateCount; state++ ){
+		for( uint8_t input = 0; input < InputCount; input++ ){
+			table[state][input] = makeTransition(state, static_cast<Input>(input));
+		}
+	}
+
+	return table;
+}
+//END OF TABLE CONSTRUCTION
+
+inline constexpr TransitionTable Transitions = makeTransitionTable();
+
+constexpr Transition step(State state, Input input)
+{
+	return Transitions[state][input];
+}
+
+}//WORDBOUNDARYAUTOMATON NAMESPACE
+
+#endif
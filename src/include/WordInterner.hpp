@@ -0,0 +1,65 @@
+#ifndef WORDINTERNER_HPP
+#define WORDINTERNER_HPP
+
+//Include Headers
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+//Typedefs
+using WordId = uint32_t;
+
+//==========================================================================|
+//								WordInterner								|
+//==========================================================================|
+// @brief: Gives every distinct word a dense id, counting from 0 in the		|
+//		   order the words were first seen. The bytes of the words are		|
+//		   packed one after the other in large blocks of an arena, so		|
+//		   interning a new word allocates only when a block fills up and	|
+//		   interning a known one allocates nothing. The ids are found		|
+//		   through an open addressing table whose slots hold an id and		|
+//		   part of the hash of its word										|
+//==========================================================================|
+class WordInterner
+{
+public:
+	static constexpr WordId NoWord = UINT32_MAX;
+
+	WordInterner();
+	WordInterner(const WordInterner &other);
+	WordInterner(WordInterner &&other) noexcept = default;
+	WordInterner &operator=(const WordInterner &other);
+	WordInterner &operator=(WordInterner &&other) noexcept = default;
+
+	size_t size() const;
+	bool empty() const;
+
+	WordId intern(std::string_view word);
+	WordId find(std::string_view word) const;
+	std::string_view word(WordId id) const;
+
+	//Ids in alphabetical order of their words. Large vocabularies are
+	//sorted by several threads, each sorting a slice which are then merged
+	std::vector<WordId> sortedIds() const;
+
+private:
+	struct Slot
+	{
+		uint32_t hash_tag = 0;
+		WordId id = NoWord;
+	};
+
+	size_t findSlot(std::string_view word, size_t hash) const;
+	std::string_view store(std::string_view word);
+	void grow();
+
+private:
+	std::vector<Slot> m_slots;
+	std::vector<std::string_view> m_words;
+	std::vector< std::unique_ptr<char[]> > m_blocks;
+	char *m_block_free = nullptr;
+	size_t m_block_remaining = 0;
+};
+
+#endif
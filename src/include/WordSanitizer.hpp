@@ -3,6 +3,9 @@
 
 //Include Headers
 #include <string>
+#include <string_view>
+
+#include "TextEncoding.hpp"
 
 //Typedefs
 using Word = std::string;
@@ -12,12 +15,13 @@ using Word = std::string;
 //==========================================================================|
 // @brief: Sanitizes a word to be used in a concordance.					|
 //		   Sanitization is necessary since words of concordance should		|
-//         be lowercase														|
+//         be lowercase. Under Utf8 letters outside ASCII are lowercased too|
 //==========================================================================|
 class WordSanitizer
 {
 public:
-	static Word sanitize(const Word &word);
+	static Word sanitize(std::string_view word, TextEncoding encoding = TextEncoding::Ascii);
+	static void sanitize(std::string_view word, Word &sanitized, TextEncoding encoding = TextEncoding::Ascii);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef WORDTABLE_HPP
+#define WORDTABLE_HPP
+
+//Include Headers
+#include <string_view>
+#include <vector>
+
+#include "Concordance.hpp"
+#include "WordInterner.hpp"
+
+//==========================================================================|
+//								 WordTable									|
+//==========================================================================|
+// @brief: Hash table from words to their Occurrences, used while a			|
+//		   concordance is built. Words are interned, so the postings are	|
+//		   a plain array indexed by WordId and a repeated word costs one	|
+//		   probe of the interner without any allocation. Alphabetical		|
+//		   order is only produced on demand by sortedIds, once the table	|
+//		   is complete														|
+//==========================================================================|
+class WordTable
+{
+public:
+	size_t size() const;
+	bool empty() const;
+
+	Occurrences &findOrInsert(std::string_view word);
+	const Occurrences *find(std::string_view word) const;
+
+	//Ids count from 0 in insertion order
+	WordId insert(std::string_view word);
+	std::string_view word(WordId id) const;
+	Occurrences &occurrences(WordId id);
+	const Occurrences &occurrences(WordId id) const;
+	std::vector<WordId> sortedIds() const;
+
+private:
+	WordInterner m_words;
+	std::vector<Occurrences> m_postings;
+};
+
+#endif
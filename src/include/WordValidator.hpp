@@ -2,12 +2,16 @@
 #define WORDVALIDATOR_HPP
 
 #include <string>
+#include <string_view>
+
+#include "TextEncoding.hpp"
+
 using Word = std::string;
 
 class WordValidator
 {
 public:
-	static bool isValid(const Word &word);
+	static bool isValid(std::string_view word, TextEncoding encoding = TextEncoding::Ascii);
 };
 
 #endif
\ No newline at end of file
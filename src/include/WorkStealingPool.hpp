@@ -0,0 +1,38 @@
+#ifndef WORKSTEALINGPOOL_HPP
+#define WORKSTEALINGPOOL_HPP
+
+//Include Headers
+#include <functional>
+#include <memory>
+
+//==========================================================================|
+//							  WorkStealingPool								|
+//==========================================================================|
+// @brief: Threads that run numbered tasks. Each thread starts with a		|
+//		   contiguous slice of the tasks in a queue of its own and takes	|
+//		   them from the front, in order. A thread whose queue runs dry		|
+//		   steals from the back of another one, so a few long tasks never	|
+//		   leave the other threads idle while short ones wait behind them.	|
+//		   The thread calling run works as one of the threads of the pool	|
+//		   and run returns once every task has finished						|
+//==========================================================================|
+class WorkStealingPool
+{
+public:
+	using Task = std::function<void(size_t)>;
+
+	//A thread_count of 0 uses one thread per hardware thread
+	WorkStealingPool(size_t thread_count = 0);
+	~WorkStealingPool();
+	WorkStealingPool(const WorkStealingPool &other) = delete;
+	WorkStealingPool &operator=(const WorkStealingPool &other) = delete;
+
+	size_t threadCount() const;
+	void run(size_t task_count, const Task &task);
+
+private:
+	class Impl;
+	std::unique_ptr<Impl> m_impl;
+};
+
+#endif
@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include "ByteSource.hpp"
+
+static std::string readAll(ByteSource &source, size_t block_size)
+{
+    std::string contents;
+    std::string block(block_size, '\0');
+
+    while( size_t read = source.read(block.data(), block.size()) ){
+        contents.append(block.data(), read);
+    }
+
+    return contents;
+}
+
+TEST(ByteSourceTests, MemorySources)
+{
+    std::unique_ptr<ByteSource> owning = ByteSource::makeFromMemory("Some text in memory");
+    ASSERT_TRUE(owning->contiguousView());
+    EXPECT_EQ(*owning->contiguousView(), "Some text in memory");
+    EXPECT_EQ(readAll(*owning, 3), "Some text in memory");
+
+    std::string text = "A view";
+    std::unique_ptr<ByteSource> view = ByteSource::makeFromView(text);
+    EXPECT_EQ(view->contiguousView()->data(), text.data());
+    EXPECT_EQ(readAll(*view, 4), text);
+}
+
+TEST(ByteSourceTests, FileSourcesOfBothModes)
+{
+    std::string temp_file = std::tmpnam(nullptr);
+    {
+        std::ofstream out(temp_file);
+        out << "File\ncontents\n";
+    }
+
+    std::unique_ptr<ByteSource> mapped = ByteSource::makeFromFile(temp_file, ReadMode::MemoryMapped);
+    EXPECT_TRUE(mapped->contiguousView());
+    EXPECT_EQ(readAll(*mapped, 5), "File\ncontents\n");
+
+    std::unique_ptr<ByteSource> streamed = ByteSource::makeFromFile(temp_file, ReadMode::Stream);
+    EXPECT_FALSE(streamed->contiguousView());
+    EXPECT_EQ(readAll(*streamed, 5), "File\ncontents\n");
+
+    remove(temp_file.c_str());
+}
+
+TEST(ByteSourceTests, MissingFileIsEmpty)
+{
+    std::unique_ptr<ByteSource> source = ByteSource::makeFromFile("/if/this/path/is/found/I/should/have/played/in/the/lottery/instead.txt");
+    EXPECT_EQ(readAll(*source, 16), "");
+}
+
+TEST(ByteSourceTests, PipeSource)
+{
+    std::unique_ptr<ByteSource> source = ByteSource::makeFromPipe("echo Piped words");
+    EXPECT_FALSE(source->contiguousView());
+    EXPECT_EQ(readAll(*source, 2), "Piped words\n");
+}
+
+TEST(ByteSourceTests, ReadAheadPreservesOrder)
+{
+    std::string text;
+    for( int i = 0; i < 1000; i++ ){
+        text += "line " + std::to_string(i) + "\n";
+    }
+
+    ReadAheadOptions options;
+    options.block_size = 7;
+    options.queue_depth = 3;
+
+    std::unique_ptr<ByteSource> read_ahead = ByteSource::makeReadAhead(ByteSource::makeFromPipe("true"), options);
+    EXPECT_EQ(readAll(*read_ahead, 5), "");
+
+    std::string temp_file = std::tmpnam(nullptr);
+    {
+        std::ofstream out(temp_file);
+        out << text;
+    }
+
+    read_ahead = ByteSource::makeReadAhead(ByteSource::makeFromFile(temp_file, ReadMode::Stream), options);
+    EXPECT_FALSE(read_ahead->contiguousView());
+    EXPECT_EQ(readAll(*read_ahead, 11), text);
+
+    remove(temp_file.c_str());
+}
+
+TEST(ByteSourceTests, ReadAheadKeepsContiguousSources)
+{
+    std::unique_ptr<ByteSource> read_ahead = ByteSource::makeReadAhead(ByteSource::makeFromMemory("in memory"));
+    ASSERT_TRUE(read_ahead->contiguousView());
+    EXPECT_EQ(*read_ahead->contiguousView(), "in memory");
+}
+
+TEST(ByteSourceTests, ReadAheadCanBeAbandoned)
+{
+    ReadAheadOptions options;
+    options.block_size = 1;
+    options.queue_depth = 1;
+
+    std::unique_ptr<ByteSource> read_ahead = ByteSource::makeReadAhead(ByteSource::makeFromPipe("echo abandoned"), options);
+    char c;
+    EXPECT_EQ(read_ahead->read(&c, 1), 1);
+    EXPECT_EQ(c, 'a');
+}
+
+static std::string writeTempFile(const std::string &contents)
+{
+    std::string temp_file = std::tmpnam(nullptr);
+    std::ofstream out(temp_file, std::ios::binary);
+    out << contents;
+    return temp_file;
+}
+
+static std::string compressFile(const std::string &command, const std::string &filepath)
+{
+    std::unique_ptr<ByteSource> compressed = ByteSource::makeFromPipe(command + " -c < " + filepath);
+    return writeTempFile(readAll(*compressed, 4096));
+}
+
+TEST(ByteSourceTests, UncompressedSourcesAreUnchanged)
+{
+    std::unique_ptr<ByteSource> source = ByteSource::makeDecompressing(ByteSource::makeFromMemory("plain text"));
+    ASSERT_TRUE(source->contiguousView());
+    EXPECT_EQ(*source->contiguousView(), "plain text");
+
+    source = ByteSource::makeDecompressing(ByteSource::makeFromPipe("echo ab"));
+    EXPECT_EQ(readAll(*source, 1), "ab\n");
+
+    source = ByteSource::makeDecompressing(ByteSource::makeFromMemory(""));
+    EXPECT_EQ(readAll(*source, 1), "");
+}
+
+TEST(ByteSourceTests, GzipIsDecoded)
+{
+    if( !ByteSource::isSupported(Compression::Gzip) ){
+        GTEST_SKIP() << "Built without zlib";
+    }
+
+    std::string text;
+    for( int i = 0; i < 20000; i++ ){
+        text += "Word number " + std::to_string(i) + ".\n";
+    }
+
+    std::string plain_file = writeTempFile(text);
+    std::string gzip_file = compressFile("gzip", plain_file);
+
+    for( ReadMode mode : {ReadMode::MemoryMapped, ReadMode::Stream} ){
+        std::unique_ptr<ByteSource> source = ByteSource::makeDecompressing(ByteSource::makeFromFile(gzip_file, mode));
+        EXPECT_FALSE(source->contiguousView());
+        EXPECT_EQ(readAll(*source, 1000), text);
+    }
+
+    //Concatenated members decode to the concatenated texts
+    std::unique_ptr<ByteSource> source = ByteSource::makeDecompressing(ByteSource::makeFromPipe("cat " + gzip_file + " " + gzip_file));
+    EXPECT_EQ(readAll(*source, 333), text + text);
+
+    remove(plain_file.c_str());
+    remove(gzip_file.c_str());
+}
+
+TEST(ByteSourceTests, TruncatedGzipEndsEarly)
+{
+    if( !ByteSource::isSupported(Compression::Gzip) ){
+        GTEST_SKIP() << "Built without zlib";
+    }
+
+    std::string plain_file = writeTempFile("Some words that will be cut short\n");
+    std::string gzip_file = compressFile("gzip", plain_file);
+    std::unique_ptr<ByteSource> compressed = ByteSource::makeFromFile(gzip_file);
+    std::string truncated(compressed->contiguousView()->substr(0, 12));
+
+    //Whatever was decoded before the cut is kept
+    std::unique_ptr<ByteSource> source = ByteSource::makeDecompressing(ByteSource::makeFromMemory(truncated));
+    std::string decoded = readAll(*source, 64);
+    EXPECT_LT(decoded.size(), std::string("Some words that will be cut short\n").size());
+    EXPECT_EQ(std::string("Some words that will be cut short\n").substr(0, decoded.size()), decoded);
+
+    remove(plain_file.c_str());
+    remove(gzip_file.c_str());
+}
+
+TEST(ByteSourceTests, ZstdIsDecoded)
+{
+    if( !ByteSource::isSupported(Compression::Zstd) ){
+        GTEST_SKIP() << "Built without libzstd";
+    }
+
+    std::string text = "Zstandard compressed words.\nAnd a second line!\n";
+    std::string plain_file = writeTempFile(text);
+    std::string zstd_file = compressFile("zstd -q", plain_file);
+
+    std::unique_ptr<ByteSource> source = ByteSource::makeDecompressing(ByteSource::makeFromFile(zstd_file));
+    EXPECT_EQ(readAll(*source, 7), text);
+
+    remove(plain_file.c_str());
+    remove(zstd_file.c_str());
+}
@@ -0,0 +1,30 @@
+#include <gtest/gtest.h>
+#include <cctype>
+#include "CharacterClasses.hpp"
+
+TEST(CharacterClassTable, MatchesClassicLocale)
+{
+    for( int i = 0; i < 256; i++ ){
+        char c = static_cast<char>(i);
+        EXPECT_EQ(hasCharacterClass(c, Alphanumeric), std::isalnum(i) != 0) << "Byte: " << i;
+        EXPECT_EQ(hasCharacterClass(c, Alphabetic), std::isalpha(i) != 0) << "Byte: " << i;
+        EXPECT_EQ(hasCharacterClass(c, Lowercase), std::islower(i) != 0) << "Byte: " << i;
+        EXPECT_EQ(hasCharacterClass(c, Uppercase), std::isupper(i) != 0) << "Byte: " << i;
+    }
+}
+
+TEST(CharacterClassTable, TokenizerClasses)
+{
+    EXPECT_TRUE(hasCharacterClass(' ', Whitespace));
+    EXPECT_TRUE(hasCharacterClass('\t', Whitespace));
+    EXPECT_TRUE(hasCharacterClass('\n', Whitespace));
+    EXPECT_FALSE(hasCharacterClass('\r', Whitespace));
+
+    EXPECT_TRUE(hasCharacterClass('.', Dot | WordTerminating | SentenceTerminating));
+    EXPECT_TRUE(hasCharacterClass(';', WordTerminating));
+    EXPECT_TRUE(hasCharacterClass(';', SentenceTerminating));
+    EXPECT_TRUE(hasCharacterClass(',', WordTerminating));
+    EXPECT_FALSE(hasCharacterClass(',', SentenceTerminating));
+    EXPECT_FALSE(hasCharacterClass('\'', WordTerminating));
+    EXPECT_FALSE(hasCharacterClass('@', WordTerminating));
+}
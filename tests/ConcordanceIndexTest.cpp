@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include "ConcordanceIndex.hpp"
+
+static Occurrences makeOccurrences(const std::vector<Sentence> &sentences)
+{
+    Occurrences occurrences;
+    for( Sentence sentence : sentences ){
+        occurrences << sentence;
+    }
+    return occurrences;
+}
+
+static std::string writeIndex()
+{
+    std::string temp_file = std::tmpnam(nullptr);
+
+    ConcordanceIndex::Writer writer;
+    writer.add("a", makeOccurrences({1, 1, 4}));
+    writer.add("cat", makeOccurrences({2}));
+    writer.add("catalogue", makeOccurrences({3, 70000, 70001}));
+    writer.add("dog", makeOccurrences({4}));
+    EXPECT_TRUE(writer.write(temp_file, 70001));
+
+    return temp_file;
+}
+
+TEST(ConcordanceIndexTests, RoundTrip)
+{
+    std::string temp_file = writeIndex();
+    ConcordanceIndex index = ConcordanceIndex::makeFromFile(temp_file);
+
+    ASSERT_TRUE(index.isValid());
+    EXPECT_EQ(index.size(), 4);
+    EXPECT_EQ(index.sentenceCount(), 70001);
+    EXPECT_EQ(index.word(0), "a");
+    EXPECT_EQ(index.word(3), "dog");
+    EXPECT_EQ(index.occurrenceCount(0), 3);
+    EXPECT_TRUE(index.occurrences(0) == makeOccurrences({1, 1, 4}));
+    EXPECT_TRUE(index.occurrences(2) == makeOccurrences({3, 70000, 70001}));
+
+    remove(temp_file.c_str());
+}
+
+TEST(ConcordanceIndexTests, Lookups)
+{
+    std::string temp_file = writeIndex();
+    ConcordanceIndex index = ConcordanceIndex::makeFromFile(temp_file);
+
+    EXPECT_EQ(index.find("a"), 0);
+    EXPECT_EQ(index.find("catalogue"), 2);
+    EXPECT_EQ(index.find("cats"), ConcordanceIndex::NoEntry);
+    EXPECT_EQ(index.find(""), ConcordanceIndex::NoEntry);
+    EXPECT_EQ(index.lowerBound(""), 0);
+    EXPECT_EQ(index.lowerBound("cata"), 2);
+    EXPECT_EQ(index.lowerBound("zebra"), 4);
+
+    remove(temp_file.c_str());
+}
+
+TEST(ConcordanceIndexTests, CheckpointRoundTrip)
+{
+    std::string temp_file = writeIndex();
+    EXPECT_FALSE(ConcordanceIndex::makeFromFile(temp_file).checkpoint().has_value());
+
+    ConcordanceIndex::Checkpoint checkpoint;
+    checkpoint.document_offset = 1234;
+    checkpoint.boundary_hash = 0xfeedbeef;
+    checkpoint.sentence = 42;
+    checkpoint.changes_sentence = true;
+    checkpoint.encoding = TextEncoding::Utf8;
+
+    ConcordanceIndex::Writer writer;
+    writer.add("cat", makeOccurrences({2, 41}));
+    ASSERT_TRUE(writer.write(temp_file, 41, checkpoint));
+
+    ConcordanceIndex index = ConcordanceIndex::makeFromFile(temp_file);
+    ASSERT_TRUE(index.checkpoint().has_value());
+    EXPECT_EQ(index.checkpoint()->document_offset, 1234);
+    EXPECT_EQ(index.checkpoint()->boundary_hash, 0xfeedbeef);
+    EXPECT_EQ(index.checkpoint()->sentence, 42);
+    EXPECT_TRUE(index.checkpoint()->changes_sentence);
+    EXPECT_EQ(index.checkpoint()->encoding, TextEncoding::Utf8);
+
+    remove(temp_file.c_str());
+}
+
+TEST(ConcordanceIndexTests, EmptyIndex)
+{
+    std::string temp_file = std::tmpnam(nullptr);
+    ASSERT_TRUE(ConcordanceIndex::Writer().write(temp_file, 0));
+
+    ConcordanceIndex index = ConcordanceIndex::makeFromFile(temp_file);
+    EXPECT_TRUE(index.isValid());
+    EXPECT_EQ(index.size(), 0);
+    EXPECT_EQ(index.find("a"), ConcordanceIndex::NoEntry);
+
+    remove(temp_file.c_str());
+}
+
+TEST(ConcordanceIndexTests, InvalidFilesAreRejected)
+{
+    std::string temp_file = std::tmpnam(nullptr);
+    std::ofstream(temp_file) << "Not an index at all, even if it is long enough to hold a header of one.";
+    EXPECT_FALSE(ConcordanceIndex::makeFromFile(temp_file).isValid());
+    EXPECT_FALSE(ConcordanceIndex::makeFromFile("/if/this/path/is/found/I/should/have/played/in/the/lottery/instead.idx").isValid());
+    remove(temp_file.c_str());
+
+    //A truncated index no longer matches the size its header records
+    std::string index_file = writeIndex();
+    std::string contents;
+    {
+        std::ifstream in(index_file, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    std::ofstream(index_file, std::ios::binary | std::ios::trunc) << contents.substr(0, contents.size() - 1);
+    EXPECT_FALSE(ConcordanceIndex::makeFromFile(index_file).isValid());
+    remove(index_file.c_str());
+}
+
+TEST(ConcordanceIndexTests, SpilledBlocksWriteTheSameIndex)
+{
+    std::string temp_file = writeIndex();
+    std::string spilled_file = std::tmpnam(nullptr);
+
+    //Every block outgrows a single byte buffer after each word
+    ConcordanceIndex::Writer writer(1);
+    writer.add("a", makeOccurrences({1, 1, 4}));
+    writer.add("cat", makeOccurrences({2}));
+    writer.add("catalogue", makeOccurrences({3, 70000, 70001}));
+    writer.add("dog", makeOccurrences({4}));
+    ASSERT_TRUE(writer.write(spilled_file, 70001));
+
+    std::ifstream in(temp_file, std::ios::binary);
+    std::ifstream spilled_in(spilled_file, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::string spilled_bytes((std::istreambuf_iterator<char>(spilled_in)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(spilled_bytes, bytes);
+
+    //Released pages are read back from the file
+    ConcordanceIndex index = ConcordanceIndex::makeFromFile(spilled_file, MappedAccess::Sequential);
+    index.release(0, index.size());
+    EXPECT_EQ(index.word(2), "catalogue");
+    EXPECT_TRUE(index.occurrences(2) == makeOccurrences({3, 70000, 70001}));
+
+    remove(temp_file.c_str());
+    remove(spilled_file.c_str());
+}
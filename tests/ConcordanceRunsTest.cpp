@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include "ConcordanceRuns.hpp"
+
+static Occurrences makeOccurrences(const std::vector<Sentence> &sentences)
+{
+    Occurrences occurrences;
+    for( Sentence sentence : sentences ){
+        occurrences << sentence;
+    }
+    return occurrences;
+}
+
+static std::shared_ptr<const ConcordanceIndex> writeRun(const std::vector< std::pair<std::string, std::vector<Sentence> > > &words, Sentence sentence_count)
+{
+    std::string temp_file = std::tmpnam(nullptr);
+
+    ConcordanceIndex::Writer writer;
+    for( const auto &[word, sentences] : words ){
+        writer.add(word, makeOccurrences(sentences));
+    }
+    EXPECT_TRUE(writer.write(temp_file, sentence_count));
+
+    auto index = std::make_shared<ConcordanceIndex>(ConcordanceIndex::makeFromFile(temp_file));
+    remove(temp_file.c_str());
+    return index;
+}
+
+static ConcordanceRuns makeRuns()
+{
+    std::vector<ConcordanceRuns::Run> runs;
+    runs.push_back({writeRun({{"a", {1, 2}}, {"cat", {2}}, {"dog", {1}}}, 2), 0});
+    runs.push_back({writeRun({{"cat", {1, 3}}, {"cone", {2}}}, 3), 2});
+    runs.push_back({writeRun({{"a", {1}}, {"zebra", {1}}}, 1), 5});
+    return ConcordanceRuns(std::move(runs));
+}
+
+static std::vector< std::pair<std::string, std::vector<Sentence> > > collectRuns(const ConcordanceRuns &runs, std::string_view first,
+                                                                       const ConcordanceRuns::WordBound &within)
+{
+    std::vector< std::pair<std::string, std::vector<Sentence> > > words;
+    runs.forEachWord(first, within, [&words](std::string_view word, Occurrences &occurrences){
+        words.emplace_back(std::string(word), occurrences.get());
+    });
+    return words;
+}
+
+TEST(ConcordanceRunsTests, WordsOfSeveralRunsAreJoined)
+{
+    ConcordanceRuns runs = makeRuns();
+    auto any_word = [](std::string_view){ return true; };
+
+    EXPECT_EQ(runs.size(), 5);
+    EXPECT_EQ(runs.sentenceCount(), 6);
+
+    std::vector< std::pair<std::string, std::vector<Sentence> > > expected = {
+        {"a", {1, 2, 6}}, {"cat", {2, 3, 5}}, {"cone", {4}}, {"dog", {1}}, {"zebra", {6}},
+    };
+    EXPECT_EQ(collectRuns(runs, "", any_word), expected);
+    EXPECT_EQ(collectRuns(runs, "ca", [](std::string_view word){ return word.starts_with("c"); }),
+              (std::vector< std::pair<std::string, std::vector<Sentence> > >{{"cat", {2, 3, 5}}, {"cone", {4}}}));
+    EXPECT_TRUE(collectRuns(runs, "zz", any_word).empty());
+}
+
+TEST(ConcordanceRunsTests, Lookups)
+{
+    ConcordanceRuns runs = makeRuns();
+
+    EXPECT_TRUE(runs.exists("zebra"));
+    EXPECT_FALSE(runs.exists("zebras"));
+    EXPECT_EQ(runs.lookup("cat")->get(), (std::vector<Sentence>{2, 3, 5}));
+    EXPECT_EQ(runs.lookup("dog")->get(), (std::vector<Sentence>{1}));
+    EXPECT_FALSE(runs.lookup("cow").has_value());
+
+    std::vector< std::pair<std::string, size_t> > counts;
+    runs.forEachCount([&counts](std::string_view word, size_t count){
+        counts.emplace_back(std::string(word), count);
+    });
+    EXPECT_EQ(counts, (std::vector< std::pair<std::string, size_t> >{{"a", 3}, {"cat", 3}, {"cone", 1}, {"dog", 1}, {"zebra", 1}}));
+}
+
+TEST(ConcordanceRunsTests, SingleRunIsItsIndex)
+{
+    std::vector<ConcordanceRuns::Run> single;
+    single.push_back({writeRun({{"a", {1, 1, 4}}, {"cat", {2}}}, 4), 0});
+    ConcordanceRuns runs(std::move(single));
+
+    EXPECT_EQ(runs.size(), 2);
+    EXPECT_EQ(runs.sentenceCount(), 4);
+    EXPECT_EQ(runs.lookup("a")->get(), (std::vector<Sentence>{1, 1, 4}));
+}
+
+#ifdef __linux__
+//Kilobytes of the mappings of filepath which are in memory
+static size_t residentKilobytes(const std::string &filepath)
+{
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    bool in_mapping = false;
+    size_t resident = 0;
+
+    while( std::getline(smaps, line) ){
+        if( line.find(filepath) != std::string::npos ){
+            in_mapping = true;
+        } else if( in_mapping && line.starts_with("Rss:") ){
+            resident += std::stoul(line.substr(4));
+            in_mapping = false;
+        }
+    }
+    return resident;
+}
+
+TEST(ConcordanceRunsTests, OnlySequentialRunsReleaseTheirPages)
+{
+    std::string temp_file = std::tmpnam(nullptr);
+    ConcordanceIndex::Writer writer;
+    for( Sentence sentence = 1; sentence <= 200000; sentence++ ){
+        std::string word = std::to_string(sentence);
+        writer.add(std::string(7 - word.size(), '0') + word, makeOccurrences({sentence}));
+    }
+    ASSERT_TRUE(writer.write(temp_file, 200000));
+    size_t file_kilobytes = std::filesystem::file_size(temp_file) / 1024;
+
+    auto pass = [](const ConcordanceRuns &runs){
+        size_t words = 0;
+        runs.forEachWord("", [](std::string_view){ return true; }, [&words](std::string_view, Occurrences &){ ++words; });
+        return words;
+    };
+
+    //A second pass over a Random run finds every page it needs in memory
+    {
+        std::vector<ConcordanceRuns::Run> random;
+        random.push_back({std::make_shared<ConcordanceIndex>(ConcordanceIndex::makeFromFile(temp_file, MappedAccess::Random)), 0});
+        ConcordanceRuns runs(std::move(random));
+
+        EXPECT_EQ(pass(runs), 200000);
+        size_t resident = residentKilobytes(temp_file);
+        EXPECT_GE(resident * 4, file_kilobytes * 3);
+        EXPECT_EQ(pass(runs), 200000);
+        EXPECT_GE(residentKilobytes(temp_file), resident);
+    }
+
+    {
+        std::vector<ConcordanceRuns::Run> sequential;
+        sequential.push_back({std::make_shared<ConcordanceIndex>(ConcordanceIndex::makeFromFile(temp_file, MappedAccess::Sequential)), 0});
+        ConcordanceRuns runs(std::move(sequential));
+
+        EXPECT_EQ(pass(runs), 200000);
+        EXPECT_LE(residentKilobytes(temp_file) * 2, file_kilobytes);
+    }
+
+    remove(temp_file.c_str());
+}
+#endif
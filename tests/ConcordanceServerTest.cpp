@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <thread>
+#include "ByteSource.hpp"
+#include "ConcordanceServer.hpp"
+
+static Concordance makeServedConcordance(ConcordanceEngine engine = ConcordanceEngine::Hash)
+{
+    ParseOptions options;
+    options.engine = engine;
+    return Concordance::makeFromSource(ByteSource::makeFromMemory("Concord and concordance concur. The cat sat. A cat and a cone."), options);
+}
+
+static std::vector<Word> wordsOf(const QueryResult &result)
+{
+    std::vector<Word> words;
+    for( const auto &[word, occurrences] : result ){
+        words.push_back(word);
+    }
+    return words;
+}
+
+TEST(ConcordanceServerTests, AnswersBatchedQueries)
+{
+    Concordance concordance = makeServedConcordance(ConcordanceEngine::RadixTrie);
+    std::string socket_path = std::tmpnam(nullptr);
+
+    ConcordanceServer server(concordance, TextEncoding::Ascii, 2);
+    ASSERT_TRUE(server.listen(socket_path));
+
+    ConcordanceClient client = ConcordanceClient::makeConnected(socket_path);
+    ASSERT_TRUE(client.isConnected());
+
+    std::vector<Query> queries = {
+        {QueryKind::Lookup, "Cat"},
+        {QueryKind::Lookup, "dog"},
+        {QueryKind::Prefix, "conc"},
+        {QueryKind::Exists, "cone"},
+        {QueryKind::Exists, "con"},
+    };
+    std::optional< std::vector<QueryResult> > results = client.ask(queries);
+    ASSERT_TRUE(results.has_value());
+    ASSERT_EQ(results->size(), queries.size());
+
+    ASSERT_EQ((*results)[0].size(), 1);
+    EXPECT_EQ((*results)[0][0].first, "cat");
+    EXPECT_EQ((*results)[0][0].second.get(), (std::vector<Sentence>{2, 3}));
+    EXPECT_TRUE((*results)[1].empty());
+    EXPECT_EQ(wordsOf((*results)[2]), (std::vector<Word>{"concord", "concordance", "concur"}));
+    EXPECT_EQ((*results)[2][2].second.get(), (std::vector<Sentence>{1}));
+    EXPECT_EQ(wordsOf((*results)[3]), (std::vector<Word>{"cone"}));
+    EXPECT_TRUE((*results)[4].empty());
+
+    //The connection stays open for further requests
+    EXPECT_TRUE(client.ask({}).has_value());
+    EXPECT_TRUE(client.ask({{QueryKind::Exists, "the"}}).has_value());
+
+    server.stop();
+    EXPECT_FALSE(ConcordanceClient::makeConnected(socket_path).isConnected());
+}
+
+TEST(ConcordanceServerTests, ServesManyClientsFromFewThreads)
+{
+    Concordance concordance = makeServedConcordance();
+    std::string socket_path = std::tmpnam(nullptr);
+
+    ConcordanceServer server(concordance, TextEncoding::Ascii, 2);
+    ASSERT_TRUE(server.listen(socket_path));
+
+    std::vector<ConcordanceClient> clients;
+    for( size_t client = 0; client < 16; client++ ){
+        clients.push_back(ConcordanceClient::makeConnected(socket_path));
+        ASSERT_TRUE(clients.back().isConnected());
+    }
+
+    std::vector<size_t> answered(clients.size(), 0);
+    std::vector<std::thread> threads;
+
+    for( size_t client = 0; client < clients.size(); client++ ){
+        threads.emplace_back([&clients, &answered, client](){
+            for( size_t request = 0; request < 50; request++ ){
+                std::optional< std::vector<QueryResult> > results = clients[client].ask({{QueryKind::Lookup, "cat"}, {QueryKind::Prefix, "a"}});
+                if( results && (*results)[0].size() == 1 && wordsOf((*results)[1]) == std::vector<Word>{"a", "and"} ){
+                    ++answered[client];
+                }
+            }
+        });
+    }
+
+    for( std::thread &thread : threads ){
+        thread.join();
+    }
+
+    EXPECT_EQ(answered, std::vector<size_t>(clients.size(), 50));
+}
+
+TEST(ConcordanceServerTests, MalformedRequestsAreRejected)
+{
+    Concordance concordance = makeServedConcordance();
+    ConcordanceServer server(concordance);
+
+    EXPECT_EQ(server.answer(""), std::string());
+
+    std::string request;
+    request.push_back(static_cast<char>(QueryKind::Exists));
+    uint32_t word_size = 3;
+    request.append(reinterpret_cast<const char *>(&word_size), sizeof(word_size));
+    request += "cat";
+
+    std::optional<std::string> response = server.answer(request);
+    ASSERT_TRUE(response.has_value());
+    EXPECT_FALSE(response->empty());
+
+    EXPECT_FALSE(server.answer(request.substr(0, request.size() - 1)).has_value());
+
+    request[0] = 42;
+    EXPECT_FALSE(server.answer(request).has_value());
+}
+
+TEST(ConcordanceServerTests, OversizedResponsesFailWithoutClosing)
+{
+    std::string text;
+    for( size_t word = 0; word < 200000; word++ ){
+        text += "word" + std::to_string(word) + " ";
+    }
+    Concordance concordance = Concordance::makeFromSource(ByteSource::makeFromMemory(text));
+    std::string socket_path = std::tmpnam(nullptr);
+
+    ConcordanceServer server(concordance, TextEncoding::Ascii, 2);
+    ASSERT_TRUE(server.listen(socket_path));
+
+    std::string request;
+    request.push_back(static_cast<char>(QueryKind::Prefix));
+    uint32_t word_size = 1;
+    request.append(reinterpret_cast<const char *>(&word_size), sizeof(word_size));
+    request += "w";
+    EXPECT_FALSE(server.answer(request).has_value());
+
+    ConcordanceClient client = ConcordanceClient::makeConnected(socket_path);
+    EXPECT_FALSE(client.ask({{QueryKind::Prefix, "w"}}).has_value());
+    ASSERT_TRUE(client.isConnected());
+
+    std::optional< std::vector<QueryResult> > results = client.ask({{QueryKind::Prefix, "word19999"}});
+    ASSERT_TRUE(results.has_value());
+    EXPECT_EQ((*results)[0].size(), 11);
+
+    server.stop();
+}
+
+TEST(ConcordanceServerTests, SocketSetupFailures)
+{
+    EXPECT_FALSE(ConcordanceClient::makeConnected("/if/this/path/is/found/I/should/have/played/in/the/lottery/instead.sock").isConnected());
+
+    //A regular file is never replaced by the socket
+    std::string regular_file = std::tmpnam(nullptr);
+    std::ofstream(regular_file) << "Keep me.";
+
+    Concordance concordance = makeServedConcordance();
+    ConcordanceServer server(concordance);
+    EXPECT_FALSE(server.listen(regular_file));
+    std::string contents;
+    std::getline(std::ifstream(regular_file), contents);
+    EXPECT_EQ(contents, "Keep me.");
+
+    remove(regular_file.c_str());
+}
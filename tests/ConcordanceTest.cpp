@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
+#include <filesystem>
 #include <fstream>
 #include "Concordance.hpp"
+#include "ByteSource.hpp"
 
 TEST(ConcordanceTests, OccurrenceInsertions)
 {
@@ -322,4 +324,604 @@ TEST_F(ExtremeDatasetFixture, ExtremeSymbolsDataset)
     Concordance concordance = Concordance::makeFromFile(m_temp_file);
     std::map<Word, std::vector<Sentence> > expectation = getExpectationOfExtremeDataset();
     COMPARE_CONCORDANCE_WITH_EXPECTATION(concordance, expectation);
-}
\ No newline at end of file
+}
+
+static void expectShardedParseMatchesSerial(const std::string &filepath)
+{
+    ParseOptions serial;
+    serial.shard_count = 1;
+    Concordance expected = Concordance::makeFromFile(filepath, serial);
+
+    for( size_t shard_count = 2; shard_count <= 16; shard_count++ ){
+        ParseOptions sharded;
+        sharded.shard_count = shard_count;
+        sharded.min_shard_size = 1;
+        EXPECT_TRUE(Concordance::makeFromFile(filepath, sharded) == expected) << "Shards: " << shard_count;
+    }
+}
+
+TEST_F(GivenExampleFixture, ShardedParseMatchesSerial)
+{
+    expectShardedParseMatchesSerial(m_temp_file);
+}
+
+TEST_F(ExtremeDatasetFixture, ShardedParseMatchesSerial)
+{
+    expectShardedParseMatchesSerial(m_temp_file);
+}
+
+class SentenceSeamsFixture : public TestFileWritterFixture
+{
+public:
+    std::string getDataset() const override
+    {
+        //Short sentences put plenty of sentence changes, capitals and
+        //symbols right at the shard seams
+        std::vector<std::string> pieces = {"Word", "word", ".", "!", ";", ",", "?", "\n", "\t", "  ", "i.e.", "Abc", "x"};
+        std::string dataset;
+        unsigned state = 7;
+
+        for( int i = 0; i < 5000; i++ ){
+            state = state * 1103515245 + 12345;
+            dataset += pieces[(state >> 16) % pieces.size()];
+            dataset += (state >> 8) % 3 ? " " : "";
+        }
+        return dataset;
+    }
+};
+
+TEST_F(SentenceSeamsFixture, ShardedParseMatchesSerial)
+{
+    expectShardedParseMatchesSerial(m_temp_file);
+}
+
+TEST(ConcordanceTests, ShardedParseOfStreamsIsSerial)
+{
+    ParseOptions sharded;
+    sharded.shard_count = 4;
+    sharded.min_shard_size = 1;
+
+    std::vector< std::vector<Word> > sentences = {{"one", "two"}, {"three"}};
+    Concordance concordance = Concordance::makeFromSource(ByteSource::makeFromPipe("echo one two. Three"), sharded);
+    EXPECT_TRUE(concordance == Concordance::makeFromSentences(sentences));
+}
+
+TEST(ConcordanceTests, CompressedDocumentsAreDecodedOnce)
+{
+    if( !ByteSource::isSupported(Compression::Gzip) ){
+        GTEST_SKIP() << "Built without zlib";
+    }
+
+    std::string plain_file = std::tmpnam(nullptr);
+    std::ofstream(plain_file) << "The cat sat. A cat ran.";
+    ASSERT_EQ(std::system(("gzip -c " + plain_file + " > " + plain_file + ".gz").c_str()), 0);
+    ASSERT_EQ(std::system(("gzip -c " + plain_file + ".gz > " + plain_file + ".gz.gz").c_str()), 0);
+
+    ParseOptions sharded;
+    sharded.shard_count = 4;
+    sharded.min_shard_size = 1;
+
+    Concordance plain = Concordance::makeFromFile(plain_file);
+    for( const ParseOptions &options : {ParseOptions(), sharded} ){
+        EXPECT_TRUE(Concordance::makeFromFile(plain_file + ".gz", options) == plain);
+        EXPECT_FALSE(Concordance::makeFromFile(plain_file + ".gz.gz", options) == plain);
+    }
+
+    for( const ParseOptions &options : {ParseOptions(), sharded} ){
+        std::vector<WordCount> top = Concordance::countFrequentWords(ByteSource::makeFromFile(plain_file + ".gz"), 8, options).top(1);
+        ASSERT_EQ(top.size(), 1);
+        EXPECT_EQ(top.front().word, "cat");
+        EXPECT_EQ(top.front().count, 2);
+
+        top = Concordance::countFrequentWords(ByteSource::makeFromFile(plain_file + ".gz.gz"), 8, options).top(1);
+        EXPECT_TRUE(top.empty() || top.front().word != "cat" || top.front().count != 2);
+    }
+
+    for( const char *suffix : {"", ".gz", ".gz.gz"} ){
+        remove((plain_file + suffix).c_str());
+    }
+}
+
+TEST(ConcordanceTests, Utf8Documents)
+{
+    //"Αλφα βήτα; Γάμμα café. Δέλτα ΑΛΦΑ" where ';' is the Greek question mark
+    std::string text = "\xce\x91\xce\xbb\xcf\x86\xce\xb1 \xce\xb2\xce\xae\xcf\x84\xce\xb1\xcd\xbe "
+                       "\xce\x93\xce\xac\xce\xbc\xce\xbc\xce\xb1 caf\xc3\xa9. "
+                       "\xce\x94\xce\xad\xce\xbb\xcf\x84\xce\xb1 \xce\x91\xce\x9b\xce\xa6\xce\x91";
+
+    ParseOptions options;
+    options.encoding = TextEncoding::Utf8;
+    Concordance concordance = Concordance::makeFromSource(ByteSource::makeFromMemory(text), options);
+
+    std::map<Word, std::vector<Sentence> > expectation = {
+        {"caf\xc3\xa9", {2}},
+        {"\xce\xb1\xce\xbb\xcf\x86\xce\xb1", {1,3}},
+        {"\xce\xb2\xce\xae\xcf\x84\xce\xb1", {1}},
+        {"\xce\xb3\xce\xac\xce\xbc\xce\xbc\xce\xb1", {2}},
+        {"\xce\xb4\xce\xad\xce\xbb\xcf\x84\xce\xb1", {3}},
+    };
+    COMPARE_CONCORDANCE_WITH_EXPECTATION(concordance, expectation);
+
+    //Under the default encoding none of these words is valid
+    EXPECT_EQ(Concordance::makeFromSource(ByteSource::makeFromMemory(text)).size(), 0);
+}
+
+static std::vector< std::pair<Word, std::vector<Sentence> > > collectInOrder(const Concordance &concordance)
+{
+    std::vector< std::pair<Word, std::vector<Sentence> > > words;
+    concordance.forEachWord([&words](WordIndex index, const Word &word, const Occurrences &occurrences){
+        EXPECT_EQ(index, words.size() + 1);
+        words.emplace_back(word, occurrences.get());
+    });
+    return words;
+}
+
+static void expectEnginesMatch(const std::string &filepath)
+{
+    ParseOptions ordered;
+    ordered.engine = ConcordanceEngine::OrderedMap;
+    Concordance expected = Concordance::makeFromFile(filepath, ordered);
+
+    ParseOptions hashed;
+    hashed.engine = ConcordanceEngine::Hash;
+    hashed.shard_count = 4;
+    hashed.min_shard_size = 1;
+    Concordance concordance = Concordance::makeFromFile(filepath, hashed);
+
+    EXPECT_TRUE(concordance == expected);
+    EXPECT_EQ(collectInOrder(concordance), collectInOrder(expected));
+
+    ParseOptions trie;
+    trie.engine = ConcordanceEngine::RadixTrie;
+    trie.shard_count = 3;
+    trie.min_shard_size = 1;
+    Concordance trie_concordance = Concordance::makeFromFile(filepath, trie);
+
+    EXPECT_TRUE(trie_concordance == expected);
+    EXPECT_EQ(collectInOrder(trie_concordance), collectInOrder(expected));
+}
+
+TEST_F(GivenExampleFixture, EnginesMatch)
+{
+    expectEnginesMatch(m_temp_file);
+}
+
+TEST_F(ExtremeDatasetFixture, EnginesMatch)
+{
+    expectEnginesMatch(m_temp_file);
+}
+
+TEST_F(SentenceSeamsFixture, EnginesMatch)
+{
+    expectEnginesMatch(m_temp_file);
+}
+
+TEST(ConcordanceTests, EnginesCompareByContent)
+{
+    Concordance hashed = Concordance::makeEmpty(ConcordanceEngine::Hash);
+    Concordance ordered = Concordance::makeEmpty(ConcordanceEngine::OrderedMap);
+    EXPECT_TRUE(hashed == ordered);
+
+    hashed.add("word", 1);
+    EXPECT_TRUE(hashed != ordered);
+
+    ordered.add("word", 1);
+    EXPECT_TRUE(hashed == ordered);
+    EXPECT_TRUE(ordered.exists("word"));
+    EXPECT_FALSE(ordered.exists("other"));
+}
+
+static Concordance makeFromText(const std::string &text, ConcordanceEngine engine)
+{
+    ParseOptions options;
+    options.engine = engine;
+    return Concordance::makeFromSource(ByteSource::makeFromMemory(text), options);
+}
+
+static const std::vector<std::string> MergedParts = {
+    "The cat sat. A dog ran. ",
+    "Dogs bark. The cat hid. ",
+    "Zebras graze. A cat naps. The end. ",
+};
+
+static const std::vector<ConcordanceEngine> AllEngines = {ConcordanceEngine::Hash, ConcordanceEngine::OrderedMap, ConcordanceEngine::RadixTrie};
+
+class MergeTests : public testing::TestWithParam<ConcordanceEngine> {};
+
+TEST_P(MergeTests, TwoWayMergeShiftsSentences)
+{
+    Concordance expected = makeFromText(MergedParts[0] + MergedParts[1], GetParam());
+
+    Concordance first = makeFromText(MergedParts[0], GetParam());
+    Concordance second = makeFromText(MergedParts[1], GetParam());
+    EXPECT_EQ(first.sentenceCount(), 2);
+
+    Concordance copied = first;
+    copied.merge(second, first.sentenceCount());
+    EXPECT_TRUE(copied == expected);
+    EXPECT_EQ(collectInOrder(copied), collectInOrder(expected));
+    EXPECT_EQ(copied.sentenceCount(), 4);
+    EXPECT_EQ(second.size(), makeFromText(MergedParts[1], GetParam()).size());
+
+    Concordance moved = first;
+    moved.merge(std::move(second), first.sentenceCount());
+    EXPECT_EQ(collectInOrder(moved), collectInOrder(expected));
+}
+
+TEST_P(MergeTests, MergeIntoEmptyAcrossEngines)
+{
+    Concordance part = makeFromText(MergedParts[2], GetParam());
+
+    Concordance hashed = Concordance::makeEmpty(ConcordanceEngine::Hash);
+    hashed.merge(Concordance(part));
+    Concordance ordered = Concordance::makeEmpty(ConcordanceEngine::OrderedMap);
+    ordered.merge(part);
+
+    EXPECT_EQ(collectInOrder(hashed), collectInOrder(part));
+    EXPECT_EQ(collectInOrder(ordered), collectInOrder(part));
+    EXPECT_EQ(hashed.sentenceCount(), 3);
+    EXPECT_EQ(ordered.sentenceCount(), 3);
+
+    part.merge(part, 3);
+    EXPECT_EQ(part.sentenceCount(), 6);
+    EXPECT_EQ(collectInOrder(part), collectInOrder(makeFromText(MergedParts[2] + MergedParts[2], GetParam())));
+}
+
+TEST_P(MergeTests, KWayMergeMatchesWholeDocument)
+{
+    std::vector<Concordance> partials;
+    for( const std::string &part : MergedParts ){
+        partials.push_back(makeFromText(part, GetParam()));
+    }
+
+    Concordance merged = Concordance::merge(std::move(partials));
+    Concordance expected = makeFromText(MergedParts[0] + MergedParts[1] + MergedParts[2], GetParam());
+
+    EXPECT_TRUE(merged == expected);
+    EXPECT_EQ(collectInOrder(merged), collectInOrder(expected));
+    EXPECT_EQ(merged.sentenceCount(), 7);
+}
+
+TEST_P(MergeTests, KWayMergeWithOffsets)
+{
+    std::vector<Concordance> partials;
+    partials.push_back(makeFromText("Cat. ", GetParam()));
+    partials.push_back(Concordance::makeEmpty(GetParam()));
+    partials.push_back(makeFromText("Cat dog. ", GetParam()));
+
+    Concordance merged = Concordance::merge(std::move(partials), {10, 20});
+
+    EXPECT_EQ(collectInOrder(merged), (std::vector< std::pair<Word, std::vector<Sentence> > >{
+        {"cat", {11, 21}},
+        {"dog", {21}},
+    }));
+    EXPECT_EQ(merged.sentenceCount(), 21);
+    EXPECT_EQ(Concordance::merge({}).size(), 0);
+}
+
+TEST_P(MergeTests, KWayMergeAcrossEngines)
+{
+    std::vector<Concordance> partials;
+    partials.push_back(makeFromText(MergedParts[0], GetParam()));
+    for( ConcordanceEngine engine : {ConcordanceEngine::Hash, ConcordanceEngine::OrderedMap, ConcordanceEngine::RadixTrie} ){
+        partials.push_back(makeFromText(MergedParts[1], engine));
+    }
+
+    Concordance merged = Concordance::merge(std::move(partials));
+    Concordance expected = makeFromText(MergedParts[0] + MergedParts[1] + MergedParts[1] + MergedParts[1], GetParam());
+
+    EXPECT_EQ(collectInOrder(merged), collectInOrder(expected));
+}
+
+INSTANTIATE_TEST_SUITE_P(ConcordanceTests, MergeTests, testing::ValuesIn(AllEngines));
+
+static std::vector<Word> collectWordsWithPrefix(const Concordance &concordance, std::string_view prefix)
+{
+    std::vector<Word> words;
+    concordance.forEachWithPrefix(prefix, [&words](WordIndex index, const Word &word, const Occurrences &){
+        EXPECT_EQ(index, words.size() + 1);
+        words.push_back(word);
+    });
+    return words;
+}
+
+static std::vector<Word> collectWordsInRange(const Concordance &concordance, std::string_view first, std::string_view last)
+{
+    std::vector<Word> words;
+    concordance.forEachInRange(first, last, [&words](WordIndex index, const Word &word, const Occurrences &){
+        EXPECT_EQ(index, words.size() + 1);
+        words.push_back(word);
+    });
+    return words;
+}
+
+class QueryTests : public testing::TestWithParam<ConcordanceEngine> {};
+
+TEST_P(QueryTests, PrefixAndRangeQueries)
+{
+    Concordance concordance = makeFromText("Concord and concordance concur. A cone, a con and concordances. Bond.", GetParam());
+
+    EXPECT_EQ(collectWordsWithPrefix(concordance, "concord"), (std::vector<Word>{"concord", "concordance", "concordances"}));
+    EXPECT_EQ(collectWordsWithPrefix(concordance, "con"), (std::vector<Word>{"con", "concord", "concordance", "concordances", "concur", "cone"}));
+    EXPECT_EQ(collectWordsWithPrefix(concordance, "x"), std::vector<Word>());
+    EXPECT_EQ(collectWordsInRange(concordance, "b", "concordance"), (std::vector<Word>{"bond", "con", "concord"}));
+    EXPECT_EQ(collectWordsInRange(concordance, "concur", "d"), (std::vector<Word>{"concur", "cone"}));
+}
+
+INSTANTIATE_TEST_SUITE_P(ConcordanceTests, QueryTests, testing::ValuesIn(AllEngines));
+
+class IndexTests : public testing::TestWithParam<ConcordanceEngine> {};
+
+TEST_P(IndexTests, SavedIndexReopens)
+{
+    std::string index_file = std::tmpnam(nullptr);
+    Concordance concordance = makeFromText(MergedParts[0] + MergedParts[2], GetParam());
+    ASSERT_TRUE(concordance.save(index_file));
+
+    std::optional<Concordance> opened = Concordance::open(index_file, GetParam());
+    ASSERT_TRUE(opened.has_value());
+    EXPECT_TRUE(*opened == concordance);
+    EXPECT_TRUE(concordance == *opened);
+    EXPECT_EQ(opened->size(), concordance.size());
+    EXPECT_EQ(opened->sentenceCount(), concordance.sentenceCount());
+    EXPECT_EQ(collectInOrder(*opened), collectInOrder(concordance));
+    EXPECT_TRUE(opened->exists("zebras"));
+    EXPECT_FALSE(opened->exists("zebra"));
+    EXPECT_EQ(collectWordsWithPrefix(*opened, "ca"), (std::vector<Word>{"cat"}));
+    EXPECT_EQ(collectWordsInRange(*opened, "d", "n"), (std::vector<Word>{"dog", "end", "graze"}));
+
+    Concordance copy = *opened;
+    copy.merge(makeFromText(MergedParts[1], GetParam()), copy.sentenceCount());
+    copy.add("zebras", 9);
+    Concordance expected = makeFromText(MergedParts[0] + MergedParts[2] + MergedParts[1], GetParam());
+    expected.add("zebras", 9);
+    EXPECT_EQ(collectInOrder(copy), collectInOrder(expected));
+    EXPECT_EQ(collectInOrder(*opened), collectInOrder(concordance));
+
+    remove(index_file.c_str());
+}
+
+TEST(ConcordanceTests, OpeningInvalidIndexFails)
+{
+    std::string temp_file = std::tmpnam(nullptr);
+    std::ofstream(temp_file) << "The cat sat. A dog ran.";
+
+    EXPECT_FALSE(Concordance::open(temp_file).has_value());
+    EXPECT_FALSE(Concordance::open("/if/this/path/is/found/I/should/have/played/in/the/lottery/instead.idx").has_value());
+
+    remove(temp_file.c_str());
+}
+
+INSTANTIATE_TEST_SUITE_P(ConcordanceTests, IndexTests, testing::ValuesIn(AllEngines));
+
+class UpdateTests : public testing::TestWithParam<ConcordanceEngine> {};
+
+TEST_P(UpdateTests, UpdatedIndexMatchesWholeDocument)
+{
+    //Appends cut words and sentences in half, the second one even cuts the
+    //whitespace between a sentence terminating symbol and a capital
+    std::vector<std::string> appends = {"The cat sat. A do", "g ran.", " Dogs bark. the cat ", "", "hid.\nZebras graze.\n"};
+    std::string document_file = std::tmpnam(nullptr);
+    std::string index_file = std::tmpnam(nullptr);
+    std::string document;
+
+    ParseOptions options;
+    options.engine = GetParam();
+    std::ofstream(document_file).close();
+
+    for( const std::string &append : appends ){
+        std::ofstream(document_file, std::ios::app) << append;
+        document += append;
+
+        std::optional<Concordance> updated = Concordance::updateIndex(document_file, index_file, options);
+        ASSERT_TRUE(updated.has_value());
+
+        //Only the bytes up to the last whitespace are indexed
+        std::string indexed = document.substr(0, document.find_last_of(" \n") + 1);
+        EXPECT_EQ(collectInOrder(*updated), collectInOrder(makeFromText(indexed, GetParam()))) << document;
+    }
+
+    EXPECT_EQ(collectInOrder(*Concordance::open(index_file)), collectInOrder(makeFromText(document, GetParam())));
+
+    remove(document_file.c_str());
+    remove(index_file.c_str());
+}
+
+TEST_P(UpdateTests, RewrittenDocumentIsIndexedFromScratch)
+{
+    std::string document_file = std::tmpnam(nullptr);
+    std::string index_file = std::tmpnam(nullptr);
+
+    ParseOptions options;
+    options.engine = GetParam();
+
+    std::ofstream(document_file) << "The cat sat. A dog ran. ";
+    ASSERT_TRUE(Concordance::updateIndex(document_file, index_file, options).has_value());
+
+    std::ofstream(document_file) << "Zebras graze. A cat naps. The end. ";
+    std::optional<Concordance> updated = Concordance::updateIndex(document_file, index_file, options);
+    ASSERT_TRUE(updated.has_value());
+    EXPECT_EQ(collectInOrder(*updated), collectInOrder(makeFromText(MergedParts[2], GetParam())));
+
+    options.encoding = TextEncoding::Utf8;
+    std::ofstream(document_file, std::ios::app) << "Ça va. ";
+    updated = Concordance::updateIndex(document_file, index_file, options);
+    ASSERT_TRUE(updated.has_value());
+    EXPECT_TRUE(updated->exists("ça"));
+    EXPECT_EQ(updated->sentenceCount(), 4);
+
+    remove(document_file.c_str());
+    remove(index_file.c_str());
+}
+
+TEST_P(UpdateTests, MissingDocumentLeavesIndexAlone)
+{
+    std::string document_file = std::tmpnam(nullptr);
+    std::string index_file = std::tmpnam(nullptr);
+
+    ParseOptions options;
+    options.engine = GetParam();
+
+    std::ofstream(document_file) << "The cat sat. A dog ran. ";
+    ASSERT_TRUE(Concordance::updateIndex(document_file, index_file, options).has_value());
+
+    remove(document_file.c_str());
+    EXPECT_FALSE(Concordance::updateIndex(document_file, index_file, options).has_value());
+
+    std::optional<Concordance> kept = Concordance::open(index_file, GetParam());
+    ASSERT_TRUE(kept.has_value());
+    EXPECT_EQ(collectInOrder(*kept), collectInOrder(makeFromText("The cat sat. A dog ran. ", GetParam())));
+
+    remove(index_file.c_str());
+}
+
+INSTANTIATE_TEST_SUITE_P(ConcordanceTests, UpdateTests, testing::ValuesIn(AllEngines));
+
+class TopWordsTests : public testing::TestWithParam<ConcordanceEngine> {};
+
+TEST_P(TopWordsTests, TopWordsAreCountedExactly)
+{
+    std::string text = "The cat saw the dog. The dog saw a cat. A cat ran. Zebras ran and ran and ran. ";
+    Concordance concordance = makeFromText(text, GetParam());
+
+    std::vector<WordCount> top = concordance.topWords(4);
+    std::vector<std::pair<Word, size_t> > counted;
+    for( const WordCount &word_count : top ){
+        counted.emplace_back(word_count.word, word_count.count);
+        EXPECT_EQ(word_count.error, 0);
+    }
+
+    EXPECT_EQ(counted, (std::vector<std::pair<Word, size_t> >{{"ran", 4}, {"cat", 3}, {"the", 3}, {"a", 2}}));
+    EXPECT_TRUE(concordance.topWords(0).empty());
+    EXPECT_EQ(concordance.topWords(100).size(), concordance.size());
+
+    std::string index_file = std::tmpnam(nullptr);
+    ASSERT_TRUE(concordance.save(index_file));
+    std::vector<WordCount> indexed_top = Concordance::open(index_file)->topWords(4);
+    ASSERT_EQ(indexed_top.size(), top.size());
+    for( size_t rank = 0; rank < top.size(); rank++ ){
+        EXPECT_EQ(indexed_top[rank].word, top[rank].word);
+        EXPECT_EQ(indexed_top[rank].count, top[rank].count);
+    }
+    remove(index_file.c_str());
+}
+
+INSTANTIATE_TEST_SUITE_P(ConcordanceTests, TopWordsTests, testing::ValuesIn(AllEngines));
+
+TEST(ConcordanceTests, FrequentWordsAreCountedFromTheStream)
+{
+    std::string text;
+    for( size_t repeat = 0; repeat < 2000; repeat++ ){
+        text += "The cat saw the dog. Word" + std::to_string(repeat) + " ran! ";
+    }
+
+    Concordance concordance = Concordance::makeFromSource(ByteSource::makeFromMemory(text));
+    std::vector<WordCount> exact = concordance.topWords(3);
+
+    ParseOptions sharded;
+    sharded.shard_count = 4;
+    sharded.min_shard_size = 1;
+
+    for( const ParseOptions &options : {ParseOptions(), sharded} ){
+        HeavyHitters heavy_hitters = Concordance::countFrequentWords(ByteSource::makeFromMemory(text), 64, options);
+        std::vector<WordCount> estimated = heavy_hitters.top(3);
+
+        ASSERT_EQ(estimated.size(), exact.size());
+        for( size_t rank = 0; rank < exact.size(); rank++ ){
+            EXPECT_EQ(estimated[rank].word, exact[rank].word);
+            EXPECT_GE(estimated[rank].count, exact[rank].count);
+            EXPECT_LE(estimated[rank].count - estimated[rank].error, exact[rank].count);
+        }
+    }
+}
+
+class SpillTests : public testing::TestWithParam<ConcordanceEngine> {};
+
+TEST_P(SpillTests, SpilledParseMatchesInMemory)
+{
+    std::string text;
+    for( size_t repeat = 0; repeat < 200; repeat++ ){
+        text += MergedParts[repeat % MergedParts.size()] + "Word" + std::to_string(repeat % 17) + " ran. ";
+    }
+
+    Concordance expected = makeFromText(text, GetParam());
+    std::filesystem::path spill_directory = std::tmpnam(nullptr);
+    std::filesystem::create_directory(spill_directory);
+
+    //A budget of a single byte spills after every batch of tokens
+    ParseOptions options;
+    options.engine = GetParam();
+    options.max_memory = 1;
+    options.spill_directory = spill_directory.string();
+
+    for( size_t shard_count : {1, 3} ){
+        options.shard_count = shard_count;
+        options.min_shard_size = 1;
+        Concordance spilled = Concordance::makeFromSource(ByteSource::makeFromMemory(text), options);
+
+        EXPECT_EQ(spilled.memoryEstimate(), 0) << "Shards: " << shard_count;
+        EXPECT_TRUE(spilled == expected) << "Shards: " << shard_count;
+        EXPECT_EQ(collectInOrder(spilled), collectInOrder(expected)) << "Shards: " << shard_count;
+        EXPECT_EQ(spilled.size(), expected.size());
+        EXPECT_EQ(spilled.sentenceCount(), expected.sentenceCount());
+        EXPECT_EQ(spilled.lookup("cat")->get(), expected.lookup("cat")->get());
+        EXPECT_EQ(collectWordsWithPrefix(spilled, "word1"), collectWordsWithPrefix(expected, "word1"));
+        EXPECT_EQ(spilled.topWords(3).front().count, expected.topWords(3).front().count);
+
+        //Runs are removed as soon as they are opened
+        EXPECT_TRUE(std::filesystem::is_empty(spill_directory));
+    }
+
+    //Files held in memory are spilled together, files spilled while parsed
+    //are kept as runs
+    std::vector<std::string> filepaths;
+    for( const std::string &file_text : {MergedParts[0], text, MergedParts[1], MergedParts[2]} ){
+        filepaths.push_back(std::tmpnam(nullptr));
+        std::ofstream(filepaths.back()) << file_text;
+    }
+
+    options.shard_count = 2;
+    options.max_memory = 2048;
+    Concordance spilled_files = Concordance::makeFromFiles(filepaths, options);
+    Concordance expected_files = makeFromText(MergedParts[0] + text + MergedParts[1] + MergedParts[2], GetParam());
+    EXPECT_EQ(collectInOrder(spilled_files), collectInOrder(expected_files));
+    EXPECT_EQ(spilled_files.sentenceCount(), expected_files.sentenceCount());
+
+    //Modifying a spilled concordance loads its runs
+    spilled_files.add("zebras", spilled_files.sentenceCount() + 1);
+    expected_files.add("zebras", expected_files.sentenceCount() + 1);
+    EXPECT_EQ(collectInOrder(spilled_files), collectInOrder(expected_files));
+
+    for( const std::string &filepath : filepaths ){
+        remove(filepath.c_str());
+    }
+    std::filesystem::remove_all(spill_directory);
+}
+
+INSTANTIATE_TEST_SUITE_P(ConcordanceTests, SpillTests, testing::ValuesIn(AllEngines));
+
+TEST(ConcordanceTests, FilesAreNumberedInOrder)
+{
+    std::vector<std::string> texts = {"The cat sat. A dog ran. ", "", "Dogs bark. The cat hid. ", "Zebras graze. A cat naps. "};
+    std::vector<std::string> filepaths;
+    std::string whole;
+
+    for( const std::string &text : texts ){
+        filepaths.push_back(std::tmpnam(nullptr));
+        std::ofstream(filepaths.back()) << text;
+        whole += text;
+    }
+
+    ParseOptions options;
+    options.shard_count = 3;
+    Concordance concordance = Concordance::makeFromFiles(filepaths, options);
+    Concordance expected = Concordance::makeFromSource(ByteSource::makeFromMemory(whole));
+
+    EXPECT_EQ(collectInOrder(concordance), collectInOrder(expected));
+    EXPECT_EQ(concordance.sentenceCount(), 6);
+    EXPECT_EQ(collectInOrder(Concordance::makeFromFiles({filepaths[2]})), collectInOrder(makeFromText(texts[2], ConcordanceEngine::Hash)));
+
+    for( const std::string &filepath : filepaths ){
+        remove(filepath.c_str());
+    }
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include "ConcurrentConcordance.hpp"
+
+TEST(ConcurrentConcordanceTests, MatchesSerialConcordance)
+{
+    ConcurrentConcordance concurrent;
+    concurrent.add("Hello", 1);
+    concurrent.add("world", 1);
+    concurrent.add("hello", 2);
+    concurrent.add("e.g.", 2);
+    concurrent.add("e-mail", 3);
+
+    Concordance expected = Concordance::makeEmpty();
+    expected.add("Hello", 1);
+    expected.add("world", 1);
+    expected.add("hello", 2);
+    expected.add("e.g.", 2);
+    expected.add("e-mail", 3);
+
+    EXPECT_EQ(concurrent.size(), expected.size());
+    EXPECT_TRUE(concurrent.toConcordance() == expected);
+    EXPECT_EQ(concurrent.size(), 0);
+}
+
+TEST(ConcurrentConcordanceTests, OutOfOrderSentencesAreSorted)
+{
+    ConcurrentConcordance concurrent(TextEncoding::Ascii, 1);
+    for( Sentence sentence : {5, 2, 9, 2, 1} ){
+        concurrent.add("word", sentence);
+    }
+    concurrent.add("other", 3);
+
+    std::vector< std::vector<Word> > sentences = {{"word"}, {"word", "word"}, {"other"}, {}, {"word"}, {}, {}, {}, {"word"}};
+    EXPECT_TRUE(concurrent.toConcordance() == Concordance::makeFromSentences(sentences));
+}
+
+TEST(ConcurrentConcordanceTests, CollectedWordsCountTowardsMemory)
+{
+    ConcurrentConcordance concurrent;
+    Concordance expected = Concordance::makeEmpty();
+    for( Sentence sentence : {1, 3, 200} ){
+        concurrent.add("cat", sentence);
+        expected.add("cat", sentence);
+    }
+
+    EXPECT_GT(expected.memoryEstimate(), 0);
+    EXPECT_GE(concurrent.toConcordance().memoryEstimate(), expected.memoryEstimate());
+}
+
+TEST(ConcurrentConcordanceTests, ManyProducers)
+{
+    //Every producer adds an interleaved share of the sentences, shuffled
+    constexpr size_t ProducerCount = 8;
+    constexpr Sentence SentenceCount = 20000;
+    std::vector<Word> vocabulary;
+    for( int i = 0; i < 500; i++ ){
+        vocabulary.push_back("word" + std::to_string(i));
+    }
+
+    auto words_of = [&vocabulary](Sentence sentence){
+        return std::vector<Word>{vocabulary[sentence % 500], vocabulary[(sentence * 7) % 500], vocabulary[0]};
+    };
+
+    ConcurrentConcordance concurrent;
+    std::vector<std::thread> producers;
+
+    for( size_t producer = 0; producer < ProducerCount; producer++ ){
+        producers.emplace_back([&concurrent, &words_of, producer](){
+            std::vector<Sentence> sentences;
+            for( Sentence sentence = producer + 1; sentence <= SentenceCount; sentence += ProducerCount ){
+                sentences.push_back(sentence);
+            }
+            std::shuffle(sentences.begin(), sentences.end(), std::mt19937(producer));
+
+            for( Sentence sentence : sentences ){
+                for( const Word &word : words_of(sentence) ){
+                    concurrent.add(word, sentence);
+                }
+            }
+        });
+    }
+
+    for( std::thread &producer : producers ){
+        producer.join();
+    }
+
+    Concordance expected = Concordance::makeEmpty();
+    for( Sentence sentence = 1; sentence <= SentenceCount; sentence++ ){
+        for( const Word &word : words_of(sentence) ){
+            expected.add(word, sentence);
+        }
+    }
+
+    EXPECT_TRUE(concurrent.toConcordance() == expected);
+}
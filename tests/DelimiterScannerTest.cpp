@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include "DelimiterScanner.hpp"
+
+static std::string makeRandomText(size_t size, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<int> kind(0, 9);
+
+    std::string text;
+    for( size_t i = 0; i < size; i++ ){
+        int k = kind(generator);
+        if( k < 6 ){
+            text.push_back(static_cast<char>('a' + byte(generator) % 26));
+        } else if( k == 6 ){
+            text.push_back(' ');
+        } else{
+            text.push_back(static_cast<char>(byte(generator)));
+        }
+    }
+
+    return text;
+}
+
+TEST(DelimiterScannerTests, KernelsMatchScalar)
+{
+    std::vector<DelimiterScanner::Kernel> kernels = {DelimiterScanner::Kernel::SSE2, DelimiterScanner::Kernel::AVX2};
+
+    for( unsigned int seed = 0; seed < 20; seed++ ){
+        std::string text = makeRandomText(200, seed);
+        const char *end = text.data() + text.size();
+
+        for( DelimiterScanner::Kernel kernel : kernels ){
+            if( !DelimiterScanner::isSupported(kernel) ){
+                continue;
+            }
+
+            for( const char *begin = text.data(); begin <= end; begin++ ){
+                EXPECT_EQ(DelimiterScanner::findWhitespace(begin, end, kernel),
+                          DelimiterScanner::findWhitespace(begin, end, DelimiterScanner::Kernel::Scalar));
+                EXPECT_EQ(DelimiterScanner::findNonWhitespace(begin, end, kernel),
+                          DelimiterScanner::findNonWhitespace(begin, end, DelimiterScanner::Kernel::Scalar));
+                EXPECT_EQ(DelimiterScanner::findNonAlphanumeric(begin, end, kernel),
+                          DelimiterScanner::findNonAlphanumeric(begin, end, DelimiterScanner::Kernel::Scalar));
+                EXPECT_EQ(DelimiterScanner::findNonAscii(begin, end, kernel),
+                          DelimiterScanner::findNonAscii(begin, end, DelimiterScanner::Kernel::Scalar));
+            }
+        }
+    }
+}
+
+TEST(DelimiterScannerTests, FindsBoundariesOfLongRuns)
+{
+    std::string text = std::string(70, 'a') + "Z9," + std::string(40, ' ') + "\tword\n";
+    const char *begin = text.data();
+    const char *end = begin + text.size();
+
+    EXPECT_EQ(DelimiterScanner::findNonAlphanumeric(begin, end) - begin, 72);
+    EXPECT_EQ(DelimiterScanner::findWhitespace(begin, end) - begin, 73);
+    EXPECT_EQ(DelimiterScanner::findNonWhitespace(begin + 73, end) - begin, 114);
+    EXPECT_EQ(DelimiterScanner::findNonAlphanumeric(begin + 114, end) - begin, 118);
+    EXPECT_EQ(DelimiterScanner::findWhitespace(end, end), end);
+}
+
+TEST(DelimiterScannerTests, FindsNonAsciiBytes)
+{
+    std::string text = std::string(70, 'a') + "\xce\xb1" + std::string(40, ' ');
+    const char *begin = text.data();
+    const char *end = begin + text.size();
+
+    EXPECT_EQ(DelimiterScanner::findNonAscii(begin, end) - begin, 70);
+    EXPECT_EQ(DelimiterScanner::findNonAscii(begin + 72, end), end);
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include "DocumentPaths.hpp"
+
+class DocumentTreeFixture : public ::testing::Test
+{
+public:
+    void SetUp()
+    {
+        m_root = std::filesystem::path(std::tmpnam(nullptr));
+        std::filesystem::create_directories(m_root / "nested" / "deeper");
+
+        for( const char *file : {"b.txt", "a.txt", "c.md", "nested/z.txt", "nested/deeper/y.txt"} ){
+            std::ofstream(m_root / file) << "Text.";
+        }
+    }
+
+    void TearDown()
+    {
+        std::filesystem::remove_all(m_root);
+    }
+
+    std::string path(const std::string &relative) const
+    {
+        return (m_root / relative).string();
+    }
+
+    std::filesystem::path m_root;
+};
+
+TEST_F(DocumentTreeFixture, DirectoriesAreWalkedInOrder)
+{
+    std::vector<std::string> expected = {
+        path("a.txt"), path("b.txt"), path("c.md"), path("nested/deeper/y.txt"), path("nested/z.txt"),
+    };
+
+    EXPECT_EQ(DocumentPaths::expand({m_root.string()}), expected);
+}
+
+TEST_F(DocumentTreeFixture, PatternsAreExpanded)
+{
+    EXPECT_EQ(DocumentPaths::expand({path("*.txt")}), (std::vector<std::string>{path("a.txt"), path("b.txt")}));
+    EXPECT_EQ(DocumentPaths::expand({path("[c]*")}), (std::vector<std::string>{path("c.md")}));
+    EXPECT_EQ(DocumentPaths::expand({path("nest*")}), (std::vector<std::string>{path("nested/deeper/y.txt"), path("nested/z.txt")}));
+    EXPECT_TRUE(DocumentPaths::expand({path("*.pdf")}).empty());
+}
+
+TEST_F(DocumentTreeFixture, GivenOrderIsKept)
+{
+    std::vector<std::string> expected = {path("c.md"), "-", path("nested/z.txt"), path("a.txt"), path("missing.txt")};
+
+    EXPECT_EQ(DocumentPaths::expand({path("c.md"), "-", path("nested/z*"), path("a.txt"), path("missing.txt")}), expected);
+}
+
+TEST(DocumentPathsTests, RecognizesPatterns)
+{
+    EXPECT_TRUE(DocumentPaths::isPattern("docs/*.txt"));
+    EXPECT_TRUE(DocumentPaths::isPattern("file?.txt"));
+    EXPECT_TRUE(DocumentPaths::isPattern("file[12].txt"));
+    EXPECT_FALSE(DocumentPaths::isPattern("docs/file.txt"));
+    EXPECT_FALSE(DocumentPaths::isPattern("-"));
+}
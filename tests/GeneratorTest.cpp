@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+#include "Generator.hpp"
+
+static Generator<int> countTo(int last)
+{
+    for( int i = 1; i <= last; i++ ){
+        co_yield i;
+    }
+}
+
+static Generator<int> failAfter(int last)
+{
+    for( int i = 1; i <= last; i++ ){
+        co_yield i;
+    }
+    throw std::runtime_error("exhausted");
+}
+
+TEST(GeneratorTests, YieldsInOrder)
+{
+    std::vector<int> values;
+    for( int value : countTo(5) ){
+        values.push_back(value);
+    }
+
+    EXPECT_EQ(values, std::vector<int>({1, 2, 3, 4, 5}));
+}
+
+TEST(GeneratorTests, EmptySequence)
+{
+    Generator<int> generator = countTo(0);
+    EXPECT_TRUE(generator.begin() == generator.end());
+}
+
+TEST(GeneratorTests, AbandonedEarly)
+{
+    Generator<int> generator = countTo(1000);
+    auto it = generator.begin();
+    EXPECT_EQ(*it, 1);
+    ++it;
+    EXPECT_EQ(*it, 2);
+}
+
+TEST(GeneratorTests, ExceptionsReachTheConsumer)
+{
+    Generator<int> generator = failAfter(2);
+    auto it = generator.begin();
+    ++it;
+    EXPECT_THROW(++it, std::runtime_error);
+}
+
+TEST(GeneratorTests, Move)
+{
+    Generator<int> generator = countTo(3);
+    Generator<int> moved = std::move(generator);
+    generator = countTo(1);
+
+    EXPECT_EQ(*moved.begin(), 1);
+    EXPECT_EQ(*generator.begin(), 1);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include "HeavyHitters.hpp"
+
+static std::vector<Word> wordsOf(const std::vector<WordCount> &counts)
+{
+    std::vector<Word> words;
+    for( const WordCount &count : counts ){
+        words.push_back(count.word);
+    }
+    return words;
+}
+
+TEST(HeavyHittersTests, CountsExactlyWhileNotFull)
+{
+    HeavyHitters heavy_hitters(8);
+    for( std::string_view word : {"cat", "dog", "cat", "ant", "dog", "cat"} ){
+        heavy_hitters.add(word);
+    }
+
+    std::vector<WordCount> top = heavy_hitters.top(2);
+    EXPECT_EQ(wordsOf(top), (std::vector<Word>{"cat", "dog"}));
+    EXPECT_EQ(top[0].count, 3);
+    EXPECT_EQ(top[1].count, 2);
+    EXPECT_EQ(top[0].error, 0);
+    EXPECT_EQ(heavy_hitters.top(10).size(), 3);
+}
+
+TEST(HeavyHittersTests, TiesAreRankedAlphabetically)
+{
+    HeavyHitters heavy_hitters;
+    for( std::string_view word : {"pear", "apple", "fig", "apple", "pear"} ){
+        heavy_hitters.add(word);
+    }
+
+    EXPECT_EQ(wordsOf(heavy_hitters.top(3)), (std::vector<Word>{"apple", "pear", "fig"}));
+}
+
+//A skewed stream over a vocabulary far larger than the summary
+static std::vector<Word> makeZipfStream(size_t length, size_t vocabulary, unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::vector<double> weights;
+    for( size_t rank = 1; rank <= vocabulary; rank++ ){
+        weights.push_back(1.0 / rank);
+    }
+
+    std::discrete_distribution<size_t> distribution(weights.begin(), weights.end());
+    std::vector<Word> stream;
+    for( size_t position = 0; position < length; position++ ){
+        stream.push_back("w" + std::to_string(distribution(generator)));
+    }
+    return stream;
+}
+
+static void expectWithinGuarantee(const HeavyHitters &heavy_hitters, const std::map<Word, size_t> &exact, size_t stream_length)
+{
+    std::vector<WordCount> top = heavy_hitters.top(heavy_hitters.size());
+    ASSERT_LE(top.size(), heavy_hitters.capacity());
+
+    for( const WordCount &count : top ){
+        size_t true_count = exact.count(count.word) ? exact.at(count.word) : 0;
+        EXPECT_GE(count.count, true_count) << count.word;
+        EXPECT_LE(count.count - count.error, true_count) << count.word;
+        EXPECT_LE(count.error, stream_length / heavy_hitters.capacity()) << count.word;
+    }
+
+    //Every word above a 1/capacity share is counted
+    for( const auto &[word, true_count] : exact ){
+        if( true_count > stream_length / heavy_hitters.capacity() ){
+            EXPECT_TRUE(std::any_of(top.begin(), top.end(), [&word](const WordCount &count){ return count.word == word; })) << word;
+        }
+    }
+}
+
+TEST(HeavyHittersTests, EstimatesStayWithinGuarantee)
+{
+    std::vector<Word> stream = makeZipfStream(50000, 5000, 7);
+    std::map<Word, size_t> exact;
+    HeavyHitters heavy_hitters(100);
+
+    for( const Word &word : stream ){
+        heavy_hitters.add(word);
+        ++exact[word];
+    }
+
+    EXPECT_EQ(heavy_hitters.size(), 100);
+    expectWithinGuarantee(heavy_hitters, exact, stream.size());
+    EXPECT_EQ(wordsOf(heavy_hitters.top(3)), (std::vector<Word>{"w0", "w1", "w2"}));
+}
+
+TEST(HeavyHittersTests, MergedSummariesStayWithinGuarantee)
+{
+    std::vector<Word> stream = makeZipfStream(60000, 5000, 11);
+    std::map<Word, size_t> exact;
+    std::vector<HeavyHitters> parts;
+
+    for( size_t part = 0; part < 3; part++ ){
+        parts.emplace_back(100);
+    }
+
+    for( size_t position = 0; position < stream.size(); position++ ){
+        parts[position * parts.size() / stream.size()].add(stream[position]);
+        ++exact[stream[position]];
+    }
+
+    parts[0].merge(parts[1]);
+    parts[0].merge(parts[2]);
+
+    expectWithinGuarantee(parts[0], exact, stream.size());
+    EXPECT_EQ(wordsOf(parts[0].top(2)), (std::vector<Word>{"w0", "w1"}));
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include "MemoryMappedFile.hpp"
+
+TEST(MemoryMappedFileTests, MapsRegularFile)
+{
+    std::string temp_file = std::tmpnam(nullptr);
+    {
+        std::ofstream out(temp_file);
+        out << "Mapped contents.\n";
+    }
+
+    MemoryMappedFile mapped_file = MemoryMappedFile::makeFromFile(temp_file);
+    ASSERT_TRUE(mapped_file.isMapped());
+    EXPECT_EQ(mapped_file.view(), "Mapped contents.\n");
+
+    MemoryMappedFile moved = std::move(mapped_file);
+    EXPECT_FALSE(mapped_file.isMapped());
+    ASSERT_TRUE(moved.isMapped());
+    EXPECT_EQ(moved.view(), "Mapped contents.\n");
+
+    remove(temp_file.c_str());
+}
+
+TEST(MemoryMappedFileTests, EmptyFileIsMappedAsEmptyView)
+{
+    std::string temp_file = std::tmpnam(nullptr);
+    std::ofstream(temp_file).close();
+
+    MemoryMappedFile mapped_file = MemoryMappedFile::makeFromFile(temp_file);
+    EXPECT_TRUE(mapped_file.isMapped());
+    EXPECT_TRUE(mapped_file.view().empty());
+
+    remove(temp_file.c_str());
+}
+
+TEST(MemoryMappedFileTests, NonRegularOrMissingFilesAreNotMapped)
+{
+    EXPECT_FALSE(MemoryMappedFile::makeFromFile("/if/this/path/is/found/I/should/have/played/in/the/lottery/instead.txt").isMapped());
+    EXPECT_FALSE(MemoryMappedFile::makeFromFile("/dev/null").isMapped());
+}
+
+TEST(MemoryMappedFileTests, ReleasedPagesAreReadAgain)
+{
+    std::string temp_file = std::tmpnam(nullptr);
+    std::string contents;
+    for( size_t line = 0; line < 10000; line++ ){
+        contents += "Line " + std::to_string(line) + "\n";
+    }
+    std::ofstream(temp_file) << contents;
+
+    MemoryMappedFile mapped_file = MemoryMappedFile::makeFromFile(temp_file);
+    ASSERT_TRUE(mapped_file.isMapped());
+    EXPECT_EQ(mapped_file.view(), contents);
+
+    mapped_file.release(mapped_file.view());
+    mapped_file.release(mapped_file.view().substr(100, 10000));
+    mapped_file.release("Not a part of the view");
+    EXPECT_EQ(mapped_file.view(), contents);
+
+    remove(temp_file.c_str());
+}
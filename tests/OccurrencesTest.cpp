@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include "Occurrences.hpp"
+
+TEST(OccurrencesTests, IteratesAppendedSentences)
+{
+    Occurrences occurrences;
+    EXPECT_TRUE(occurrences.empty());
+    EXPECT_TRUE(occurrences.begin() == occurrences.end());
+
+    std::vector<Sentence> sentences = {1, 1, 2, 130, 130, 20000, 1ull << 40};
+    for( Sentence sentence : sentences ){
+        occurrences << sentence;
+    }
+
+    EXPECT_EQ(occurrences.size(), sentences.size());
+    EXPECT_EQ(occurrences.back(), 1ull << 40);
+    EXPECT_EQ(std::vector<Sentence>(occurrences.begin(), occurrences.end()), sentences);
+    EXPECT_EQ(occurrences.get(), sentences);
+}
+
+TEST(OccurrencesTests, SmallGapsTakeOneByte)
+{
+    Occurrences occurrences;
+    for( Sentence sentence = 1; sentence <= 1000; sentence += 3 ){
+        occurrences << sentence;
+    }
+
+    EXPECT_EQ(occurrences.encodedSize(), occurrences.size());
+
+    occurrences << 1000 + 128;
+    EXPECT_EQ(occurrences.encodedSize(), occurrences.size() + 1);
+}
+
+TEST(OccurrencesTests, SmallerSentencesStillRoundTrip)
+{
+    Occurrences occurrences;
+    occurrences << 10 << 3 << 7;
+
+    EXPECT_EQ(occurrences.get(), std::vector<Sentence>({10, 3, 7}));
+}
+
+TEST(OccurrencesTests, EqualityComparesSentences)
+{
+    Occurrences first;
+    Occurrences second;
+    first << 1 << 5;
+    second << 1;
+    EXPECT_FALSE(first == second);
+
+    second << 5;
+    EXPECT_TRUE(first == second);
+}
+
+static void expectRoundTrip(const std::vector<Sentence> &sentences)
+{
+    Occurrences occurrences;
+    for( Sentence sentence : sentences ){
+        occurrences << sentence;
+    }
+
+    EXPECT_EQ(occurrences.size(), sentences.size());
+    ASSERT_EQ(occurrences.get(), sentences);
+
+    Occurrences copy = occurrences;
+    EXPECT_TRUE(copy == occurrences);
+}
+
+//Found in nearly every sentence, some sentences more than once
+TEST(OccurrencesTests, StopWordsUseBitmaps)
+{
+    std::vector<Sentence> sentences;
+    unsigned state = 5;
+
+    for( Sentence sentence = 1; sentence <= 400000; sentence++ ){
+        state = state * 1103515245 + 12345;
+        for( unsigned repeat = 0; repeat < (state >> 16) % 3; repeat++ ){
+            sentences.push_back(sentence);
+        }
+    }
+
+    Occurrences occurrences;
+    for( Sentence sentence : sentences ){
+        occurrences << sentence;
+    }
+
+    EXPECT_EQ(occurrences.get(), sentences);
+    EXPECT_LT(occurrences.encodedSize(), sentences.size() / 2);
+    expectRoundTrip(sentences);
+}
+
+TEST(OccurrencesTests, ConsecutiveSentencesUseRuns)
+{
+    std::vector<Sentence> sentences;
+    //Only the last block, which stays open, is kept as gaps
+    for( Sentence sentence = 1; sentence <= 4 * 65536 + 1000; sentence++ ){
+        if( sentence % 50000 < 40000 ){
+            sentences.push_back(sentence);
+        }
+    }
+
+    Occurrences occurrences;
+    for( Sentence sentence : sentences ){
+        occurrences << sentence;
+    }
+
+    EXPECT_EQ(occurrences.get(), sentences);
+    EXPECT_LT(occurrences.encodedSize(), 2048);
+}
+
+TEST(OccurrencesTests, MixedDensitiesRoundTrip)
+{
+    std::vector<Sentence> sentences;
+    unsigned state = 9;
+    Sentence sentence = 0;
+
+    //Stretches of sparse, dense and repeated sentences
+    for( int stretch = 0; stretch < 60; stretch++ ){
+        state = state * 1103515245 + 12345;
+        unsigned density = (state >> 16) % 4;
+
+        for( int i = 0; i < 20000; i++ ){
+            state = state * 1103515245 + 12345;
+            sentence += density == 0 ? (state >> 16) % 5000 : density == 1 ? 1 : (state >> 16) % 3;
+            sentences.push_back(sentence);
+        }
+    }
+
+    expectRoundTrip(sentences);
+}
+
+TEST(OccurrencesTests, SmallerSentencesAfterSealing)
+{
+    std::vector<Sentence> sentences;
+    for( Sentence sentence = 1; sentence <= 150000; sentence++ ){
+        sentences.push_back(sentence);
+    }
+    sentences.push_back(7);
+    sentences.push_back(200000);
+    sentences.push_back(3);
+
+    expectRoundTrip(sentences);
+}
+
+TEST(OccurrencesTests, AppendShiftsSentences)
+{
+    Occurrences sparse;
+    sparse << 2 << 5 << 5;
+
+    Occurrences dense;
+    for( Sentence sentence = 1; sentence <= 3 * 65536; sentence++ ){
+        dense << sentence;
+    }
+
+    Occurrences appended;
+    appended << 1 << 3;
+    appended.append(sparse, 10);
+    appended.append(dense, 100);
+
+    Occurrences expected;
+    expected << 1 << 3 << 12 << 15 << 15;
+    for( Sentence sentence = 1; sentence <= 3 * 65536; sentence++ ){
+        expected << sentence + 100;
+    }
+
+    EXPECT_EQ(appended.get(), expected.get());
+    EXPECT_EQ(appended.back(), expected.back());
+    EXPECT_TRUE(appended == expected);
+
+    Occurrences copied;
+    copied.append(sparse);
+    EXPECT_TRUE(copied == sparse);
+}
+
+TEST(OccurrencesTests, SizeIsKeptAcrossEveryChange)
+{
+    Occurrences occurrences;
+    for( Sentence sentence = 1; sentence <= 2 * 65536; sentence += 2 ){
+        occurrences << sentence << sentence;
+    }
+    EXPECT_EQ(occurrences.size(), 2 * 65536);
+
+    Occurrences sparse;
+    sparse << 2 << 5 << 5;
+    occurrences.append(sparse, 2 * 65536);
+    EXPECT_EQ(occurrences.size(), 2 * 65536 + 3);
+
+    Occurrences from_gaps = Occurrences::makeFromGaps(sparse.encodeGaps(), sparse.back());
+    EXPECT_EQ(from_gaps.size(), 3);
+
+    Occurrences moved = std::move(occurrences);
+    EXPECT_EQ(moved.size(), 2 * 65536 + 3);
+    EXPECT_EQ(occurrences.size(), 0);
+    EXPECT_TRUE(occurrences.empty());
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <set>
+#include "RadixTrie.hpp"
+
+static std::vector<std::string> collectWords(const RadixTrie &trie)
+{
+    std::vector<std::string> words;
+    trie.forEachWord([&words](const std::string &word, WordId){
+        words.push_back(word);
+    });
+    return words;
+}
+
+static std::vector<std::string> collectPrefixed(const RadixTrie &trie, std::string_view prefix)
+{
+    std::vector<std::string> words;
+    trie.forEachWithPrefix(prefix, [&words](const std::string &word, WordId){
+        words.push_back(word);
+    });
+    return words;
+}
+
+static std::vector<std::string> collectRange(const RadixTrie &trie, std::string_view first, std::string_view last)
+{
+    std::vector<std::string> words;
+    trie.forEachInRange(first, last, [&words](const std::string &word, WordId){
+        words.push_back(word);
+    });
+    return words;
+}
+
+TEST(RadixTrieTests, FindsInsertedWords)
+{
+    RadixTrie trie;
+    EXPECT_TRUE(trie.empty());
+    EXPECT_EQ(trie.find("word"), nullptr);
+
+    trie.findOrInsert("word") << 1;
+    trie.findOrInsert("wordy") << 2;
+    trie.findOrInsert("work") << 3;
+    trie.findOrInsert("word") << 4;
+
+    EXPECT_EQ(trie.size(), 3);
+    ASSERT_NE(trie.find("word"), nullptr);
+    EXPECT_EQ(trie.find("word")->get(), std::vector<Sentence>({1, 4}));
+    EXPECT_EQ(trie.find("wordy")->get(), std::vector<Sentence>({2}));
+    EXPECT_EQ(trie.find("work")->get(), std::vector<Sentence>({3}));
+
+    //Split points and partial labels are not words
+    EXPECT_EQ(trie.find("wor"), nullptr);
+    EXPECT_EQ(trie.find("wo"), nullptr);
+    EXPECT_EQ(trie.find("words"), nullptr);
+    EXPECT_EQ(trie.find(""), nullptr);
+}
+
+TEST(RadixTrieTests, IdsCountInInsertionOrder)
+{
+    RadixTrie trie;
+    EXPECT_EQ(trie.insert("romane"), 0);
+    EXPECT_EQ(trie.insert("romanus"), 1);
+    EXPECT_EQ(trie.insert("rom"), 2);
+    EXPECT_EQ(trie.insert("romane"), 0);
+    EXPECT_EQ(trie.insert(""), 3);
+
+    trie.occurrences(2) << 7;
+    EXPECT_EQ(trie.find("rom")->get(), std::vector<Sentence>({7}));
+}
+
+TEST(RadixTrieTests, WalksInAlphabeticalOrder)
+{
+    std::vector<std::string> words = {"ruber", "rubicon", "rom", "romulus", "rubens", "romane", "romanus", "a", "z", "r", "\xC3\xA9t\xC3\xA9", "etc"};
+    RadixTrie trie;
+    for( const std::string &word : words ){
+        trie.insert(word);
+    }
+
+    std::sort(words.begin(), words.end());
+    EXPECT_EQ(collectWords(trie), words);
+}
+
+TEST(RadixTrieTests, PrefixQueries)
+{
+    RadixTrie trie;
+    for( std::string_view word : {"concord", "concordance", "concordances", "concur", "con", "cone", "bond", "cons"} ){
+        trie.insert(word);
+    }
+
+    EXPECT_EQ(collectPrefixed(trie, "concord"), (std::vector<std::string>{"concord", "concordance", "concordances"}));
+    EXPECT_EQ(collectPrefixed(trie, "conc"), (std::vector<std::string>{"concord", "concordance", "concordances", "concur"}));
+    EXPECT_EQ(collectPrefixed(trie, "co"), (std::vector<std::string>{"con", "concord", "concordance", "concordances", "concur", "cone", "cons"}));
+    EXPECT_EQ(collectPrefixed(trie, "concordanc"), (std::vector<std::string>{"concordance", "concordances"}));
+    EXPECT_EQ(collectPrefixed(trie, "concx"), std::vector<std::string>());
+    EXPECT_EQ(collectPrefixed(trie, "d"), std::vector<std::string>());
+    EXPECT_EQ(collectPrefixed(trie, ""), collectWords(trie));
+}
+
+TEST(RadixTrieTests, RangeQueries)
+{
+    RadixTrie trie;
+    for( std::string_view word : {"apple", "apricot", "banana", "band", "bandana", "cherry"} ){
+        trie.insert(word);
+    }
+
+    EXPECT_EQ(collectRange(trie, "apricot", "band"), (std::vector<std::string>{"apricot", "banana"}));
+    EXPECT_EQ(collectRange(trie, "b", "c"), (std::vector<std::string>{"banana", "band", "bandana"}));
+    EXPECT_EQ(collectRange(trie, "ban", "bandz"), (std::vector<std::string>{"banana", "band", "bandana"}));
+    EXPECT_EQ(collectRange(trie, "bandb", "zzz"), (std::vector<std::string>{"cherry"}));
+    EXPECT_EQ(collectRange(trie, "a", "apple"), std::vector<std::string>());
+    EXPECT_EQ(collectRange(trie, "c", "a"), std::vector<std::string>());
+}
+
+TEST(RadixTrieTests, MatchesSortedSetOnRandomWords)
+{
+    std::mt19937 random(11);
+    std::set<std::string> expected;
+    RadixTrie trie;
+
+    //A small alphabet, so words share long prefixes and labels split often
+    for( int i = 0; i < 20000; i++ ){
+        std::string word(1 + random() % 8, 'a');
+        for( char &letter : word ){
+            letter = static_cast<char>('a' + random() % 4);
+        }
+        trie.insert(word);
+        expected.insert(word);
+    }
+
+    EXPECT_EQ(trie.size(), expected.size());
+    EXPECT_EQ(collectWords(trie), std::vector<std::string>(expected.begin(), expected.end()));
+
+    for( std::string_view prefix : {"a", "ab", "abc", "dddd", "cab"} ){
+        std::vector<std::string> prefixed;
+        std::copy_if(expected.begin(), expected.end(), std::back_inserter(prefixed), [prefix](const std::string &word){
+            return word.starts_with(prefix);
+        });
+        EXPECT_EQ(collectPrefixed(trie, prefix), prefixed);
+    }
+
+    std::vector<std::string> ranged(expected.lower_bound("bad"), expected.lower_bound("cc"));
+    EXPECT_EQ(collectRange(trie, "bad", "cc"), ranged);
+}
@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 #include <fstream>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstdlib>
 #include "TextDocumentTraveller.hpp"
 
 class DocumentTravellerAbstractFixture : public ::testing::Test {
@@ -265,6 +269,245 @@ TEST_F(DocumentTravellerSimpleSentence, TestSimpleSentence)
     EXPECT_FALSE(traveller.hasNext());
 }
 
+static std::vector<DocumentElement> travelAll(const std::string &filepath, ReadMode mode)
+{
+    std::vector<DocumentElement> elements;
+    TextDocumentTraveller traveller(filepath, mode);
+
+    while( traveller.hasNext() ){
+        elements.push_back(traveller.getNext());
+    }
+
+    return elements;
+}
+
+static void expectSameElements(const std::vector<DocumentElement> &actual, const std::vector<DocumentElement> &expected)
+{
+    ASSERT_EQ(actual.size(), expected.size());
+    for( size_t i = 0; i < actual.size(); i++ ){
+        ASSERT_EQ(actual[i].index(), expected[i].index()) << "Element: " << i;
+
+        if( const Word *word = std::get_if<Word>(&actual[i]) ){
+            EXPECT_EQ(*word, std::get<Word>(expected[i]));
+        } else{
+            EXPECT_EQ(std::get<Symbol>(actual[i]).get(), std::get<Symbol>(expected[i]).get());
+        }
+    }
+}
+
+TEST_F(DocumentTravellerExample, ReadModesProduceSameElements)
+{
+    std::vector<DocumentElement> streamed = travelAll(m_temp_file, ReadMode::Stream);
+    std::vector<DocumentElement> mapped = travelAll(m_temp_file, ReadMode::MemoryMapped);
+    expectSameElements(streamed, mapped);
+}
+
+TEST_F(DocumentTravellerSimpleSentence, TokensViewTheDocument)
+{
+    for( ReadMode mode : {ReadMode::Stream, ReadMode::MemoryMapped} ){
+        TextDocumentTraveller traveller(m_temp_file, mode);
+        std::vector<std::string> texts;
+
+        while( traveller.hasNext() ){
+            Token token = traveller.getNextToken();
+            EXPECT_EQ(token.isSymbol(), token.text() == ".");
+            texts.emplace_back(token.text());
+        }
+
+        std::vector<std::string> expected = {"This", "is", "a", "simple", "sentence", "."};
+        EXPECT_EQ(texts, expected);
+    }
+}
+
+TEST_F(DocumentTravellerExample, BatchesMatchSingleElements)
+{
+    for( ReadMode mode : {ReadMode::Stream, ReadMode::MemoryMapped} ){
+        std::vector<DocumentElement> expected = travelAll(m_temp_file, mode);
+        std::vector<DocumentElement> batched;
+
+        TextDocumentTraveller traveller(m_temp_file, mode);
+        std::array<Token, 7> tokens;
+
+        while( size_t count = traveller.next(tokens) ){
+            for( size_t i = 0; i < count; i++ ){
+                batched.push_back(tokens[i].materialize());
+            }
+        }
+
+        expectSameElements(batched, expected);
+    }
+}
+
+TEST_F(DocumentTravellerExample, GeneratorMatchesSingleElements)
+{
+    for( ReadMode mode : {ReadMode::Stream, ReadMode::MemoryMapped} ){
+        std::vector<DocumentElement> expected = travelAll(m_temp_file, mode);
+        std::vector<DocumentElement> generated;
+
+        TextDocumentTraveller traveller(m_temp_file, mode);
+        for( const Token &token : traveller.elements() ){
+            generated.push_back(token.materialize());
+        }
+
+        expectSameElements(generated, expected);
+    }
+}
+
+TEST_F(DocumentTravellerExample, GeneratorContinuesAfterPulledElements)
+{
+    std::vector<DocumentElement> expected = travelAll(m_temp_file, ReadMode::MemoryMapped);
+    std::vector<DocumentElement> elements;
+
+    TextDocumentTraveller traveller(m_temp_file, ReadMode::MemoryMapped);
+    elements.push_back(traveller.getNext());
+    elements.push_back(traveller.getNext());
+
+    for( const Token &token : traveller.elements() ){
+        elements.push_back(token.materialize());
+    }
+
+    expectSameElements(elements, expected);
+}
+
+//==========================================================================|
+// @brief: Hands out at most a few bytes per read, so chunks get split		|
+//		   across the blocks of the traveller								|
+//==========================================================================|
+class TricklingSource : public ByteSource
+{
+public:
+    TricklingSource(std::string text, size_t bytes_per_read) : m_text(std::move(text)), m_bytes_per_read(bytes_per_read) {}
+
+    size_t read(char *buffer, size_t capacity) override
+    {
+        size_t count = std::min({capacity, m_bytes_per_read, m_text.size() - m_position});
+        std::copy_n(m_text.data() + m_position, count, buffer);
+        m_position += count;
+        return count;
+    }
+
+private:
+    std::string m_text;
+    size_t m_bytes_per_read;
+    size_t m_position = 0;
+};
+
+TEST_F(DocumentTravellerExample, ChunksSplitAcrossReads)
+{
+    std::vector<DocumentElement> expected = travelAll(m_temp_file, ReadMode::MemoryMapped);
+
+    std::ifstream in(m_temp_file);
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    for( size_t bytes_per_read : {1, 2, 3, 7} ){
+        std::vector<DocumentElement> trickled;
+        TextDocumentTraveller traveller(std::make_unique<TricklingSource>(text, bytes_per_read));
+
+        while( traveller.hasNext() ){
+            trickled.push_back(traveller.getNext());
+        }
+
+        expectSameElements(trickled, expected);
+
+        std::vector<DocumentElement> generated;
+        TextDocumentTraveller generating_traveller(std::make_unique<TricklingSource>(text, bytes_per_read));
+
+        for( const Token &token : generating_traveller.elements() ){
+            generated.push_back(token.materialize());
+        }
+
+        expectSameElements(generated, expected);
+    }
+}
+
+TEST_F(DocumentTravellerExample, GzipDocumentIsDecoded)
+{
+    if( !ByteSource::isSupported(Compression::Gzip) ){
+        GTEST_SKIP() << "Built without zlib";
+    }
+
+    std::string gzip_file = m_temp_file + ".gz";
+    ASSERT_EQ(std::system(("gzip -c " + m_temp_file + " > " + gzip_file).c_str()), 0);
+
+    std::vector<DocumentElement> expected = travelAll(m_temp_file, ReadMode::MemoryMapped);
+    for( ReadMode mode : {ReadMode::Stream, ReadMode::MemoryMapped} ){
+        expectSameElements(travelAll(gzip_file, mode), expected);
+    }
+
+    remove(gzip_file.c_str());
+}
+
+static std::vector<std::string> travelTexts(std::string text, TextEncoding encoding)
+{
+    std::vector<std::string> texts;
+    TextDocumentTraveller traveller(ByteSource::makeFromMemory(std::move(text)), encoding);
+
+    while( traveller.hasNext() ){
+        texts.emplace_back(traveller.getNextToken().text());
+    }
+
+    return texts;
+}
+
+TEST(DocumentTravellerUtf8, LettersOutsideAsciiFormWords)
+{
+    //"Καλημέρα, κόσμε; Ναι." with a Greek question mark
+    std::string text = "\xce\x9a\xce\xb1\xce\xbb\xce\xb7\xce\xbc\xce\xad\xcf\x81\xce\xb1, "
+                       "\xce\xba\xcf\x8c\xcf\x83\xce\xbc\xce\xb5\xcd\xbe "
+                       "\xce\x9d\xce\xb1\xce\xb9.";
+
+    std::vector<std::string> expected = {
+        "\xce\x9a\xce\xb1\xce\xbb\xce\xb7\xce\xbc\xce\xad\xcf\x81\xce\xb1", ",",
+        "\xce\xba\xcf\x8c\xcf\x83\xce\xbc\xce\xb5", "\xcd\xbe",
+        "\xce\x9d\xce\xb1\xce\xb9", "."};
+    EXPECT_EQ(travelTexts(text, TextEncoding::Utf8), expected);
+
+    //Byte by byte every non ASCII byte is a symbol
+    EXPECT_EQ(travelTexts("\xce\xb1\xce\xb2", TextEncoding::Ascii), std::vector<std::string>({"\xce", "\xb1", "\xce", "\xb2"}));
+}
+
+TEST(DocumentTravellerUtf8, AbbreviationsAndSpecialCharacters)
+{
+    EXPECT_EQ(travelTexts("\xcf\x80.\xcf\x87. caf\xc3\xa9\xc2\xb0x", TextEncoding::Utf8),
+              std::vector<std::string>({"\xcf\x80.\xcf\x87.", "caf\xc3\xa9\xc2\xb0x"}));
+    EXPECT_EQ(travelTexts("\xc2\xabquoted\xc2\xbb", TextEncoding::Utf8),
+              std::vector<std::string>({"\xc2\xab", "quoted", "\xc2\xbb"}));
+}
+
+TEST(DocumentTravellerUtf8, AsciiDocumentsSplitAsUnderAscii)
+{
+    std::string text = "Given an arbitrary text, i.e. (a list) of b@11$h!t; words... Done!\n";
+    EXPECT_EQ(travelTexts(text, TextEncoding::Utf8), travelTexts(text, TextEncoding::Ascii));
+}
+
+TEST(DocumentTravellerUtf8, GreekQuestionMarkChangesSentence)
+{
+    TextDocumentTraveller traveller(ByteSource::makeFromMemory("\xcd\xbe \xc2\xb0"), TextEncoding::Utf8);
+    ASSERT_TRUE(traveller.hasNext());
+    EXPECT_TRUE(changesSentence(traveller.getNextToken()));
+    ASSERT_TRUE(traveller.hasNext());
+    EXPECT_FALSE(changesSentence(traveller.getNextToken()));
+    EXPECT_TRUE(changesSentence(Token(Token::Kind::Symbol, ";")));
+    EXPECT_FALSE(changesSentence(Token(Token::Kind::Word, "Word")));
+}
+
+TEST(TokenStruct, Materialization)
+{
+    DocumentElement word = Token(Token::Kind::Word, "i.e.").materialize();
+    ASSERT_TRUE(std::get_if<Word>(&word));
+    EXPECT_EQ(std::get<Word>(word), "i.e.");
+
+    DocumentElement symbol = Token(Token::Kind::Symbol, ";").materialize();
+    ASSERT_TRUE(std::get_if<Symbol>(&symbol));
+    EXPECT_EQ(std::get<Symbol>(symbol).get(), ';');
+}
+
+TEST(DocumentTravellerEdgeCases, NonRegularFileFallsBackToStream)
+{
+    TextDocumentTraveller traveller("/dev/null", ReadMode::MemoryMapped);
+    ASSERT_FALSE(traveller.hasNext());
+}
+
 TEST(DocumentTravellerEdgeCases, NonExistingFile)
 {
     TextDocumentTraveller traveller("/if/this/path/is/found/I/should/have/played/in/the/lottery/instead.txt");
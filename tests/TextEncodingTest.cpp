@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "TextEncoding.hpp"
+#include "CharacterClasses.hpp"
+
+TEST(Utf8Tests, DecodesEverySequenceSize)
+{
+    char32_t code_point;
+    EXPECT_EQ(Utf8::decode("a", code_point), 1);
+    EXPECT_EQ(code_point, U'a');
+    EXPECT_EQ(Utf8::decode("\xc3\xa9!", code_point), 2);
+    EXPECT_EQ(code_point, U'é');
+    EXPECT_EQ(Utf8::decode("\xe2\x80\xa6", code_point), 3);
+    EXPECT_EQ(code_point, U'…');
+    EXPECT_EQ(Utf8::decode("\xf0\x9f\x98\x80", code_point), 4);
+    EXPECT_EQ(code_point, U'\U0001F600');
+    EXPECT_EQ(Utf8::decode("", code_point), 0);
+}
+
+TEST(Utf8Tests, MalformedSequencesDecodeByteByByte)
+{
+    char32_t code_point;
+    for( std::string_view malformed : {"\x80", "\xc3", "\xc3" "a", "\xc0\xaf", "\xed\xa0\x80", "\xf5\x80\x80\x80"} ){
+        EXPECT_EQ(Utf8::decode(malformed, code_point), 1);
+        EXPECT_EQ(code_point, Utf8::ReplacementCharacter);
+    }
+}
+
+TEST(Utf8Tests, EncodeRoundTrips)
+{
+    for( char32_t code_point : {U'a', U'é', U'Σ', U'…', U'\U0001F600'} ){
+        std::string encoded;
+        Utf8::encode(code_point, encoded);
+
+        char32_t decoded;
+        EXPECT_EQ(Utf8::decode(encoded, decoded), encoded.size());
+        EXPECT_EQ(decoded, code_point);
+    }
+}
+
+TEST(Utf8Tests, AsciiKeepsItsTable)
+{
+    for( char32_t code_point = 0; code_point < 0x80; code_point++ ){
+        EXPECT_EQ(Utf8::classify(code_point), classify(static_cast<char>(code_point)));
+    }
+}
+
+TEST(Utf8Tests, LettersAndCases)
+{
+    for( char32_t uppercase : {U'É', U'Α', U'Σ', U'Ά', U'Ж', U'Ё', U'Ł'} ){
+        EXPECT_TRUE(Utf8::classify(uppercase) & Uppercase);
+        EXPECT_TRUE(Utf8::classify(uppercase) & Alphabetic);
+    }
+
+    for( char32_t lowercase : {U'é', U'ß', U'α', U'ς', U'ά', U'ж', U'ł'} ){
+        EXPECT_TRUE(Utf8::classify(lowercase) & Lowercase);
+        EXPECT_TRUE(Utf8::classify(lowercase) & Alphabetic);
+    }
+
+    EXPECT_EQ(Utf8::classify(U'×'), 0);
+    EXPECT_EQ(Utf8::classify(U'́'), Alphanumeric);
+    EXPECT_EQ(Utf8::classify(U';'), WordTerminating | SentenceTerminating);
+    EXPECT_EQ(Utf8::classify(U'中'), 0);
+}
+
+TEST(Utf8Tests, Lowercasing)
+{
+    EXPECT_EQ(Utf8::toLowercase(U'A'), U'a');
+    EXPECT_EQ(Utf8::toLowercase(U'É'), U'é');
+    EXPECT_EQ(Utf8::toLowercase(U'Σ'), U'σ');
+    EXPECT_EQ(Utf8::toLowercase(U'Ώ'), U'ώ');
+    EXPECT_EQ(Utf8::toLowercase(U'Ё'), U'ё');
+    EXPECT_EQ(Utf8::toLowercase(U'Ж'), U'ж');
+    EXPECT_EQ(Utf8::toLowercase(U'İ'), U'i');
+    EXPECT_EQ(Utf8::toLowercase(U'Ÿ'), U'ÿ');
+    EXPECT_EQ(Utf8::toLowercase(U'Ł'), U'ł');
+    EXPECT_EQ(Utf8::toLowercase(U'é'), U'é');
+    EXPECT_EQ(Utf8::toLowercase(U'中'), U'中');
+}
+
+TEST(Utf8Tests, UppercaseStarts)
+{
+    EXPECT_TRUE(Utf8::startsWithUppercase("Hello"));
+    EXPECT_TRUE(Utf8::startsWithUppercase("\xce\x9a\xce\xb1\xce\xbb\xce\xb7"));
+    EXPECT_FALSE(Utf8::startsWithUppercase("\xce\xba\xce\xb1\xce\xbb\xce\xb7"));
+    EXPECT_FALSE(Utf8::startsWithUppercase("hello"));
+    EXPECT_FALSE(Utf8::startsWithUppercase(""));
+}
+
+TEST(Utf8Tests, AsciiDetection)
+{
+    EXPECT_TRUE(Utf8::isAscii(""));
+    EXPECT_TRUE(Utf8::isAscii("plain ascii text, even a long one with more than thirty two bytes"));
+    EXPECT_FALSE(Utf8::isAscii("plain ascii text, even a long one with more than thirty two bytes caf\xc3\xa9"));
+}
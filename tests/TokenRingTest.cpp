@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include <array>
+#include "TokenRing.hpp"
+
+static Token makeWord(std::string_view text)
+{
+    return Token(Token::Kind::Word, text);
+}
+
+TEST(TokenRingTests, FifoOrderAcrossWrapAround)
+{
+    TokenRing ring(3);
+    EXPECT_TRUE(ring.empty());
+
+    ring.push(makeWord("a"));
+    ring.push(makeWord("b"));
+    EXPECT_EQ(ring.pop().text(), "a");
+
+    ring.push(makeWord("c"));
+    ring.push(makeWord("d"));
+    EXPECT_TRUE(ring.full());
+
+    EXPECT_EQ(ring.pop().text(), "b");
+    EXPECT_EQ(ring.pop().text(), "c");
+    EXPECT_EQ(ring.pop().text(), "d");
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(TokenRingTests, PopIntoCopiesWrappedRange)
+{
+    TokenRing ring(4);
+    ring.push(makeWord("a"));
+    ring.push(makeWord("b"));
+    ring.push(makeWord("c"));
+    ring.pop();
+    ring.pop();
+    ring.push(makeWord("d"));
+    ring.push(makeWord("e"));
+    ring.push(makeWord("f"));
+
+    std::array<Token, 3> out;
+    ASSERT_EQ(ring.popInto(out), 3);
+    EXPECT_EQ(out[0].text(), "c");
+    EXPECT_EQ(out[1].text(), "d");
+    EXPECT_EQ(out[2].text(), "e");
+
+    ASSERT_EQ(ring.popInto(out), 1);
+    EXPECT_EQ(out[0].text(), "f");
+    EXPECT_EQ(ring.popInto(out), 0);
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <string_view>
+#include "WordBoundaryAutomaton.hpp"
+
+using namespace WordBoundaryAutomaton;
+
+//The table is a compile time constant
+static_assert(step(InitialState, OtherTerminator).action == Action::EndBeforeCurrent);
+static_assert(step(InitialState, DotInput).action == Action::Continue);
+
+//Feeds every byte of an ASCII word to the automaton and returns where it ends
+static size_t findEnd(std::string_view word)
+{
+    State state = InitialState;
+
+    for( size_t current = 0; current < word.size(); current++ ){
+        Transition transition = step(state, toInput(classify(word[current])));
+
+        if( transition.action == Action::EndBeforeCurrent ){
+            return current;
+        } else if( transition.action == Action::EndBeforePendingDot ){
+            return current - 1;
+        }
+        state = transition.next_state;
+    }
+
+    return step(state, EndOfChunk).action == Action::EndBeforePendingDot ? word.size() - 1 : word.size();
+}
+
+TEST(WordBoundaryAutomatonTests, ReducesCharacterClassesToInputs)
+{
+    EXPECT_EQ(toInput(classify('a')), LowercaseLetter);
+    EXPECT_EQ(toInput(classify('A')), OtherAlphanumeric);
+    EXPECT_EQ(toInput(classify('7')), OtherAlphanumeric);
+    EXPECT_EQ(toInput(classify('.')), DotInput);
+    EXPECT_EQ(toInput(classify(',')), OtherTerminator);
+    EXPECT_EQ(toInput(classify('-')), NonTerminatingSymbol);
+}
+
+TEST(WordBoundaryAutomatonTests, EnglishWordEndsOnTerminator)
+{
+    EXPECT_EQ(findEnd("well,no"), 4);
+    EXPECT_EQ(findEnd("word"), 4);
+    EXPECT_EQ(findEnd("end."), 3);
+    EXPECT_EQ(findEnd("end.Next"), 3);
+    EXPECT_EQ(findEnd("end.7"), 3);
+}
+
+TEST(WordBoundaryAutomatonTests, DotBeforeLowercaseStartsAbbreviation)
+{
+    EXPECT_EQ(findEnd("i.e."), 4);
+    EXPECT_EQ(findEnd("i.e.,"), 4);
+    EXPECT_EQ(findEnd("e.g..so"), 4);
+    EXPECT_EQ(findEnd("a.b.C"), 5);
+    EXPECT_EQ(findEnd("a.b!"), 3);
+}
+
+TEST(WordBoundaryAutomatonTests, SpecialCharactersSpanTheChunk)
+{
+    EXPECT_EQ(findEnd("e-mail,"), 7);
+    EXPECT_EQ(findEnd("a-b.C"), 5);
+    EXPECT_EQ(findEnd("a-b.c.."), 6);
+}
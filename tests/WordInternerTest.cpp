@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <set>
+#include "WordInterner.hpp"
+
+TEST(WordInternerTests, IdsAreDenseInFirstSeenOrder)
+{
+    WordInterner interner;
+    EXPECT_TRUE(interner.empty());
+
+    EXPECT_EQ(interner.intern("beta"), 0);
+    EXPECT_EQ(interner.intern("alpha"), 1);
+    EXPECT_EQ(interner.intern("beta"), 0);
+    EXPECT_EQ(interner.intern(""), 2);
+
+    EXPECT_EQ(interner.size(), 3);
+    EXPECT_EQ(interner.word(0), "beta");
+    EXPECT_EQ(interner.word(1), "alpha");
+    EXPECT_EQ(interner.word(2), "");
+    EXPECT_EQ(interner.find("alpha"), 1);
+    EXPECT_EQ(interner.find("gamma"), WordInterner::NoWord);
+}
+
+TEST(WordInternerTests, WordsDoNotDependOnTheInternedBuffer)
+{
+    WordInterner interner;
+    std::string buffer = "first";
+    interner.intern(buffer);
+    buffer = "other";
+
+    EXPECT_EQ(interner.word(0), "first");
+}
+
+TEST(WordInternerTests, WordsLongerThanABlock)
+{
+    WordInterner interner;
+    std::string long_word(200000, 'x');
+
+    interner.intern("short");
+    EXPECT_EQ(interner.intern(long_word), 1);
+    EXPECT_EQ(interner.intern("after"), 2);
+
+    EXPECT_EQ(interner.word(0), "short");
+    EXPECT_EQ(interner.word(1), long_word);
+    EXPECT_EQ(interner.word(2), "after");
+}
+
+TEST(WordInternerTests, CopiesOwnTheirWords)
+{
+    WordInterner copy;
+    {
+        WordInterner interner;
+        interner.intern("one");
+        interner.intern("two");
+        copy = interner;
+    }
+
+    EXPECT_EQ(copy.word(1), "two");
+    EXPECT_EQ(copy.find("one"), 0);
+    EXPECT_EQ(copy.intern("three"), 2);
+}
+
+//Enough words to grow the table many times and to be sorted in slices
+TEST(WordInternerTests, GrowsAndSortsLargeVocabularies)
+{
+    WordInterner interner;
+    std::set<std::string> expected;
+    unsigned state = 11;
+
+    for( int i = 0; i < 300000; i++ ){
+        state = state * 1103515245 + 12345;
+        std::string word = std::to_string((state >> 8) % 200000);
+        interner.intern(word);
+        expected.insert(word);
+    }
+
+    ASSERT_EQ(interner.size(), expected.size());
+
+    std::vector<WordId> sorted = interner.sortedIds();
+    ASSERT_EQ(sorted.size(), expected.size());
+    EXPECT_TRUE(std::equal(sorted.begin(), sorted.end(), expected.begin(), [&interner](WordId id, const std::string &word){
+        return interner.word(id) == word;
+    }));
+
+    for( const std::string &word : expected ){
+        ASSERT_EQ(interner.word(interner.find(word)), word);
+    }
+}
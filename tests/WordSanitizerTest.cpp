@@ -25,4 +25,25 @@ TEST(WordSanitization, NumberAcronyms)
     EXPECT_EQ("i2i", sanitizer.sanitize("I2I"));
     EXPECT_EQ("b.2.b.", sanitizer.sanitize("B.2.B."));
     EXPECT_EQ("a.g.", sanitizer.sanitize("a.g."));
-}
\ No newline at end of file
+}
+
+TEST(WordSanitization, ReusedBuffer)
+{
+    Word sanitized;
+    WordSanitizer::sanitize("LongerWord", sanitized);
+    EXPECT_EQ("longerword", sanitized);
+    WordSanitizer::sanitize("Tiny", sanitized);
+    EXPECT_EQ("tiny", sanitized);
+}
+
+TEST(WordSanitization, Utf8Lowercasing)
+{
+    EXPECT_EQ("\xce\xba\xce\xb1\xce\xbb\xce\xb7\xce\xbc\xce\xad\xcf\x81\xce\xb1",
+              WordSanitizer::sanitize("\xce\x9a\xce\x91\xce\x9b\xce\x97\xce\x9c\xce\x88\xce\xa1\xce\x91", TextEncoding::Utf8));
+    EXPECT_EQ("caf\xc3\xa9", WordSanitizer::sanitize("CAF\xc3\x89", TextEncoding::Utf8));
+    EXPECT_EQ("\xd0\xb6\xd1\x91", WordSanitizer::sanitize("\xd0\x96\xd0\x81", TextEncoding::Utf8));
+    EXPECT_EQ("ascii", WordSanitizer::sanitize("ASCII", TextEncoding::Utf8));
+
+    //Outside Utf8 only ASCII letters are lowercased
+    EXPECT_EQ("caf\xc3\x89", WordSanitizer::sanitize("CAF\xc3\x89"));
+}
@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+#include "WordTable.hpp"
+
+TEST(WordTableTests, FindsInsertedWords)
+{
+    WordTable table;
+    EXPECT_TRUE(table.empty());
+    EXPECT_EQ(table.find("word"), nullptr);
+
+    table.findOrInsert("word") << 1;
+    table.findOrInsert("other") << 2;
+    table.findOrInsert("word") << 3;
+
+    EXPECT_EQ(table.size(), 2);
+    ASSERT_NE(table.find("word"), nullptr);
+    EXPECT_EQ(table.find("word")->get(), std::vector<Sentence>({1, 3}));
+    EXPECT_EQ(table.find("other")->get(), std::vector<Sentence>({2}));
+    EXPECT_EQ(table.find("wor"), nullptr);
+}
+
+TEST(WordTableTests, PostingsAreIndexedById)
+{
+    WordTable table;
+    for( std::string_view word : {"c", "a", "b", "a"} ){
+        table.findOrInsert(word) << table.size();
+    }
+
+    EXPECT_EQ(table.word(0), "c");
+    EXPECT_EQ(table.word(1), "a");
+    EXPECT_EQ(table.occurrences(1).get(), std::vector<Sentence>({2, 3}));
+    EXPECT_EQ(table.sortedIds(), std::vector<WordId>({1, 2, 0}));
+}
@@ -12,4 +12,18 @@ TEST(WordValidations, Validations)
 	EXPECT_TRUE(validator.isValid("B2B"));
 	EXPECT_FALSE(validator.isValid("0623141258"));
 	EXPECT_FALSE(validator.isValid("06.23.14.12.58"));
-}
\ No newline at end of file
+}
+
+TEST(WordValidations, Utf8Validations)
+{
+	EXPECT_TRUE(WordValidator::isValid("\xce\xba\xce\xb1\xce\xbb\xce\xb7\xce\xbc\xce\xad\xcf\x81\xce\xb1", TextEncoding::Utf8));
+	EXPECT_TRUE(WordValidator::isValid("caf\xc3\xa9", TextEncoding::Utf8));
+	EXPECT_TRUE(WordValidator::isValid("cafe\xcc\x81", TextEncoding::Utf8));
+	EXPECT_TRUE(WordValidator::isValid("don\xe2\x80\x99t", TextEncoding::Utf8));
+	EXPECT_TRUE(WordValidator::isValid("a.k.a", TextEncoding::Utf8));
+	EXPECT_FALSE(WordValidator::isValid("0623141258", TextEncoding::Utf8));
+	EXPECT_FALSE(WordValidator::isValid("\xe4\xb8\xad\xe6\x96\x87", TextEncoding::Utf8));
+	EXPECT_FALSE(WordValidator::isValid("caf\xc3", TextEncoding::Utf8));
+
+	EXPECT_FALSE(WordValidator::isValid("caf\xc3\xa9"));
+}
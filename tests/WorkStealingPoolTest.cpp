@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include "WorkStealingPool.hpp"
+
+TEST(WorkStealingPoolTests, RunsEveryTaskOnce)
+{
+    WorkStealingPool pool(4);
+    EXPECT_EQ(pool.threadCount(), 4);
+
+    std::vector< std::atomic<int> > runs(1000);
+    pool.run(runs.size(), [&runs](size_t task){
+        ++runs[task];
+    });
+
+    for( const std::atomic<int> &count : runs ){
+        EXPECT_EQ(count, 1);
+    }
+}
+
+TEST(WorkStealingPoolTests, RunsRepeatedly)
+{
+    WorkStealingPool pool(3);
+    std::atomic<size_t> sum = 0;
+
+    for( size_t round = 0; round < 200; round++ ){
+        pool.run(round % 7, [&sum](size_t task){
+            sum += task + 1;
+        });
+    }
+
+    //Every round of n tasks adds n * (n + 1) / 2
+    size_t expected = 0;
+    for( size_t round = 0; round < 200; round++ ){
+        expected += (round % 7) * (round % 7 + 1) / 2;
+    }
+    EXPECT_EQ(sum, expected);
+}
+
+TEST(WorkStealingPoolTests, IdleThreadsStealFromBusyOnes)
+{
+    //The calling thread owns tasks 0 to 3 and is held in task 0 until task
+    //1 has run, which only a thief can do
+    WorkStealingPool pool(2);
+    std::mutex mutex;
+    std::set<std::thread::id> threads_of_slice;
+    std::atomic<bool> stolen = false;
+
+    pool.run(8, [&mutex, &threads_of_slice, &stolen](size_t task){
+        if( task == 0 ){
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+            while( !stolen && std::chrono::steady_clock::now() < deadline ){
+                std::this_thread::yield();
+            }
+        } else if( task < 4 ){
+            std::lock_guard lock(mutex);
+            threads_of_slice.insert(std::this_thread::get_id());
+            stolen = stolen || task == 1;
+        }
+    });
+
+    EXPECT_TRUE(stolen);
+    EXPECT_EQ(threads_of_slice.size(), 1);
+    EXPECT_EQ(threads_of_slice.count(std::this_thread::get_id()), 0);
+}
+
+TEST(WorkStealingPoolTests, SingleThreadRunsInOrder)
+{
+    WorkStealingPool pool(1);
+    std::vector<size_t> order;
+
+    pool.run(5, [&order](size_t task){
+        order.push_back(task);
+    });
+
+    EXPECT_EQ(order, (std::vector<size_t>{0, 1, 2, 3, 4}));
+}